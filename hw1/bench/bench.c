@@ -0,0 +1,923 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         bench.c
+ *
+ * Description:  A benchmark harness for the circular buffers in ../circ_buff
+ *               and the doubly linked lists in ../doubly_ll. It measures
+ *               single element and batch ring throughput, the latency of a
+ *               handoff through the SPSC and MPMC rings for a range of thread
+ *               counts, and list insert/remove at the head, middle and tail,
+ *               dll_search hits and misses and dll_size for list sizes from
+ *               10 up to 10M.
+ *
+ *               One line (CSV) or object (JSON) is printed on stdout per
+ *               measurement, with the columns
+ *
+ *                    benchmark,size,threads,ops,ns_per_op,p50_ns,p99_ns,p999_ns,max_ns
+ *
+ *               The percentile columns are only filled in for the handoff
+ *               benchmarks and are empty (CSV) or null (JSON) otherwise.
+ *
+ * Usage:        bench [-f csv|json] [-s min_size] [-S max_size] [-n ops]
+ *                     [-m messages] [-t max_threads] [-b batch]
+ *
+ *               Sizes go up by a factor of 10 from min_size to max_size. ops
+ *               is the rough number of operations timed per measurement;
+ *               operations that walk the list are repeated ops/size times
+ *               (at least BENCH_MIN_WALKS). messages is the number of
+ *               handoffs timed per latency measurement.
+ *
+ * */
+
+
+/*clock_gettime, getopt and sysconf are POSIX*/
+#define _GNU_SOURCE
+
+#include<stdint.h>
+#include<stdlib.h>
+#include<stdio.h>
+#include<string.h>
+#include<inttypes.h>
+#include<unistd.h>
+#include<time.h>
+#include<sched.h>
+#include<pthread.h>
+#include<stdatomic.h>
+#include "circ_buff.h"
+#include "circ_buff_spsc.h"
+#include "circ_buff_mpmc.h"
+#include "doubly_ll.h"
+#include "dll_pool.h"
+#include "dll_unrolled.h"
+#include "dll_indexed.h"
+#include "dll_simd.h"
+
+/*defaults of the command line options*/
+#define BENCH_MIN_SIZE     10u
+#define BENCH_MAX_SIZE     10000000u
+#define BENCH_OPS          10000000u
+#define BENCH_MESSAGES     100000u
+#define BENCH_BATCH        64u
+
+/*walking operations are timed at least this many times per size*/
+#define BENCH_MIN_WALKS    10u
+
+/*slots of the rings used by the handoff benchmarks*/
+#define BENCH_HANDOFF_SLOTS 1024
+
+/*inserts done in a row before they are removed again, so a list stays
+ * within 10% of its size*/
+#define BENCH_LIST_ROUND   1024u
+
+
+/*
+ * Structure:    bench_result
+ * -----------------------------------------------------------------------------
+ * Description:  One measurement. The latency members are only valid if
+ *               has_latency is set.
+ * ----------------------------------------------------------------------------
+ */
+typedef struct bench_result
+{
+    const char *name;
+    uint32_t size;
+    uint32_t threads;
+    uint64_t ops;
+    double ns_per_op;
+    int has_latency;
+    uint32_t p50_ns;
+    uint32_t p99_ns;
+    uint32_t p999_ns;
+    uint32_t max_ns;
+}bench_result;
+
+
+/*
+ * Structure:    bench_options
+ * -----------------------------------------------------------------------------
+ * Description:  The command line options.
+ * ----------------------------------------------------------------------------
+ */
+typedef struct bench_options
+{
+    int json;
+    uint32_t min_size;
+    uint32_t max_size;
+    uint64_t ops;
+    uint32_t messages;
+    uint32_t max_threads;
+    uint32_t batch;
+}bench_options;
+
+
+/*
+ * Structure:    bench_handoff
+ * -----------------------------------------------------------------------------
+ * Description:  State shared by the producers and consumers of one handoff
+ *               benchmark. Every message is the low 32 bits of the time it
+ *               was written at. At most 'window' messages are in flight, so
+ *               the latency measured is that of a handoff and not the time a
+ *               message waits behind a full ring. A consumer claims a message
+ *               by taking a number from 'remaining' and stores its latency in
+ *               samples[number-1].
+ * ----------------------------------------------------------------------------
+ */
+typedef struct bench_handoff
+{
+    circ_buff_spsc_ptr spsc;
+    circ_buff_mpmc_ptr mpmc;
+    int wait;
+    uint32_t per_producer;
+    uint32_t window;
+    _Atomic uint32_t in_flight;
+    _Atomic int64_t remaining;
+    uint32_t *samples;
+}bench_handoff;
+
+
+/*results are summed up here so the compiler can not drop the timed calls*/
+static volatile uint32_t bench_sink;
+
+/*set once the first JSON object is printed*/
+static int bench_json_started;
+
+
+/*
+ * Function:     bench_now_ns(void)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the monotonic clock in nanoseconds.
+ * ----------------------------------------------------------------------------
+ */
+static uint64_t bench_now_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec*1000000000u+(uint64_t)now.tv_nsec;
+}
+
+/*
+ * Function:     bench_emit(const bench_options* options, const bench_result* result)
+ * -----------------------------------------------------------------------------
+ * Description:  Prints one result as a CSV line or a JSON object.
+ * ----------------------------------------------------------------------------
+ */
+static void bench_emit(const bench_options* options, const bench_result* result)
+{
+    if(options->json)
+    {
+         printf("%s  {\"benchmark\": \"%s\", \"size\": %" PRIu32 ", \"threads\": %" PRIu32
+                ", \"ops\": %" PRIu64 ", \"ns_per_op\": %.3f",
+                bench_json_started? ",\n": "", result->name, result->size, result->threads,
+                result->ops, result->ns_per_op);
+
+         if(result->has_latency)
+              printf(", \"p50_ns\": %" PRIu32 ", \"p99_ns\": %" PRIu32 ", \"p999_ns\": %" PRIu32
+                     ", \"max_ns\": %" PRIu32 "}", result->p50_ns, result->p99_ns,
+                     result->p999_ns, result->max_ns);
+         else
+              printf(", \"p50_ns\": null, \"p99_ns\": null, \"p999_ns\": null, \"max_ns\": null}");
+
+         bench_json_started=1;
+    }
+    else
+    {
+         printf("%s,%" PRIu32 ",%" PRIu32 ",%" PRIu64 ",%.3f", result->name, result->size,
+                result->threads, result->ops, result->ns_per_op);
+
+         if(result->has_latency)
+              printf(",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 "\n", result->p50_ns,
+                     result->p99_ns, result->p999_ns, result->max_ns);
+         else
+              printf(",,,,\n");
+    }
+
+    fflush(stdout);
+}
+
+/*
+ * Function:     bench_emit_rate(const bench_options* options, const char* name,
+ *                               uint32_t size, uint64_t ops, uint64_t elapsed_ns)
+ * -----------------------------------------------------------------------------
+ * Description:  Prints a throughput result of a single thread.
+ * ----------------------------------------------------------------------------
+ */
+static void bench_emit_rate(const bench_options* options, const char* name,
+                            uint32_t size, uint64_t ops, uint64_t elapsed_ns)
+{
+    bench_result result;
+
+    memset(&result, 0, sizeof(result));
+    result.name=name;
+    result.size=size;
+    result.threads=1;
+    result.ops=ops;
+    result.ns_per_op=(ops!=0)? (double)elapsed_ns/(double)ops: 0.0;
+
+    bench_emit(options, &result);
+}
+
+/*
+ * Function:     bench_walks(const bench_options* options, uint32_t size)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns how often an operation that walks a list of 'size'
+ *               nodes is timed.
+ * ----------------------------------------------------------------------------
+ */
+static uint64_t bench_walks(const bench_options* options, uint32_t size)
+{
+    uint64_t walks=options->ops/size;
+
+    return (walks<BENCH_MIN_WALKS)? BENCH_MIN_WALKS: walks;
+}
+
+
+/*
+ * Function:     bench_ring_single(const bench_options* options, const char* name,
+ *                                 uint32_t size, uint32_t mode)
+ * -----------------------------------------------------------------------------
+ * Description:  Fills a ring of 'size' elements with circ_buff_write and
+ *               drains it with circ_buff_read until about options->ops
+ *               elements went through; every write and read counts as one
+ *               operation. The size printed is the capacity of the ring after
+ *               the mode rounded it up.
+ * ----------------------------------------------------------------------------
+ */
+static void bench_ring_single(const bench_options* options, const char* name,
+                              uint32_t size, uint32_t mode)
+{
+    circ_buff_ptr ring;
+    uint64_t rounds, round, start, ops=0;
+    uint32_t i, data, sum=0;
+
+    if(circ_buff_init_mode(&ring, size, mode)!=CIRC_BUFF_SUCCESS)
+    {
+         fprintf(stderr, "bench: %s: can not create a ring of %" PRIu32 "\n", name, size);
+         return;
+    }
+
+    /*POW2 and VMIRROR round the size up*/
+    size=ring->total_size;
+    rounds=options->ops/(2*(uint64_t)size);
+    if(rounds==0)
+         rounds=1;
+
+    start=bench_now_ns();
+    for(round=0; round<rounds; round++)
+    {
+         for(i=0; i<size; i++)
+              circ_buff_write(ring, i);
+
+         for(i=0; i<size; i++)
+         {
+              circ_buff_read(ring, &data);
+              sum+=data;
+         }
+
+         ops+=2*(uint64_t)size;
+    }
+
+    bench_emit_rate(options, name, size, ops, bench_now_ns()-start);
+    bench_sink+=sum;
+
+    circ_buff_destroy(ring);
+}
+
+/*
+ * Function:     bench_ring_batch(const bench_options* options, const char* name,
+ *                                uint32_t size, uint32_t mode)
+ * -----------------------------------------------------------------------------
+ * Description:  Same as bench_ring_single, but moves options->batch elements
+ *               per circ_buff_write_n and circ_buff_read_n call. Operations
+ *               are still counted per element.
+ * ----------------------------------------------------------------------------
+ */
+static void bench_ring_batch(const bench_options* options, const char* name,
+                             uint32_t size, uint32_t mode)
+{
+    circ_buff_ptr ring;
+    uint32_t *batch;
+    uint64_t rounds, round, start, ops=0;
+    uint32_t i, done, moved;
+
+    if(circ_buff_init_mode(&ring, size, mode)!=CIRC_BUFF_SUCCESS)
+    {
+         fprintf(stderr, "bench: %s: can not create a ring of %" PRIu32 "\n", name, size);
+         return;
+    }
+
+    batch=malloc(options->batch*sizeof(uint32_t));
+    if(batch==NULL)
+    {
+         circ_buff_destroy(ring);
+         return;
+    }
+
+    for(i=0; i<options->batch; i++)
+         batch[i]=i;
+
+    size=ring->total_size;
+    rounds=options->ops/(2*(uint64_t)size);
+    if(rounds==0)
+         rounds=1;
+
+    start=bench_now_ns();
+    for(round=0; round<rounds; round++)
+    {
+         for(done=0; done<size; done+=moved)
+         {
+              circ_buff_write_n(ring, batch, options->batch, &moved);
+              if(moved==0)
+                   break;
+         }
+         ops+=done;
+
+         for(done=0; done<size; done+=moved)
+         {
+              circ_buff_read_n(ring, batch, options->batch, &moved);
+              if(moved==0)
+                   break;
+         }
+         ops+=done;
+    }
+
+    bench_emit_rate(options, name, size, ops, bench_now_ns()-start);
+    bench_sink+=batch[0];
+
+    free(batch);
+    circ_buff_destroy(ring);
+}
+
+
+/*
+ * Function:     bench_handoff_producer(void* arg)
+ * -----------------------------------------------------------------------------
+ * Description:  Writes per_producer time stamps to the ring, waiting for a
+ *               free place in the window before each one.
+ * ----------------------------------------------------------------------------
+ */
+static void* bench_handoff_producer(void* arg)
+{
+    bench_handoff *handoff=arg;
+    uint32_t i, in_flight;
+
+    for(i=0; i<handoff->per_producer; i++)
+    {
+         for(;;)
+         {
+              in_flight=atomic_load_explicit(&handoff->in_flight, memory_order_relaxed);
+              if(in_flight<handoff->window&&
+                 atomic_compare_exchange_weak(&handoff->in_flight, &in_flight, in_flight+1))
+                   break;
+              sched_yield();
+         }
+
+         if(handoff->mpmc!=NULL)
+         {
+              while(circ_buff_mpmc_write(handoff->mpmc, (uint32_t)bench_now_ns())!=CIRC_BUFF_SUCCESS)
+                   sched_yield();
+         }
+         else if(handoff->wait)
+              circ_buff_spsc_write_wait(handoff->spsc, (uint32_t)bench_now_ns(), -1);
+         else
+         {
+              while(circ_buff_spsc_write(handoff->spsc, (uint32_t)bench_now_ns())!=CIRC_BUFF_SUCCESS)
+                   sched_yield();
+         }
+    }
+
+    return NULL;
+}
+
+/*
+ * Function:     bench_handoff_consumer(void* arg)
+ * -----------------------------------------------------------------------------
+ * Description:  Claims and reads messages until all of them are claimed and
+ *               stores the latency of each one.
+ * ----------------------------------------------------------------------------
+ */
+static void* bench_handoff_consumer(void* arg)
+{
+    bench_handoff *handoff=arg;
+    uint32_t stamp, latency;
+    int64_t claim;
+
+    for(;;)
+    {
+         claim=atomic_fetch_sub(&handoff->remaining, 1);
+         if(claim<=0)
+              break;
+
+         if(handoff->mpmc!=NULL)
+         {
+              while(circ_buff_mpmc_read(handoff->mpmc, &stamp)!=CIRC_BUFF_SUCCESS)
+                   sched_yield();
+         }
+         else if(handoff->wait)
+              circ_buff_spsc_read_wait(handoff->spsc, &stamp, -1);
+         else
+         {
+              while(circ_buff_spsc_read(handoff->spsc, &stamp)!=CIRC_BUFF_SUCCESS)
+                   sched_yield();
+         }
+
+         /*the stamps wrap every 4.3 s; the unsigned difference does not care*/
+         latency=(uint32_t)bench_now_ns()-stamp;
+         atomic_fetch_sub(&handoff->in_flight, 1);
+         handoff->samples[claim-1]=latency;
+    }
+
+    return NULL;
+}
+
+/*
+ * Function:     bench_compare_u32(const void* a, const void* b)
+ * -----------------------------------------------------------------------------
+ * Description:  qsort comparison of two uint32_t.
+ * ----------------------------------------------------------------------------
+ */
+static int bench_compare_u32(const void* a, const void* b)
+{
+    uint32_t x=*(const uint32_t*)a, y=*(const uint32_t*)b;
+
+    return (x>y)-(x<y);
+}
+
+/*
+ * Function:     bench_handoff_run(const bench_options* options, const char* name,
+ *                                 bench_handoff* handoff, uint32_t threads)
+ * -----------------------------------------------------------------------------
+ * Description:  Runs 'threads' producers and as many consumers over the ring
+ *               set in handoff and prints the latency percentiles. ns_per_op
+ *               is the wall time per message.
+ * ----------------------------------------------------------------------------
+ */
+static void bench_handoff_run(const bench_options* options, const char* name,
+                              bench_handoff* handoff, uint32_t threads)
+{
+    pthread_t *tids;
+    bench_result result;
+    uint64_t total, start, elapsed;
+    uint32_t i, started;
+
+    handoff->per_producer=options->messages/threads;
+    if(handoff->per_producer==0)
+         handoff->per_producer=1;
+    total=(uint64_t)handoff->per_producer*threads;
+
+    handoff->window=threads;
+    atomic_init(&handoff->in_flight, 0);
+    atomic_init(&handoff->remaining, (int64_t)total);
+
+    handoff->samples=malloc(total*sizeof(uint32_t));
+    tids=malloc(2*threads*sizeof(pthread_t));
+    if(handoff->samples==NULL||tids==NULL)
+    {
+         free(handoff->samples);
+         free(tids);
+         return;
+    }
+
+    start=bench_now_ns();
+    for(started=0; started<2*threads; started++)
+         if(pthread_create(&tids[started], NULL, (started<threads)? bench_handoff_consumer:
+                           bench_handoff_producer, handoff)!=0)
+              break;
+
+    if(started<2*threads)
+    {
+         /*a missing thread would leave the others waiting forever*/
+         fprintf(stderr, "bench: %s: can not create %" PRIu32 " threads\n", name, 2*threads);
+         exit(EXIT_FAILURE);
+    }
+
+    for(i=0; i<2*threads; i++)
+         pthread_join(tids[i], NULL);
+    elapsed=bench_now_ns()-start;
+
+    qsort(handoff->samples, total, sizeof(uint32_t), bench_compare_u32);
+
+    memset(&result, 0, sizeof(result));
+    result.name=name;
+    result.size=BENCH_HANDOFF_SLOTS;
+    result.threads=threads;
+    result.ops=total;
+    result.ns_per_op=(double)elapsed/(double)total;
+    result.has_latency=1;
+    result.p50_ns=handoff->samples[(total-1)*50/100];
+    result.p99_ns=handoff->samples[(total-1)*99/100];
+    result.p999_ns=handoff->samples[(total-1)*999/1000];
+    result.max_ns=handoff->samples[total-1];
+    bench_emit(options, &result);
+
+    free(handoff->samples);
+    free(tids);
+}
+
+/*
+ * Function:     bench_handoff_all(const bench_options* options)
+ * -----------------------------------------------------------------------------
+ * Description:  Measures the SPSC ring with spinning and with futex waits,
+ *               and the MPMC ring with 1, 2, 4, ... producer/consumer pairs up
+ *               to options->max_threads.
+ * ----------------------------------------------------------------------------
+ */
+static void bench_handoff_all(const bench_options* options)
+{
+    bench_handoff handoff;
+    uint32_t threads;
+
+    memset(&handoff, 0, sizeof(handoff));
+    if(circ_buff_spsc_init(&handoff.spsc, BENCH_HANDOFF_SLOTS)==CIRC_BUFF_SUCCESS)
+    {
+         handoff.wait=0;
+         bench_handoff_run(options, "spsc_handoff", &handoff, 1);
+         handoff.wait=1;
+         bench_handoff_run(options, "spsc_handoff_wait", &handoff, 1);
+         circ_buff_spsc_destroy(handoff.spsc);
+    }
+
+    memset(&handoff, 0, sizeof(handoff));
+    if(circ_buff_mpmc_init(&handoff.mpmc, BENCH_HANDOFF_SLOTS)!=CIRC_BUFF_SUCCESS)
+         return;
+
+    for(threads=1; threads<=options->max_threads; threads*=2)
+         bench_handoff_run(options, "mpmc_handoff", &handoff, threads);
+
+    circ_buff_mpmc_destroy(handoff.mpmc);
+}
+
+
+/*
+ * Function:     bench_list_position(uint32_t count, char where)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the position at the head ('h'), in the middle ('m')
+ *               or past the tail ('t') of a list of count nodes.
+ * ----------------------------------------------------------------------------
+ */
+static uint32_t bench_list_position(uint32_t count, char where)
+{
+    if(where=='h')
+         return 0;
+
+    return (where=='m')? count/2: count;
+}
+
+/*
+ * Function:     bench_list_edit(const bench_options* options, dll_list_ptr list,
+ *                               uint32_t size, char where, const char* insert_name,
+ *                               const char* remove_name)
+ * -----------------------------------------------------------------------------
+ * Description:  Times dll_list_add_node and dll_list_remove_node at one end or
+ *               the middle of the list. Nodes are added in rounds of at most
+ *               a tenth of the list and then removed again, so the list stays
+ *               about 'size' long and ends as it started.
+ * ----------------------------------------------------------------------------
+ */
+static void bench_list_edit(const bench_options* options, dll_list_ptr list, uint32_t size,
+                            char where, const char* insert_name, const char* remove_name)
+{
+    uint64_t ops, done, insert_ns=0, remove_ns=0, start;
+    uint32_t round, i, count, data;
+
+    ops=(where=='m')? bench_walks(options, size): options->ops/2;
+
+    round=size/10;
+    if(round==0)
+         round=1;
+    if(round>BENCH_LIST_ROUND)
+         round=BENCH_LIST_ROUND;
+
+    for(done=0; done<ops; done+=round)
+    {
+         if(round>ops-done)
+              round=ops-done;
+
+         start=bench_now_ns();
+         for(i=0; i<round; i++)
+         {
+              dll_list_size(list, &count);
+              dll_list_add_node(list, bench_list_position(count, where), i);
+         }
+         insert_ns+=bench_now_ns()-start;
+
+         start=bench_now_ns();
+         for(i=0; i<round; i++)
+         {
+              dll_list_size(list, &count);
+              dll_list_remove_node(list, (where=='t')? count-1: bench_list_position(count, where),
+                                   &data);
+         }
+         remove_ns+=bench_now_ns()-start;
+    }
+
+    bench_emit_rate(options, insert_name, size, ops, insert_ns);
+    bench_emit_rate(options, remove_name, size, ops, remove_ns);
+}
+
+/*
+ * Function:     bench_list(const bench_options* options, uint32_t size, const uint32_t* values)
+ * -----------------------------------------------------------------------------
+ * Description:  Builds a pooled dll_list holding values[0..size-1] and runs
+ *               the list benchmarks on it. values[i] is i, so size is a value
+ *               no node holds.
+ * ----------------------------------------------------------------------------
+ */
+static void bench_list(const bench_options* options, uint32_t size, const uint32_t* values)
+{
+    dll_pool_ptr pool;
+    dll_list_ptr list;
+    uint64_t walks, i, start;
+    uint32_t result, sum=0;
+
+    if(dll_pool_init(&pool, 0)!=DLL_SUCCESS)
+         return;
+    if(dll_list_init_pool(&list, pool)!=DLL_SUCCESS)
+    {
+         dll_pool_destroy(pool);
+         return;
+    }
+
+    start=bench_now_ns();
+    if(dll_list_from_array(list, values, size)!=DLL_SUCCESS)
+    {
+         fprintf(stderr, "bench: can not build a list of %" PRIu32 "\n", size);
+         dll_list_destroy(list);
+         dll_pool_destroy(pool);
+         return;
+    }
+    bench_emit_rate(options, "list_build", size, size, bench_now_ns()-start);
+
+    bench_list_edit(options, list, size, 'h', "list_insert_head", "list_remove_head");
+    bench_list_edit(options, list, size, 'm', "list_insert_middle", "list_remove_middle");
+    bench_list_edit(options, list, size, 't', "list_insert_tail", "list_remove_tail");
+
+    walks=bench_walks(options, size);
+
+    start=bench_now_ns();
+    for(i=0; i<walks; i++)
+    {
+         dll_search(list->head, size/2, &result);
+         sum+=result;
+    }
+    bench_emit_rate(options, "dll_search_hit", size, walks, bench_now_ns()-start);
+
+    start=bench_now_ns();
+    for(i=0; i<walks; i++)
+         sum+=dll_search(list->head, size, &result);
+    bench_emit_rate(options, "dll_search_miss", size, walks, bench_now_ns()-start);
+
+    start=bench_now_ns();
+    for(i=0; i<walks; i++)
+    {
+         dll_size(list->head, &result);
+         sum+=result;
+    }
+    bench_emit_rate(options, "dll_size", size, walks, bench_now_ns()-start);
+
+    start=bench_now_ns();
+    for(i=0; i<options->ops; i++)
+    {
+         dll_list_size(list, &result);
+         sum+=result;
+    }
+    bench_emit_rate(options, "dll_list_size", size, options->ops, bench_now_ns()-start);
+
+    if(dll_list_attach_index(list)==DLL_SUCCESS)
+    {
+         start=bench_now_ns();
+         for(i=0; i<options->ops; i++)
+              sum+=dll_list_search(list, size, &result);
+         bench_emit_rate(options, "dll_list_search_miss_indexed", size, options->ops,
+                         bench_now_ns()-start);
+    }
+
+    bench_sink+=sum;
+
+    start=bench_now_ns();
+    dll_list_destroy(list);
+    bench_emit_rate(options, "list_destroy", size, size, bench_now_ns()-start);
+
+    dll_pool_destroy(pool);
+}
+
+/*
+ * Function:     bench_unrolled(const bench_options* options, uint32_t size)
+ * -----------------------------------------------------------------------------
+ * Description:  Runs the search benchmarks on an unrolled list of 'size'
+ *               values for comparison with dll_search.
+ * ----------------------------------------------------------------------------
+ */
+static void bench_unrolled(const bench_options* options, uint32_t size)
+{
+    dll_unrolled_ptr list;
+    uint64_t walks, i, start;
+    uint32_t result, sum=0;
+
+    if(dll_unrolled_init(&list)!=DLL_SUCCESS)
+         return;
+
+    for(i=0; i<size; i++)
+         if(dll_unrolled_add_node(list, i, i)!=DLL_SUCCESS)
+         {
+              dll_unrolled_destroy(list);
+              return;
+         }
+
+    walks=bench_walks(options, size);
+
+    start=bench_now_ns();
+    for(i=0; i<walks; i++)
+    {
+         dll_unrolled_search(list, size/2, &result);
+         sum+=result;
+    }
+    bench_emit_rate(options, "unrolled_search_hit", size, walks, bench_now_ns()-start);
+
+    start=bench_now_ns();
+    for(i=0; i<walks; i++)
+         sum+=dll_unrolled_search(list, size, &result);
+    bench_emit_rate(options, "unrolled_search_miss", size, walks, bench_now_ns()-start);
+
+    bench_sink+=sum;
+    dll_unrolled_destroy(list);
+}
+
+/*
+ * Function:     bench_indexed(const bench_options* options, uint32_t size)
+ * -----------------------------------------------------------------------------
+ * Description:  Times insert/remove in the middle of an indexed list of
+ *               'size' values for comparison with list_insert_middle.
+ * ----------------------------------------------------------------------------
+ */
+static void bench_indexed(const bench_options* options, uint32_t size)
+{
+    dll_indexed_ptr list;
+    uint64_t ops, i, insert_ns, remove_ns, start;
+    uint32_t data;
+
+    if(dll_indexed_init(&list)!=DLL_SUCCESS)
+         return;
+
+    for(i=0; i<size; i++)
+         if(dll_indexed_add_node(list, i, i)!=DLL_SUCCESS)
+         {
+              dll_indexed_destroy(list);
+              return;
+         }
+
+    ops=options->ops/2;
+    if(ops>size)
+         ops=size;
+
+    start=bench_now_ns();
+    for(i=0; i<ops; i++)
+         dll_indexed_add_node(list, list->count/2, i);
+    insert_ns=bench_now_ns()-start;
+
+    start=bench_now_ns();
+    for(i=0; i<ops; i++)
+         dll_indexed_remove_node(list, list->count/2, &data);
+    remove_ns=bench_now_ns()-start;
+
+    bench_emit_rate(options, "indexed_insert_middle", size, ops, insert_ns);
+    bench_emit_rate(options, "indexed_remove_middle", size, ops, remove_ns);
+
+    dll_indexed_destroy(list);
+}
+
+
+/*
+ * Function:     bench_usage(const char* program)
+ * -----------------------------------------------------------------------------
+ * Description:  Prints the command line options to stderr.
+ * ----------------------------------------------------------------------------
+ */
+static void bench_usage(const char* program)
+{
+    fprintf(stderr, "usage: %s [-f csv|json] [-s min_size] [-S max_size] [-n ops]\n"
+                    "          [-m messages] [-t max_threads] [-b batch]\n", program);
+}
+
+/*
+ * Function:     bench_parse(int argc, char** argv, bench_options* options)
+ * -----------------------------------------------------------------------------
+ * Description:  Fills options from the command line. Returns 0 on success and
+ *               -1 on a bad option.
+ * ----------------------------------------------------------------------------
+ */
+static int bench_parse(int argc, char** argv, bench_options* options)
+{
+    long cpus=sysconf(_SC_NPROCESSORS_ONLN);
+    int option;
+
+    options->json=0;
+    options->min_size=BENCH_MIN_SIZE;
+    options->max_size=BENCH_MAX_SIZE;
+    options->ops=BENCH_OPS;
+    options->messages=BENCH_MESSAGES;
+    options->max_threads=(cpus>1)? (uint32_t)cpus: 1;
+    options->batch=BENCH_BATCH;
+
+    while((option=getopt(argc, argv, "f:s:S:n:m:t:b:h"))!=-1)
+    {
+         switch(option)
+         {
+              case 'f':
+                   if(strcmp(optarg, "json")==0)
+                        options->json=1;
+                   else if(strcmp(optarg, "csv")!=0)
+                        return -1;
+                   break;
+              case 's':
+                   options->min_size=strtoul(optarg, NULL, 0);
+                   break;
+              case 'S':
+                   options->max_size=strtoul(optarg, NULL, 0);
+                   break;
+              case 'n':
+                   options->ops=strtoull(optarg, NULL, 0);
+                   break;
+              case 'm':
+                   options->messages=strtoul(optarg, NULL, 0);
+                   break;
+              case 't':
+                   options->max_threads=strtoul(optarg, NULL, 0);
+                   break;
+              case 'b':
+                   options->batch=strtoul(optarg, NULL, 0);
+                   break;
+              default:
+                   return -1;
+         }
+    }
+
+    /*sizes must fit an int32_t ring and leave room for the miss value*/
+    if(options->min_size==0||options->max_size<options->min_size||
+       options->max_size>INT32_MAX/2||options->ops==0||options->messages==0||
+       options->max_threads==0||options->batch==0)
+         return -1;
+
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    bench_options options;
+    uint32_t *values;
+    uint32_t size, i;
+
+    if(bench_parse(argc, argv, &options)!=0)
+    {
+         bench_usage(argv[0]);
+         return EXIT_FAILURE;
+    }
+
+    values=malloc((size_t)options.max_size*sizeof(uint32_t));
+    if(values==NULL)
+    {
+         fprintf(stderr, "bench: can not allocate %" PRIu32 " values\n", options.max_size);
+         return EXIT_FAILURE;
+    }
+    for(i=0; i<options.max_size; i++)
+         values[i]=i;
+
+    fprintf(stderr, "bench: dll_simd level %d\n", (int)dll_simd_active());
+
+    if(options.json)
+         printf("[\n");
+    else
+         printf("benchmark,size,threads,ops,ns_per_op,p50_ns,p99_ns,p999_ns,max_ns\n");
+
+    for(size=options.min_size; size<=options.max_size; size*=10)
+    {
+         bench_ring_single(&options, "ring_single", size, CIRC_BUFF_MODE_DEFAULT);
+         bench_ring_single(&options, "ring_single_pow2", size, CIRC_BUFF_MODE_POW2);
+         bench_ring_batch(&options, "ring_batch", size, CIRC_BUFF_MODE_DEFAULT);
+         bench_ring_batch(&options, "ring_batch_vmirror", size, CIRC_BUFF_MODE_VMIRROR);
+
+         if(size>UINT32_MAX/10)
+              break;
+    }
+
+    bench_handoff_all(&options);
+
+    for(size=options.min_size; size<=options.max_size; size*=10)
+    {
+         bench_list(&options, size, values);
+         bench_unrolled(&options, size);
+         bench_indexed(&options, size);
+
+         if(size>UINT32_MAX/10)
+              break;
+    }
+
+    if(options.json)
+         printf("\n]\n");
+
+    free(values);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,97 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         test.c
+ *
+ * Description:  Runs the behaviour tests of the circular buffers in
+ *               ../circ_buff and the doubly linked lists in ../doubly_ll and
+ *               prints one line per test. Exits with 1 if any check failed.
+ *
+ * Usage:        tests [name...]
+ *
+ *               Without names every test is run; otherwise only the named
+ *               ones, e.g. "tests spsc list".
+ *
+ * */
+
+
+#include<stdio.h>
+#include<string.h>
+#include "test.h"
+
+unsigned test_failures;
+
+typedef struct test_case
+{
+    const char *name;
+    void (*run)(void);
+}test_case;
+
+static const test_case tests[]=
+{
+    {"ring",      test_ring},
+    {"overwrite", test_overwrite},
+    {"spsc",      test_spsc},
+    {"mpmc",      test_mpmc},
+    {"typed",     test_typed},
+    {"stats",     test_stats},
+    {"shm",       test_shm},
+    {"file",      test_file},
+    {"rec",       test_rec},
+    {"list",      test_list},
+    {"bulk",      test_bulk},
+    {"pool",      test_pool},
+    {"unrolled",  test_unrolled},
+    {"indexed",   test_indexed},
+    {"hash",      test_hash},
+    {"lru",       test_lru},
+    {"simd",      test_simd},
+    {"intrusive", test_intrusive},
+    {"conc",      test_conc},
+};
+
+/*
+ * Function:     test_selected(const char* name, int argc, char** argv)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns 1 if the test 'name' was asked for on the command
+ *               line, or if no test was named.
+ * ----------------------------------------------------------------------------
+ */
+static int test_selected(const char* name, int argc, char** argv)
+{
+    int arg;
+
+    if(argc<2)
+         return 1;
+
+    for(arg=1; arg<argc; arg++)
+         if(strcmp(argv[arg], name)==0)
+              return 1;
+
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    size_t index;
+    unsigned failed_tests=0;
+
+    for(index=0; index<sizeof(tests)/sizeof(tests[0]); index++)
+    {
+         unsigned before=test_failures;
+
+         if(!test_selected(tests[index].name, argc, argv))
+              continue;
+
+         tests[index].run();
+
+         if(test_failures!=before)
+              failed_tests++;
+         printf("%-10s %s\n", tests[index].name, (test_failures!=before)? "FAILED": "ok");
+    }
+
+    if(test_failures!=0)
+         printf("%u checks failed in %u tests\n", test_failures, failed_tests);
+
+    return test_failures!=0;
+}
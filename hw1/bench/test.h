@@ -0,0 +1,59 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         test.h
+ *
+ * Description:  The check macro and the test functions of the behaviour tests
+ *               in test_circ_buff.c and test_doubly_ll.c, run by test.c.
+ *               A test calls CHECK for every property it expects; a failed
+ *               check is reported with its file and line and the test goes
+ *               on, so one run shows every failure.
+ *
+ * */
+
+#ifndef _TEST_H
+#define _TEST_H
+
+#include<stdio.h>
+
+/*number of failed checks so far; defined in test.c*/
+extern unsigned test_failures;
+
+/*
+ * Macro:        CHECK(cond)
+ * -----------------------------------------------------------------------------
+ * Description:  Counts and reports a failure if cond is false.
+ * ----------------------------------------------------------------------------
+ */
+#define CHECK(cond)                                                            \
+    do{ if(!(cond))                                                            \
+        {                                                                      \
+             test_failures++;                                                  \
+             fprintf(stderr, "%s:%d: check failed: %s\n",                      \
+                     __FILE__, __LINE__, #cond);                               \
+        } }while(0)
+
+/*circular buffers; in test_circ_buff.c*/
+void test_ring(void);
+void test_overwrite(void);
+void test_spsc(void);
+void test_mpmc(void);
+void test_typed(void);
+void test_stats(void);
+void test_shm(void);
+void test_file(void);
+void test_rec(void);
+
+/*doubly linked lists; in test_doubly_ll.c*/
+void test_list(void);
+void test_bulk(void);
+void test_pool(void);
+void test_unrolled(void);
+void test_indexed(void);
+void test_hash(void);
+void test_lru(void);
+void test_simd(void);
+void test_intrusive(void);
+void test_conc(void);
+
+#endif
@@ -0,0 +1,725 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         test_circ_buff.c
+ *
+ * Description:  Behaviour tests of the circular buffers in ../circ_buff: the
+ *               full and empty boundaries, wraparound of single and batch
+ *               operations, the error codes of bad arguments, and for the
+ *               concurrent rings that every element arrives exactly once and
+ *               in order.
+ *
+ * */
+
+
+/*shm_open, ftruncate, fork and getpid are POSIX*/
+#define _GNU_SOURCE
+
+#include<stdint.h>
+#include<stdlib.h>
+#include<stdio.h>
+#include<string.h>
+#include<sched.h>
+#include<pthread.h>
+#include<stdatomic.h>
+#include<fcntl.h>
+#include<unistd.h>
+#include<sys/mman.h>
+#include<sys/wait.h>
+#include "circ_buff.h"
+#include "circ_buff_stats.h"
+#include "circ_buff_spsc.h"
+#include "circ_buff_mpmc.h"
+#include "circ_buff_typed.h"
+#include "circ_buff_shm.h"
+#include "circ_buff_file.h"
+#include "circ_buff_rec.h"
+#include "test.h"
+
+/*elements handed through the threaded spsc and mpmc tests, per producer*/
+#define TEST_HANDOFFS 200000u
+
+/*producers and consumers of the mpmc test*/
+#define TEST_MPMC_THREADS 2u
+
+
+/*
+ * Function:     test_ring_mode(int32_t size, uint32_t mode)
+ * -----------------------------------------------------------------------------
+ * Description:  Runs the boundary, wraparound and batch checks on a buffer of
+ *               'size' elements in the given mode.
+ * ----------------------------------------------------------------------------
+ */
+static void test_ring_mode(int32_t size, uint32_t mode)
+{
+    circ_buff_ptr cb;
+    uint32_t total, value, index, count, *region;
+    uint32_t in[16], out[16];
+
+    CHECK(circ_buff_init_mode(&cb, size, mode)==CIRC_BUFF_SUCCESS);
+    total=cb->total_size;
+    CHECK(total>=(uint32_t)size);
+
+    /*empty boundary*/
+    CHECK(if_circ_buff_empty(cb)==CIRC_BUFF_EMPTY);
+    CHECK(circ_buff_read(cb, &value)==CIRC_BUFF_EMPTY);
+    CHECK(circ_buff_peek(cb, &region, &count)==CIRC_BUFF_EMPTY);
+    CHECK(circ_buff_read_n(cb, out, 4, &count)==CIRC_BUFF_EMPTY&&count==0);
+
+    /*full boundary*/
+    for(index=0; index<total; index++)
+         CHECK(circ_buff_write(cb, index)==CIRC_BUFF_SUCCESS);
+    CHECK(if_circ_buff_full(cb)==CIRC_BUFF_FULL);
+    CHECK(circ_buff_write(cb, total)==CIRC_BUFF_FULL);
+    CHECK(circ_buff_reserve(cb, &region, &count)==CIRC_BUFF_FULL);
+    CHECK(circ_buff_write_n(cb, in, 4, &count)==CIRC_BUFF_FULL&&count==0);
+    CHECK(circ_buff_write_n(cb, in, 0, &count)==CIRC_BUFF_SUCCESS&&count==0);
+
+    for(index=0; index<total; index++)
+         CHECK(circ_buff_read(cb, &value)==CIRC_BUFF_SUCCESS&&value==index);
+    CHECK(if_circ_buff_empty(cb)==CIRC_BUFF_EMPTY);
+
+    /*single elements across the end of base, at every offset*/
+    for(index=0; index<3*total; index++)
+    {
+         CHECK(circ_buff_write(cb, index)==CIRC_BUFF_SUCCESS);
+         CHECK(circ_buff_read(cb, &value)==CIRC_BUFF_SUCCESS&&value==index);
+    }
+
+    /*batches split at the end of base, and a partial write when it fills*/
+    for(index=0; index<16; index++)
+         in[index]=100+index;
+    for(index=0; total>=3&&index<2*total; index+=3)
+    {
+         CHECK(circ_buff_write_n(cb, in, 3, &count)==CIRC_BUFF_SUCCESS&&count==3);
+         CHECK(circ_buff_read_n(cb, out, 3, &count)==CIRC_BUFF_SUCCESS&&count==3);
+         CHECK(memcmp(in, out, 3*sizeof(uint32_t))==0);
+    }
+    if(total<=16)
+    {
+         CHECK(circ_buff_write_n(cb, in, 16, &count)==CIRC_BUFF_SUCCESS&&count==total);
+         CHECK(circ_buff_read_n(cb, out, 16, &count)==CIRC_BUFF_SUCCESS&&count==total);
+         CHECK(memcmp(in, out, total*sizeof(uint32_t))==0);
+    }
+
+    /*reserve/commit and peek/release reject counts beyond the region*/
+    CHECK(circ_buff_reserve(cb, &region, &count)==CIRC_BUFF_SUCCESS&&count>=1);
+    CHECK(circ_buff_commit(cb, total+1)==CIRC_BUFF_BAD_DATA);
+    region[0]=77;
+    CHECK(circ_buff_commit(cb, 1)==CIRC_BUFF_SUCCESS);
+    CHECK(circ_buff_release(cb, 2)==CIRC_BUFF_BAD_DATA);
+    CHECK(circ_buff_peek(cb, &region, &count)==CIRC_BUFF_SUCCESS&&count==1&&region[0]==77);
+    CHECK(circ_buff_release(cb, 1)==CIRC_BUFF_SUCCESS);
+    CHECK(if_circ_buff_empty(cb)==CIRC_BUFF_EMPTY);
+
+    /*bad arguments*/
+    CHECK(circ_buff_read(cb, NULL)==CIRC_BUFF_NULL_PTR);
+    CHECK(circ_buff_write_n(cb, NULL, 1, &count)==CIRC_BUFF_NULL_PTR);
+    CHECK(circ_buff_read_n(cb, out, 1, NULL)==CIRC_BUFF_NULL_PTR);
+
+    CHECK(circ_buff_destroy(cb)==CIRC_BUFF_SUCCESS);
+}
+
+void test_ring(void)
+{
+    circ_buff_ptr cb;
+
+    test_ring_mode(5, CIRC_BUFF_MODE_DEFAULT);
+    test_ring_mode(1, CIRC_BUFF_MODE_DEFAULT);
+    test_ring_mode(5, CIRC_BUFF_MODE_POW2);
+    test_ring_mode(5, CIRC_BUFF_MODE_VMIRROR);
+    test_ring_mode(5, CIRC_BUFF_MODE_POW2|CIRC_BUFF_MODE_VMIRROR);
+
+    CHECK(circ_buff_init(NULL, 4)==CIRC_BUFF_NULL_PTR);
+    CHECK(circ_buff_init(&cb, 0)==CIRC_BUFF_BAD_DATA);
+    CHECK(circ_buff_init(&cb, -1)==CIRC_BUFF_BAD_DATA);
+    CHECK(circ_buff_init_mode(&cb, 4, 0x80u)==CIRC_BUFF_BAD_DATA);
+    CHECK(circ_buff_write(NULL, 1)==CIRC_BUFF_NULL_PTR);
+    CHECK(circ_buff_destroy(NULL)==CIRC_BUFF_NULL_PTR);
+}
+
+void test_overwrite(void)
+{
+    static const uint32_t modes[]={CIRC_BUFF_MODE_OVERWRITE, CIRC_BUFF_MODE_OVERWRITE|CIRC_BUFF_MODE_POW2};
+    uint32_t mode, index, value, count, in[10], out[10];
+    uint64_t dropped;
+    circ_buff_ptr cb;
+
+    for(mode=0; mode<sizeof(modes)/sizeof(modes[0]); mode++)
+    {
+         CHECK(circ_buff_init_mode(&cb, 4, modes[mode])==CIRC_BUFF_SUCCESS);
+
+         /*a full buffer keeps the newest elements*/
+         for(index=0; index<10; index++)
+              CHECK(circ_buff_write(cb, index)==CIRC_BUFF_SUCCESS);
+         CHECK(circ_buff_dropped(cb, &dropped)==CIRC_BUFF_SUCCESS&&dropped==6);
+         for(index=6; index<10; index++)
+              CHECK(circ_buff_read(cb, &value)==CIRC_BUFF_SUCCESS&&value==index);
+         CHECK(circ_buff_read(cb, &value)==CIRC_BUFF_EMPTY);
+
+         /*a batch larger than the buffer is accepted whole*/
+         for(index=0; index<10; index++)
+              in[index]=20+index;
+         CHECK(circ_buff_write(cb, 1)==CIRC_BUFF_SUCCESS);
+         CHECK(circ_buff_write_n(cb, in, 10, &count)==CIRC_BUFF_SUCCESS&&count==10);
+         CHECK(circ_buff_dropped(cb, &dropped)==CIRC_BUFF_SUCCESS&&dropped==13);
+         CHECK(circ_buff_read_n(cb, out, 10, &count)==CIRC_BUFF_SUCCESS&&count==4);
+         CHECK(memcmp(out, in+6, 4*sizeof(uint32_t))==0);
+
+         CHECK(circ_buff_dropped(cb, NULL)==CIRC_BUFF_NULL_PTR);
+         CHECK(circ_buff_destroy(cb)==CIRC_BUFF_SUCCESS);
+    }
+}
+
+
+/*
+ * Function:     test_spsc_producer(void* arg)
+ * -----------------------------------------------------------------------------
+ * Description:  Writes 0 to TEST_HANDOFFS-1 to the spsc ring at arg, sleeping
+ *               while it is full.
+ * ----------------------------------------------------------------------------
+ */
+static void* test_spsc_producer(void* arg)
+{
+    circ_buff_spsc_ptr cb=(circ_buff_spsc_ptr)arg;
+    uint32_t index;
+
+    for(index=0; index<TEST_HANDOFFS; index++)
+         if(circ_buff_spsc_write_wait(cb, index, -1)!=CIRC_BUFF_SUCCESS)
+              break;
+
+    return NULL;
+}
+
+void test_spsc(void)
+{
+    circ_buff_spsc_ptr cb;
+    uint32_t index, value, total;
+    pthread_t producer;
+
+    CHECK(circ_buff_spsc_init(NULL, 4)==CIRC_BUFF_NULL_PTR);
+    CHECK(circ_buff_spsc_init(&cb, 0)==CIRC_BUFF_BAD_DATA);
+    CHECK(circ_buff_spsc_init(&cb, 5)==CIRC_BUFF_SUCCESS);
+    total=cb->total_size;
+    CHECK(total==8);
+
+    /*boundaries and wraparound on one thread*/
+    CHECK(if_circ_buff_spsc_empty(cb)==CIRC_BUFF_EMPTY);
+    CHECK(circ_buff_spsc_read(cb, &value)==CIRC_BUFF_EMPTY);
+    CHECK(circ_buff_spsc_read_wait(cb, &value, 0)==CIRC_BUFF_EMPTY);
+    CHECK(circ_buff_spsc_read_wait(cb, &value, 5)==CIRC_BUFF_TIMEOUT);
+    for(index=0; index<total; index++)
+         CHECK(circ_buff_spsc_write(cb, index)==CIRC_BUFF_SUCCESS);
+    CHECK(if_circ_buff_spsc_full(cb)==CIRC_BUFF_FULL);
+    CHECK(circ_buff_spsc_write(cb, total)==CIRC_BUFF_FULL);
+    CHECK(circ_buff_spsc_write_wait(cb, total, 0)==CIRC_BUFF_FULL);
+    CHECK(circ_buff_spsc_write_wait(cb, total, 5)==CIRC_BUFF_TIMEOUT);
+    for(index=0; index<3*total; index++)
+    {
+         CHECK(circ_buff_spsc_read(cb, &value)==CIRC_BUFF_SUCCESS&&value==index);
+         CHECK(circ_buff_spsc_write(cb, index+total)==CIRC_BUFF_SUCCESS);
+    }
+    for(index=3*total; index<4*total; index++)
+         CHECK(circ_buff_spsc_read(cb, &value)==CIRC_BUFF_SUCCESS&&value==index);
+    CHECK(circ_buff_spsc_read(cb, NULL)==CIRC_BUFF_NULL_PTR);
+
+    /*a producer thread; the elements arrive once each and in order*/
+    CHECK(pthread_create(&producer, NULL, test_spsc_producer, cb)==0);
+    for(index=0; index<TEST_HANDOFFS; index++)
+    {
+         if(circ_buff_spsc_read_wait(cb, &value, 10000)!=CIRC_BUFF_SUCCESS||value!=index)
+         {
+              CHECK(value==index);
+              break;
+         }
+    }
+    pthread_join(producer, NULL);
+    CHECK(if_circ_buff_spsc_empty(cb)==CIRC_BUFF_EMPTY);
+
+    CHECK(circ_buff_spsc_destroy(cb)==CIRC_BUFF_SUCCESS);
+}
+
+
+typedef struct test_mpmc_args
+{
+    circ_buff_mpmc_ptr cb;
+    uint32_t id;
+    _Atomic uint32_t *taken;
+    _Atomic uint8_t *seen;
+}test_mpmc_args;
+
+/*
+ * Function:     test_mpmc_producer(void* arg)
+ * -----------------------------------------------------------------------------
+ * Description:  Writes id*TEST_HANDOFFS up to (id+1)*TEST_HANDOFFS-1, yielding
+ *               while the ring is full.
+ * ----------------------------------------------------------------------------
+ */
+static void* test_mpmc_producer(void* arg)
+{
+    test_mpmc_args *args=(test_mpmc_args*)arg;
+    uint32_t index;
+
+    for(index=0; index<TEST_HANDOFFS; index++)
+         while(circ_buff_mpmc_write(args->cb, args->id*TEST_HANDOFFS+index)==CIRC_BUFF_FULL)
+              sched_yield();
+
+    return NULL;
+}
+
+/*
+ * Function:     test_mpmc_consumer(void* arg)
+ * -----------------------------------------------------------------------------
+ * Description:  Reads until all the elements of all producers are taken and
+ *               counts each value it gets in seen[].
+ * ----------------------------------------------------------------------------
+ */
+static void* test_mpmc_consumer(void* arg)
+{
+    test_mpmc_args *args=(test_mpmc_args*)arg;
+    uint32_t value;
+
+    while(atomic_load(args->taken)<TEST_MPMC_THREADS*TEST_HANDOFFS)
+    {
+         if(circ_buff_mpmc_read(args->cb, &value)!=CIRC_BUFF_SUCCESS)
+         {
+              sched_yield();
+              continue;
+         }
+         if(value<TEST_MPMC_THREADS*TEST_HANDOFFS)
+              atomic_fetch_add(&args->seen[value], 1);
+         atomic_fetch_add(args->taken, 1);
+    }
+
+    return NULL;
+}
+
+void test_mpmc(void)
+{
+    circ_buff_mpmc_ptr cb;
+    uint32_t index, value, missing=0;
+    pthread_t threads[2*TEST_MPMC_THREADS];
+    test_mpmc_args args[2*TEST_MPMC_THREADS];
+    _Atomic uint32_t taken=0;
+    _Atomic uint8_t *seen;
+
+    CHECK(circ_buff_mpmc_init(NULL, 4)==CIRC_BUFF_NULL_PTR);
+    CHECK(circ_buff_mpmc_init(&cb, 0)==CIRC_BUFF_BAD_DATA);
+    CHECK(circ_buff_mpmc_init(&cb, 3)==CIRC_BUFF_SUCCESS);
+    CHECK(cb->total_size==4);
+
+    /*boundaries and wraparound on one thread*/
+    CHECK(circ_buff_mpmc_read(cb, &value)==CIRC_BUFF_EMPTY);
+    for(index=0; index<4; index++)
+         CHECK(circ_buff_mpmc_write(cb, index)==CIRC_BUFF_SUCCESS);
+    CHECK(circ_buff_mpmc_write(cb, 4)==CIRC_BUFF_FULL);
+    for(index=0; index<12; index++)
+    {
+         CHECK(circ_buff_mpmc_read(cb, &value)==CIRC_BUFF_SUCCESS&&value==index);
+         CHECK(circ_buff_mpmc_write(cb, index+4)==CIRC_BUFF_SUCCESS);
+    }
+    for(index=12; index<16; index++)
+         CHECK(circ_buff_mpmc_read(cb, &value)==CIRC_BUFF_SUCCESS&&value==index);
+    CHECK(circ_buff_mpmc_read(cb, &value)==CIRC_BUFF_EMPTY);
+    CHECK(circ_buff_mpmc_read(cb, NULL)==CIRC_BUFF_NULL_PTR);
+
+    /*producers and consumers at once; every element is taken exactly once*/
+    seen=(_Atomic uint8_t*)calloc(TEST_MPMC_THREADS*TEST_HANDOFFS, sizeof(*seen));
+    CHECK(seen!=NULL);
+    if(seen!=NULL)
+    {
+         for(index=0; index<2*TEST_MPMC_THREADS; index++)
+         {
+              args[index].cb=cb;
+              args[index].id=index%TEST_MPMC_THREADS;
+              args[index].taken=&taken;
+              args[index].seen=seen;
+              pthread_create(&threads[index], NULL, (index<TEST_MPMC_THREADS)? test_mpmc_producer:
+                             test_mpmc_consumer, &args[index]);
+         }
+         for(index=0; index<2*TEST_MPMC_THREADS; index++)
+              pthread_join(threads[index], NULL);
+
+         for(index=0; index<TEST_MPMC_THREADS*TEST_HANDOFFS; index++)
+              missing+=(atomic_load(&seen[index])!=1);
+         CHECK(missing==0);
+         CHECK(circ_buff_mpmc_read(cb, &value)==CIRC_BUFF_EMPTY);
+         free((void*)seen);
+    }
+
+    CHECK(circ_buff_mpmc_destroy(cb)==CIRC_BUFF_SUCCESS);
+}
+
+
+CIRC_BUFF_DEFINE_STATIC(test_static_ring, uint64_t, 4)
+CIRC_BUFF_DEFINE(test_heap_ring, uint16_t)
+
+void test_typed(void)
+{
+    test_static_ring ring;
+    test_heap_ring_ptr heap;
+    uint64_t wide;
+    uint16_t narrow;
+    uint32_t index;
+
+    /*static: 64 bit elements, capacity 4*/
+    CHECK(test_static_ring_init(&ring)==CIRC_BUFF_SUCCESS);
+    CHECK(if_test_static_ring_empty(&ring)==CIRC_BUFF_EMPTY);
+    CHECK(test_static_ring_read(&ring, &wide)==CIRC_BUFF_EMPTY);
+    for(index=0; index<4; index++)
+         CHECK(test_static_ring_write(&ring, (UINT64_C(1)<<40)+index)==CIRC_BUFF_SUCCESS);
+    CHECK(if_test_static_ring_full(&ring)==CIRC_BUFF_FULL);
+    CHECK(test_static_ring_write(&ring, 0)==CIRC_BUFF_FULL);
+    CHECK(test_static_ring_size(&ring)==4);
+    for(index=0; index<12; index++)
+    {
+         CHECK(test_static_ring_read(&ring, &wide)==CIRC_BUFF_SUCCESS&&wide==(UINT64_C(1)<<40)+index);
+         CHECK(test_static_ring_write(&ring, (UINT64_C(1)<<40)+index+4)==CIRC_BUFF_SUCCESS);
+    }
+    CHECK(test_static_ring_read(&ring, NULL)==CIRC_BUFF_NULL_PTR);
+    CHECK(test_static_ring_init(NULL)==CIRC_BUFF_NULL_PTR);
+
+    /*heap: 16 bit elements, size rounded up to 4*/
+    CHECK(test_heap_ring_init(&heap, 0)==CIRC_BUFF_BAD_DATA);
+    CHECK(test_heap_ring_init(&heap, 3)==CIRC_BUFF_SUCCESS);
+    CHECK(heap->total_size==4);
+    CHECK(if_test_heap_ring_empty(heap)==CIRC_BUFF_EMPTY);
+    for(index=0; index<4; index++)
+         CHECK(test_heap_ring_write(heap, (uint16_t)(0xfff0u+index))==CIRC_BUFF_SUCCESS);
+    CHECK(test_heap_ring_write(heap, 0)==CIRC_BUFF_FULL);
+    for(index=0; index<12; index++)
+    {
+         CHECK(test_heap_ring_read(heap, &narrow)==CIRC_BUFF_SUCCESS&&narrow==(uint16_t)(0xfff0u+index));
+         CHECK(test_heap_ring_write(heap, (uint16_t)(0xfff0u+index+4))==CIRC_BUFF_SUCCESS);
+    }
+    CHECK(test_heap_ring_size(heap)==4);
+    CHECK(test_heap_ring_destroy(heap)==CIRC_BUFF_SUCCESS);
+    CHECK(test_heap_ring_destroy(NULL)==CIRC_BUFF_NULL_PTR);
+}
+
+
+void test_stats(void)
+{
+    circ_buff_stats_snapshot snapshot;
+    circ_buff_ptr cb;
+    uint32_t index, value;
+    uint64_t ns, count=0;
+
+    CHECK(circ_buff_init(&cb, 4)==CIRC_BUFF_SUCCESS);
+
+#ifdef CIRC_BUFF_STATS
+    /*fill up past the top and drain past the bottom*/
+    for(index=0; index<4; index++)
+         CHECK(circ_buff_write(cb, index)==CIRC_BUFF_SUCCESS);
+    CHECK(circ_buff_write(cb, 4)==CIRC_BUFF_FULL);
+    for(index=0; index<3; index++)
+         CHECK(circ_buff_read(cb, &value)==CIRC_BUFF_SUCCESS);
+    CHECK(circ_buff_get_stats(cb, &snapshot)==CIRC_BUFF_SUCCESS);
+    CHECK(snapshot.capacity==4&&snapshot.occupied==1&&snapshot.high_water==4);
+    CHECK(snapshot.writes==4&&snapshot.reads==3);
+    CHECK(snapshot.full_rejects==1&&snapshot.empty_rejects==0);
+    CHECK(snapshot.residence_count==3);
+    for(index=0; index<CIRC_BUFF_STATS_BUCKETS; index++)
+         count+=snapshot.histogram[index];
+    CHECK(count==3&&snapshot.residence_max_ns<=snapshot.residence_total_ns);
+    CHECK(circ_buff_stats_percentile(&snapshot, 100, &ns)==CIRC_BUFF_SUCCESS);
+    CHECK(ns<=snapshot.residence_max_ns);
+    CHECK(circ_buff_stats_percentile(&snapshot, 101, &ns)==CIRC_BUFF_BAD_DATA);
+
+    /*a reset keeps the element in the buffer, which is still timed*/
+    CHECK(circ_buff_reset_stats(cb)==CIRC_BUFF_SUCCESS);
+    CHECK(circ_buff_get_stats(cb, &snapshot)==CIRC_BUFF_SUCCESS);
+    CHECK(snapshot.writes==0&&snapshot.high_water==1&&snapshot.residence_count==0);
+    CHECK(circ_buff_stats_percentile(&snapshot, 50, &ns)==CIRC_BUFF_EMPTY);
+    CHECK(circ_buff_read(cb, &value)==CIRC_BUFF_SUCCESS&&value==3);
+    CHECK(circ_buff_read(cb, &value)==CIRC_BUFF_EMPTY);
+    CHECK(circ_buff_get_stats(cb, &snapshot)==CIRC_BUFF_SUCCESS);
+    CHECK(snapshot.reads==1&&snapshot.empty_rejects==1&&snapshot.residence_count==1);
+#else
+    /*without the define no buffer has statistics*/
+    CHECK(cb->stats==NULL);
+    CHECK(circ_buff_get_stats(cb, &snapshot)==CIRC_BUFF_BAD_DATA);
+    CHECK(circ_buff_reset_stats(cb)==CIRC_BUFF_BAD_DATA);
+    (void)index;
+    (void)value;
+    (void)count;
+#endif
+
+    for(index=0; index+1<CIRC_BUFF_STATS_BUCKETS; index++)
+         CHECK(circ_buff_stats_bucket_floor(index)<circ_buff_stats_bucket_floor(index+1));
+    CHECK(circ_buff_stats_percentile(NULL, 50, &ns)==CIRC_BUFF_NULL_PTR);
+    CHECK(circ_buff_get_stats(NULL, &snapshot)==CIRC_BUFF_NULL_PTR);
+
+    CHECK(circ_buff_destroy(cb)==CIRC_BUFF_SUCCESS);
+}
+
+
+void test_shm(void)
+{
+    circ_buff_shm_ptr producer, consumer, other;
+    uint32_t index, value, count, in[6], out[6];
+    char name[64];
+    pid_t child;
+    int alive;
+
+    snprintf(name, sizeof(name), "/circ_buff_test_%d", (int)getpid());
+    circ_buff_shm_unlink(name);
+
+    CHECK(circ_buff_shm_attach(&producer, name, 0, CIRC_BUFF_SHM_PRODUCER)==CIRC_BUFF_BAD_DATA);
+    CHECK(circ_buff_shm_attach(&producer, name, 5, CIRC_BUFF_SHM_PRODUCER)==CIRC_BUFF_SUCCESS);
+    CHECK(circ_buff_shm_attach(&consumer, name, 0, CIRC_BUFF_SHM_CONSUMER)==CIRC_BUFF_SUCCESS);
+    CHECK(circ_buff_shm_attach(&other, name, 0, CIRC_BUFF_SHM_PRODUCER)==CIRC_BUFF_IN_USE);
+    CHECK(circ_buff_shm_attach(&other, name, 16, CIRC_BUFF_SHM_CONSUMER)==CIRC_BUFF_BAD_DATA);
+    CHECK(circ_buff_shm_peer_alive(producer, &alive)==CIRC_BUFF_SUCCESS&&alive==1);
+
+    /*each side may only move its own counter*/
+    CHECK(circ_buff_shm_write(consumer, 1)==CIRC_BUFF_BAD_DATA);
+    CHECK(circ_buff_shm_read(producer, &value)==CIRC_BUFF_BAD_DATA);
+    CHECK(circ_buff_shm_write_n(consumer, in, 1, &count)==CIRC_BUFF_BAD_DATA);
+    CHECK(circ_buff_shm_read_n(producer, out, 1, &count)==CIRC_BUFF_BAD_DATA);
+
+    /*boundaries; 5 is rounded up to 8*/
+    CHECK(circ_buff_shm_read(consumer, &value)==CIRC_BUFF_EMPTY);
+    for(index=0; index<8; index++)
+         CHECK(circ_buff_shm_write(producer, index)==CIRC_BUFF_SUCCESS);
+    CHECK(circ_buff_shm_write(producer, 8)==CIRC_BUFF_FULL);
+    for(index=0; index<8; index++)
+         CHECK(circ_buff_shm_read(consumer, &value)==CIRC_BUFF_SUCCESS&&value==index);
+    CHECK(circ_buff_shm_read(consumer, &value)==CIRC_BUFF_EMPTY);
+
+    /*batches across the end of the data region*/
+    for(index=0; index<6; index++)
+         in[index]=50+index;
+    for(index=0; index<5; index++)
+    {
+         CHECK(circ_buff_shm_write_n(producer, in, 6, &count)==CIRC_BUFF_SUCCESS&&count==6);
+         CHECK(circ_buff_shm_read_n(consumer, out, 6, &count)==CIRC_BUFF_SUCCESS&&count==6);
+         CHECK(memcmp(in, out, sizeof(in))==0);
+    }
+    CHECK(circ_buff_shm_read_n(consumer, out, 6, &count)==CIRC_BUFF_EMPTY);
+
+    /*the data outlives a detach of both sides*/
+    CHECK(circ_buff_shm_write(producer, 99)==CIRC_BUFF_SUCCESS);
+    CHECK(circ_buff_shm_detach(producer)==CIRC_BUFF_SUCCESS);
+    CHECK(circ_buff_shm_peer_alive(consumer, &alive)==CIRC_BUFF_SUCCESS&&alive==0);
+    CHECK(circ_buff_shm_detach(consumer)==CIRC_BUFF_SUCCESS);
+    CHECK(circ_buff_shm_attach(&consumer, name, 8, CIRC_BUFF_SHM_CONSUMER)==CIRC_BUFF_SUCCESS);
+    CHECK(circ_buff_shm_read(consumer, &value)==CIRC_BUFF_SUCCESS&&value==99);
+    CHECK(circ_buff_shm_detach(consumer)==CIRC_BUFF_SUCCESS);
+    CHECK(circ_buff_shm_unlink(name)==CIRC_BUFF_SUCCESS);
+
+    /*a creator that dies before storing the magic leaves a stale segment,
+     *which the next attach with a size initialises again*/
+    child=fork();
+    if(child==0)
+    {
+         int fd=shm_open(name, O_RDWR|O_CREAT|O_EXCL, 0600);
+         size_t size=sizeof(circ_buff_shm_ctrl)+8*sizeof(uint32_t);
+         circ_buff_shm_ctrl *ctrl;
+
+         if(fd<0||ftruncate(fd, (off_t)size)!=0)
+              _exit(1);
+         ctrl=(circ_buff_shm_ctrl*)mmap(NULL, size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+         if(ctrl==MAP_FAILED)
+              _exit(1);
+         atomic_store(&ctrl->init_pid, (int32_t)getpid());
+         _exit(0);
+    }
+    CHECK(child>0);
+    if(child>0)
+    {
+         waitpid(child, NULL, 0);
+         CHECK(circ_buff_shm_attach(&producer, name, 0, CIRC_BUFF_SHM_PRODUCER)==CIRC_BUFF_BAD_DATA);
+         CHECK(circ_buff_shm_attach(&producer, name, 8, CIRC_BUFF_SHM_PRODUCER)==CIRC_BUFF_SUCCESS);
+         CHECK(circ_buff_shm_attach(&consumer, name, 0, CIRC_BUFF_SHM_CONSUMER)==CIRC_BUFF_SUCCESS);
+         CHECK(circ_buff_shm_write(producer, 7)==CIRC_BUFF_SUCCESS);
+         CHECK(circ_buff_shm_read(consumer, &value)==CIRC_BUFF_SUCCESS&&value==7);
+         circ_buff_shm_detach(producer);
+         circ_buff_shm_detach(consumer);
+    }
+    circ_buff_shm_unlink(name);
+
+    CHECK(circ_buff_shm_attach(NULL, name, 8, CIRC_BUFF_SHM_PRODUCER)==CIRC_BUFF_NULL_PTR);
+    CHECK(circ_buff_shm_attach(&producer, name, -1, CIRC_BUFF_SHM_PRODUCER)==CIRC_BUFF_BAD_DATA);
+    CHECK(circ_buff_shm_write(NULL, 1)==CIRC_BUFF_NULL_PTR);
+}
+
+
+void test_file(void)
+{
+    circ_buff_ptr cb, other;
+    circ_buff_file_header header, corrupt;
+    uint32_t index, value;
+    char path[64];
+    int fd;
+
+    snprintf(path, sizeof(path), "/tmp/circ_buff_test_%d.dat", (int)getpid());
+    unlink(path);
+
+    CHECK(circ_buff_init_file(&cb, path, 0, CIRC_BUFF_MODE_DEFAULT)==CIRC_BUFF_BAD_DATA);
+    CHECK(circ_buff_init_file(&cb, path, 5, CIRC_BUFF_MODE_VMIRROR)==CIRC_BUFF_BAD_DATA);
+    CHECK(circ_buff_init_file(&cb, path, 5, CIRC_BUFF_MODE_DEFAULT)==CIRC_BUFF_SUCCESS);
+    CHECK(circ_buff_init_file(&other, path, 5, CIRC_BUFF_MODE_DEFAULT)==CIRC_BUFF_IN_USE);
+
+    /*boundaries and wraparound, then leave three elements behind*/
+    for(index=0; index<5; index++)
+         CHECK(circ_buff_write(cb, index)==CIRC_BUFF_SUCCESS);
+    CHECK(circ_buff_write(cb, 5)==CIRC_BUFF_FULL);
+    for(index=0; index<5; index++)
+         CHECK(circ_buff_read(cb, &value)==CIRC_BUFF_SUCCESS&&value==index);
+    CHECK(circ_buff_read(cb, &value)==CIRC_BUFF_EMPTY);
+    for(index=10; index<13; index++)
+         CHECK(circ_buff_write(cb, index)==CIRC_BUFF_SUCCESS);
+    CHECK(circ_buff_sync(cb)==CIRC_BUFF_SUCCESS);
+    CHECK(circ_buff_destroy(cb)==CIRC_BUFF_SUCCESS);
+
+    /*a reopen finds them, and must match the size and mode*/
+    CHECK(circ_buff_init_file(&cb, path, 6, CIRC_BUFF_MODE_DEFAULT)==CIRC_BUFF_BAD_DATA);
+    CHECK(circ_buff_init_file(&cb, path, 5, CIRC_BUFF_MODE_POW2)==CIRC_BUFF_BAD_DATA);
+    CHECK(circ_buff_init_file(&cb, path, 0, CIRC_BUFF_MODE_DEFAULT)==CIRC_BUFF_SUCCESS);
+    CHECK(cb->total_size==5);
+    for(index=10; index<13; index++)
+         CHECK(circ_buff_read(cb, &value)==CIRC_BUFF_SUCCESS&&value==index);
+    CHECK(circ_buff_read(cb, &value)==CIRC_BUFF_EMPTY);
+    CHECK(circ_buff_write(cb, 20)==CIRC_BUFF_SUCCESS);
+    CHECK(circ_buff_destroy(cb)==CIRC_BUFF_SUCCESS);
+
+    /*a damaged header is refused, not formatted over*/
+    fd=open(path, O_RDWR);
+    CHECK(fd>=0);
+    CHECK(pread(fd, &header, sizeof(header), 0)==(ssize_t)sizeof(header));
+    corrupt=header;
+    corrupt.total_size++;
+    CHECK(pwrite(fd, &corrupt, sizeof(corrupt), 0)==(ssize_t)sizeof(corrupt));
+    CHECK(circ_buff_init_file(&cb, path, 0, CIRC_BUFF_MODE_DEFAULT)==CIRC_BUFF_BAD_DATA);
+    corrupt=header;
+    corrupt.magic=0;
+    CHECK(pwrite(fd, &corrupt, sizeof(corrupt), 0)==(ssize_t)sizeof(corrupt));
+    CHECK(circ_buff_init_file(&cb, path, 5, CIRC_BUFF_MODE_DEFAULT)==CIRC_BUFF_BAD_DATA);
+    corrupt=header;
+    atomic_store(&corrupt.tail_count, atomic_load(&header.head_count)+6);
+    CHECK(pwrite(fd, &corrupt, sizeof(corrupt), 0)==(ssize_t)sizeof(corrupt));
+    CHECK(circ_buff_init_file(&cb, path, 5, CIRC_BUFF_MODE_DEFAULT)==CIRC_BUFF_BAD_DATA);
+
+    /*the intact header still opens with its element*/
+    CHECK(pwrite(fd, &header, sizeof(header), 0)==(ssize_t)sizeof(header));
+    CHECK(circ_buff_init_file(&cb, path, 5, CIRC_BUFF_MODE_DEFAULT)==CIRC_BUFF_SUCCESS);
+    CHECK(circ_buff_read(cb, &value)==CIRC_BUFF_SUCCESS&&value==20);
+    CHECK(circ_buff_destroy(cb)==CIRC_BUFF_SUCCESS);
+
+    /*a creation cut short before the commit leaves magic and checksum 0;
+     *such a file is formatted again, at the size asked for*/
+    memset(&corrupt, 0, sizeof(corrupt));
+    corrupt.version=CIRC_BUFF_FILE_VERSION;
+    corrupt.total_size=5;
+    CHECK(pwrite(fd, &corrupt, sizeof(corrupt), 0)==(ssize_t)sizeof(corrupt));
+    CHECK(circ_buff_init_file(&cb, path, 0, CIRC_BUFF_MODE_DEFAULT)==CIRC_BUFF_BAD_DATA);
+    CHECK(circ_buff_init_file(&cb, path, 9, CIRC_BUFF_MODE_DEFAULT)==CIRC_BUFF_SUCCESS);
+    CHECK(cb->total_size==9&&cb->size_occupied==0);
+    CHECK(circ_buff_read(cb, &value)==CIRC_BUFF_EMPTY);
+    CHECK(circ_buff_write(cb, 30)==CIRC_BUFF_SUCCESS);
+    CHECK(circ_buff_destroy(cb)==CIRC_BUFF_SUCCESS);
+    CHECK(circ_buff_init_file(&cb, path, 0, CIRC_BUFF_MODE_DEFAULT)==CIRC_BUFF_SUCCESS);
+    CHECK(cb->total_size==9);
+    CHECK(circ_buff_read(cb, &value)==CIRC_BUFF_SUCCESS&&value==30);
+    CHECK(circ_buff_destroy(cb)==CIRC_BUFF_SUCCESS);
+
+    /*so is a file cut short before its header*/
+    CHECK(ftruncate(fd, 10)==0);
+    CHECK(circ_buff_init_file(&cb, path, 4, CIRC_BUFF_MODE_DEFAULT)==CIRC_BUFF_SUCCESS);
+    CHECK(cb->total_size==4&&cb->size_occupied==0);
+    CHECK(circ_buff_destroy(cb)==CIRC_BUFF_SUCCESS);
+    close(fd);
+    unlink(path);
+
+    CHECK(circ_buff_init(&cb, 4)==CIRC_BUFF_SUCCESS);
+    CHECK(circ_buff_sync(cb)==CIRC_BUFF_BAD_DATA);
+    circ_buff_destroy(cb);
+    CHECK(circ_buff_init_file(&cb, NULL, 4, CIRC_BUFF_MODE_DEFAULT)==CIRC_BUFF_NULL_PTR);
+    CHECK(circ_buff_sync(NULL)==CIRC_BUFF_NULL_PTR);
+}
+
+
+/*
+ * Function:     test_rec_mode(uint32_t mode)
+ * -----------------------------------------------------------------------------
+ * Description:  Runs the record checks on a 64 byte record ring in the given
+ *               mode.
+ * ----------------------------------------------------------------------------
+ */
+static void test_rec_mode(uint32_t mode)
+{
+    circ_buff_ptr cb;
+    unsigned char in[64], out[64];
+    uint32_t index, length, written, read, words=0;
+    const void *record;
+#ifdef CIRC_BUFF_STATS
+    circ_buff_stats_snapshot snapshot;
+#endif
+
+    for(index=0; index<sizeof(in); index++)
+         in[index]=(unsigned char)(index*7+1);
+
+    CHECK(circ_buff_rec_init(&cb, 64, mode)==CIRC_BUFF_SUCCESS);
+
+    CHECK(circ_buff_rec_read(cb, out, sizeof(out), &length)==CIRC_BUFF_EMPTY);
+    CHECK(circ_buff_rec_peek(cb, &record, &length)==CIRC_BUFF_EMPTY);
+    CHECK(circ_buff_rec_release(cb)==CIRC_BUFF_EMPTY);
+    CHECK(circ_buff_rec_write(cb, in, (cb->total_size-1)*4+1)==CIRC_BUFF_BAD_DATA);
+
+    /*records of every length from 0 to 20 bytes, so they wrap at every
+     *offset and pads are written and skipped*/
+    for(index=0; index<200; index++)
+    {
+         uint32_t size=index%21;
+
+         CHECK(circ_buff_rec_write(cb, in+index%5, size)==CIRC_BUFF_SUCCESS);
+         memset(out, 0, sizeof(out));
+         CHECK(circ_buff_rec_read(cb, out, sizeof(out), &length)==CIRC_BUFF_SUCCESS);
+         CHECK(length==size&&memcmp(out, in+index%5, size)==0);
+         words+=CIRC_BUFF_REC_WORDS(size);
+    }
+
+#ifdef CIRC_BUFF_STATS
+    /*pads and rewinds are not data, so only the record words count*/
+    CHECK(circ_buff_get_stats(cb, &snapshot)==CIRC_BUFF_SUCCESS);
+    CHECK(snapshot.writes==words&&snapshot.reads==words);
+#else
+    (void)words;
+#endif
+
+    /*fill up, then drain in order*/
+    for(written=0; circ_buff_rec_write(cb, in, 6+written%3)==CIRC_BUFF_SUCCESS; written++)
+         ;
+    CHECK(written>=4);
+    for(read=0; read<written; read++)
+    {
+         CHECK(circ_buff_rec_peek(cb, &record, &length)==CIRC_BUFF_SUCCESS);
+         CHECK(length==6+read%3&&memcmp(record, in, length)==0);
+         CHECK(circ_buff_rec_release(cb)==CIRC_BUFF_SUCCESS);
+    }
+    CHECK(circ_buff_rec_read(cb, out, sizeof(out), &length)==CIRC_BUFF_EMPTY);
+
+    /*a record longer than the caller's buffer stays in the ring*/
+    CHECK(circ_buff_rec_write(cb, in, 12)==CIRC_BUFF_SUCCESS);
+    CHECK(circ_buff_rec_read(cb, out, 4, &length)==CIRC_BUFF_BAD_DATA&&length==12);
+    CHECK(circ_buff_rec_read(cb, out, 12, &length)==CIRC_BUFF_SUCCESS&&length==12);
+
+    CHECK(circ_buff_rec_write(cb, NULL, 4)==CIRC_BUFF_NULL_PTR);
+    CHECK(circ_buff_rec_read(cb, out, sizeof(out), NULL)==CIRC_BUFF_NULL_PTR);
+
+    CHECK(circ_buff_destroy(cb)==CIRC_BUFF_SUCCESS);
+}
+
+void test_rec(void)
+{
+    circ_buff_ptr cb;
+
+    test_rec_mode(CIRC_BUFF_MODE_DEFAULT);
+    test_rec_mode(CIRC_BUFF_MODE_POW2);
+    test_rec_mode(CIRC_BUFF_MODE_VMIRROR);
+
+    CHECK(circ_buff_rec_init(&cb, 64, CIRC_BUFF_MODE_OVERWRITE)==CIRC_BUFF_BAD_DATA);
+    CHECK(circ_buff_rec_init(&cb, 0, CIRC_BUFF_MODE_DEFAULT)==CIRC_BUFF_BAD_DATA);
+    CHECK(circ_buff_rec_init(NULL, 64, CIRC_BUFF_MODE_DEFAULT)==CIRC_BUFF_NULL_PTR);
+}
@@ -0,0 +1,954 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         test_doubly_ll.c
+ *
+ * Description:  Behaviour tests of the doubly linked lists in ../doubly_ll.
+ *               The positional lists are driven by a fixed sequence of
+ *               random operations and compared after each one against an
+ *               array that models the same list; the boundaries (the ends,
+ *               one past the end, empty lists) and the error codes of bad
+ *               arguments are checked on their own.
+ *
+ * */
+
+
+#include<stdint.h>
+#include<stdlib.h>
+#include<string.h>
+#include<stdatomic.h>
+#include<pthread.h>
+#include "doubly_ll.h"
+#include "dll_pool.h"
+#include "dll_unrolled.h"
+#include "dll_indexed.h"
+#include "dll_hash.h"
+#include "dll_lru.h"
+#include "dll_simd.h"
+#include "dll_intrusive.h"
+#include "dll_conc.h"
+#include "test.h"
+
+/*size limit and number of operations of the randomised model tests*/
+#define TEST_MODEL_SIZE 600u
+#define TEST_MODEL_OPS  4000u
+
+/*threads of the concurrent list test: writers mixing every operation and
+ *readers that only search; each writer does TEST_CONC_OPS operations on
+ *values below TEST_CONC_VALUES*/
+#define TEST_CONC_WRITERS 4u
+#define TEST_CONC_READERS 2u
+#define TEST_CONC_OPS     20000u
+#define TEST_CONC_VALUES  64u
+
+
+/*
+ * Function:     test_random(uint32_t* state)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the next number of a xorshift generator, so that every
+ *               run does the same operations.
+ * ----------------------------------------------------------------------------
+ */
+static uint32_t test_random(uint32_t* state)
+{
+    *state^=*state<<13;
+    *state^=*state>>17;
+    *state^=*state<<5;
+
+    return *state;
+}
+
+/*
+ * Function:     test_model_insert(uint32_t* model, uint32_t* size, uint32_t position,
+ *                                 uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Inserts data at position of the model array.
+ * ----------------------------------------------------------------------------
+ */
+static void test_model_insert(uint32_t* model, uint32_t* size, uint32_t position, uint32_t data)
+{
+    memmove(model+position+1, model+position, (*size-position)*sizeof(uint32_t));
+    model[position]=data;
+    (*size)++;
+}
+
+/*
+ * Function:     test_model_remove(uint32_t* model, uint32_t* size, uint32_t position)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes the value at position of the model array and returns
+ *               it.
+ * ----------------------------------------------------------------------------
+ */
+static uint32_t test_model_remove(uint32_t* model, uint32_t* size, uint32_t position)
+{
+    uint32_t data=model[position];
+
+    memmove(model+position, model+position+1, (*size-position-1)*sizeof(uint32_t));
+    (*size)--;
+
+    return data;
+}
+
+/*
+ * Function:     test_model_search(const uint32_t* model, uint32_t size, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the position of the first data in the model, or size
+ *               if it is not there.
+ * ----------------------------------------------------------------------------
+ */
+static uint32_t test_model_search(const uint32_t* model, uint32_t size, uint32_t data)
+{
+    uint32_t position;
+
+    for(position=0; position<size&&model[position]!=data; position++)
+         ;
+
+    return position;
+}
+
+/*
+ * Function:     test_list_matches(dll_list_ptr list, const uint32_t* model, uint32_t size)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns 1 if list holds the model in order, its links agree in
+ *               both directions and its count and tail are right.
+ * ----------------------------------------------------------------------------
+ */
+static int test_list_matches(dll_list_ptr list, const uint32_t* model, uint32_t size)
+{
+    dll_node_ptr node=list->head, prev=NULL;
+    uint32_t position;
+
+    for(position=0; position<size; position++)
+    {
+         if(node==NULL||node->data!=model[position]||node->prev_ptr!=prev)
+              return 0;
+         prev=node;
+         node=node->next_ptr;
+    }
+
+    return node==NULL&&list->tail==prev&&list->count==size;
+}
+
+/*
+ * Function:     test_list_index_matches(dll_list_ptr list)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns 1 if dll_list_find returns the first node holding the
+ *               data of every node of the list, as a scan finds it.
+ * ----------------------------------------------------------------------------
+ */
+static int test_list_index_matches(dll_list_ptr list)
+{
+    dll_node_ptr node, first, found;
+
+    for(node=list->head; node!=NULL; node=node->next_ptr)
+    {
+         for(first=list->head; first->data!=node->data; first=first->next_ptr)
+              ;
+         if(dll_list_find(list, node->data, &found)!=DLL_SUCCESS||found!=first)
+              return 0;
+    }
+
+    return 1;
+}
+
+
+/*
+ * Function:     test_list_model(dll_list_ptr list, uint32_t seed)
+ * -----------------------------------------------------------------------------
+ * Description:  Runs the random operations on list and checks it against the
+ *               model after each one; with an index the index is checked too.
+ *               Values are kept small so that there are many duplicates.
+ * ----------------------------------------------------------------------------
+ */
+static void test_list_model(dll_list_ptr list, uint32_t seed)
+{
+    uint32_t model[TEST_MODEL_SIZE+1], size=0, op, data, position, found;
+    int indexed=(list->index!=NULL), ok=1;
+    dll_code status;
+
+    for(op=0; op<TEST_MODEL_OPS&&ok; op++)
+    {
+         uint32_t choice=test_random(&seed)%7;
+         data=test_random(&seed)%32;
+
+         if(size==TEST_MODEL_SIZE)
+              choice=4;
+
+         switch(choice)
+         {
+              case 0:
+                   ok=(dll_list_push_front(list, data)==DLL_SUCCESS);
+                   test_model_insert(model, &size, 0, data);
+                   break;
+              case 1:
+                   ok=(dll_list_push_back(list, data)==DLL_SUCCESS);
+                   test_model_insert(model, &size, size, data);
+                   break;
+              case 2:
+                   position=test_random(&seed)%(size+1);
+                   ok=(dll_list_add_node(list, position, data)==DLL_SUCCESS);
+                   test_model_insert(model, &size, position, data);
+                   break;
+              case 3:
+                   status=dll_list_pop_back(list, &found);
+                   if(size==0)
+                        ok=(status==DLL_EMPTY);
+                   else
+                        ok=(status==DLL_SUCCESS&&found==test_model_remove(model, &size, size-1));
+                   break;
+              case 4:
+                   if(size==0)
+                   {
+                        ok=(dll_list_remove_node(list, 0, &found)==DLL_BAD_POSITION);
+                        break;
+                   }
+                   position=test_random(&seed)%size;
+                   ok=(dll_list_remove_node(list, position, &found)==DLL_SUCCESS&&
+                       found==test_model_remove(model, &size, position));
+                   break;
+              case 5:
+                   position=test_model_search(model, size, data);
+                   status=dll_list_remove_value(list, data);
+                   if(position==size)
+                        ok=(status==DLL_DATA_MISSING);
+                   else
+                   {
+                        ok=(status==DLL_SUCCESS);
+                        test_model_remove(model, &size, position);
+                   }
+                   break;
+              default:
+                   position=test_model_search(model, size, data);
+                   status=dll_list_search(list, data, &found);
+                   ok=(position==size)? status==DLL_DATA_MISSING: status==DLL_SUCCESS&&found==position;
+                   break;
+         }
+
+         ok=ok&&test_list_matches(list, model, size);
+         if(indexed)
+              ok=ok&&test_list_index_matches(list);
+    }
+    CHECK(ok);
+
+    /*one past the end*/
+    CHECK(dll_list_add_node(list, size+1, 0)==DLL_BAD_POSITION);
+    CHECK(dll_list_remove_node(list, size, &found)==DLL_BAD_POSITION);
+}
+
+void test_list(void)
+{
+    dll_list_ptr list;
+    uint32_t data, size;
+
+    CHECK(dll_list_init(&list)==DLL_SUCCESS);
+    CHECK(dll_list_pop_front(list, &data)==DLL_EMPTY);
+    CHECK(dll_list_pop_back(list, &data)==DLL_EMPTY);
+    CHECK(dll_list_size(list, &size)==DLL_SUCCESS&&size==0);
+    test_list_model(list, 1u);
+    CHECK(dll_list_destroy(list)==DLL_SUCCESS);
+
+    CHECK(dll_list_init(NULL)==DLL_NULL_PTR);
+    CHECK(dll_list_push_back(NULL, 1)==DLL_NULL_PTR);
+    CHECK(dll_list_destroy(NULL)==DLL_NULL_PTR);
+}
+
+
+void test_bulk(void)
+{
+    static const uint32_t odd[]={1, 3, 5, 7}, mixed[]={2, 3, 4, 8, 9};
+    static const uint32_t merged[]={1, 2, 3, 3, 4, 5, 7, 8, 9};
+    static const uint32_t digits[]={10, 11, 12, 13, 14}, twenties[]={20, 21, 22, 23, 24};
+    static const uint32_t middle[]={10, 11, 21, 22, 12, 13, 14}, rest_middle[]={20, 23, 24};
+    static const uint32_t to_tail[]={10, 11, 21, 22, 12, 13, 14, 23, 24};
+    static const uint32_t to_head[]={20, 10, 11, 21, 22, 12, 13, 14, 23, 24};
+    dll_list_ptr list, other, plain;
+    dll_node_ptr three, node;
+
+    /*lists filled from arrays on one thread share its pool, so a sorted
+     *pair merges; ties keep the nodes of list first*/
+    CHECK(dll_list_init(&list)==DLL_SUCCESS);
+    CHECK(dll_list_init(&other)==DLL_SUCCESS);
+    CHECK(dll_list_from_array(list, odd, 4)==DLL_SUCCESS);
+    CHECK(dll_list_from_array(other, mixed, 5)==DLL_SUCCESS);
+    CHECK(list->pool!=NULL&&list->pool==other->pool);
+    three=list->head->next_ptr;
+    CHECK(dll_list_merge(list, other)==DLL_SUCCESS);
+    CHECK(test_list_matches(list, merged, 9));
+    CHECK(list->head->next_ptr->next_ptr==three);
+    CHECK(other->head==NULL&&other->tail==NULL&&other->count==0);
+
+    /*an empty side on either end*/
+    CHECK(dll_list_merge(list, other)==DLL_SUCCESS);
+    CHECK(test_list_matches(list, merged, 9));
+    CHECK(dll_list_merge(other, list)==DLL_SUCCESS);
+    CHECK(test_list_matches(other, merged, 9)&&list->count==0);
+    CHECK(dll_list_merge(other, other)==DLL_INCOMPATIBLE);
+    CHECK(dll_list_destroy(list)==DLL_SUCCESS);
+    CHECK(dll_list_destroy(other)==DLL_SUCCESS);
+
+    /*ranges: from the middle, ending at the tail, and put at the head*/
+    CHECK(dll_list_init(&list)==DLL_SUCCESS);
+    CHECK(dll_list_init(&other)==DLL_SUCCESS);
+    CHECK(dll_list_from_array(list, digits, 5)==DLL_SUCCESS);
+    CHECK(dll_list_from_array(other, twenties, 5)==DLL_SUCCESS);
+    node=other->head->next_ptr;
+    CHECK(dll_list_splice_range(list, list->head->next_ptr->next_ptr, other, node, node->next_ptr)==DLL_SUCCESS);
+    CHECK(test_list_matches(list, middle, 7)&&test_list_matches(other, rest_middle, 3));
+    CHECK(dll_list_splice_range(list, NULL, other, other->head->next_ptr, other->tail)==DLL_SUCCESS);
+    CHECK(test_list_matches(list, to_tail, 9)&&test_list_matches(other, rest_middle, 1));
+    CHECK(dll_list_splice_range(list, list->head, other, other->head, other->tail)==DLL_SUCCESS);
+    CHECK(test_list_matches(list, to_head, 10)&&test_list_matches(other, NULL, 0));
+    CHECK(dll_list_splice_range(list, NULL, list, list->head, list->tail)==DLL_INCOMPATIBLE);
+
+    /*the whole of a list, then back*/
+    CHECK(dll_list_splice(other, NULL, list)==DLL_SUCCESS);
+    CHECK(test_list_matches(other, to_head, 10)&&list->count==0);
+
+    /*a list on malloc nodes can not take pool nodes*/
+    CHECK(dll_list_init(&plain)==DLL_SUCCESS);
+    CHECK(dll_list_push_back(plain, 1)==DLL_SUCCESS);
+    CHECK(dll_list_from_array(plain, odd, 4)==DLL_SUCCESS);
+    CHECK(plain->pool==NULL&&plain->count==5);
+    CHECK(dll_list_splice(plain, NULL, other)==DLL_INCOMPATIBLE);
+    CHECK(dll_list_merge(other, plain)==DLL_INCOMPATIBLE);
+
+    CHECK(dll_list_destroy(plain)==DLL_SUCCESS);
+    CHECK(dll_list_destroy(other)==DLL_SUCCESS);
+    CHECK(dll_list_destroy(list)==DLL_SUCCESS);
+
+    CHECK(dll_list_from_array(NULL, odd, 4)==DLL_NULL_PTR);
+    CHECK(dll_list_merge(NULL, NULL)==DLL_NULL_PTR);
+    CHECK(dll_list_splice_range(NULL, NULL, NULL, NULL, NULL)==DLL_NULL_PTR);
+}
+
+
+void test_pool(void)
+{
+    dll_node_ptr nodes[10], node;
+    dll_pool_ptr pool, local, again;
+    dll_list_ptr list, rest;
+    uint32_t index, other, data;
+    int distinct=1;
+
+    CHECK(dll_pool_init(NULL, 4)==DLL_NULL_PTR);
+    CHECK(dll_pool_init(&pool, 4)==DLL_SUCCESS);
+
+    /*allocations cross chunk boundaries and never hand out a node twice*/
+    for(index=0; index<10; index++)
+         CHECK(dll_pool_alloc(pool, &nodes[index])==DLL_SUCCESS);
+    for(index=0; index<10; index++)
+         for(other=0; other<index; other++)
+              distinct=distinct&&(nodes[index]!=nodes[other]);
+    CHECK(distinct);
+    CHECK(pool->total_count>=10&&pool->free_count==pool->total_count-10);
+
+    /*a freed node is reused; a chain goes back in one go*/
+    CHECK(dll_pool_free(pool, nodes[9])==DLL_SUCCESS);
+    CHECK(dll_pool_alloc(pool, &node)==DLL_SUCCESS&&node==nodes[9]);
+    for(index=0; index+1<10; index++)
+         nodes[index]->next_ptr=nodes[index+1];
+    CHECK(dll_pool_free_chain(pool, nodes[0], nodes[9], 10)==DLL_SUCCESS);
+    CHECK(pool->free_count==pool->total_count);
+    CHECK(dll_pool_reserve(pool, pool->total_count+100)==DLL_SUCCESS);
+    CHECK(pool->free_count>=pool->total_count-pool->free_count+100);
+
+    /*lists keep the pool alive after the creator drops it*/
+    CHECK(dll_list_init_pool(&list, pool)==DLL_SUCCESS);
+    CHECK(dll_pool_destroy(pool)==DLL_SUCCESS);
+    test_list_model(list, 2u);
+    if(list->head!=NULL)
+    {
+         CHECK(dll_list_split(list, list->head, &rest)==DLL_SUCCESS);
+         CHECK(rest->pool==list->pool);
+         CHECK(dll_list_destroy(list)==DLL_SUCCESS);
+         CHECK(dll_list_push_back(rest, 5)==DLL_SUCCESS);
+         CHECK(dll_list_pop_back(rest, &data)==DLL_SUCCESS&&data==5);
+         CHECK(dll_list_destroy(rest)==DLL_SUCCESS);
+    }
+    else
+         CHECK(dll_list_destroy(list)==DLL_SUCCESS);
+
+    /*the thread's own pool is the same on every call*/
+    CHECK(dll_pool_thread_local(&local)==DLL_SUCCESS);
+    CHECK(dll_pool_thread_local(&again)==DLL_SUCCESS&&again==local);
+
+    CHECK(dll_pool_alloc(NULL, &node)==DLL_NULL_PTR);
+    CHECK(dll_pool_destroy(NULL)==DLL_NULL_PTR);
+}
+
+
+void test_unrolled(void)
+{
+    uint32_t model[TEST_MODEL_SIZE+1], size=0, op, data, position, found, matches, seed=3u;
+    uint32_t positions[4];
+    dll_unrolled_ptr list;
+    int ok=1;
+
+    CHECK(dll_unrolled_init(&list)==DLL_SUCCESS);
+    CHECK(dll_unrolled_get(list, 0, &data)==DLL_BAD_POSITION);
+    CHECK(dll_unrolled_remove_node(list, 0, &data)==DLL_BAD_POSITION);
+
+    /*grow past several nodes by appending, then random edits so nodes split
+     *and merge*/
+    for(position=0; position<3*DLL_UNROLLED_NODE_VALUES+1; position++)
+    {
+         ok=ok&&dll_unrolled_add_node(list, size, position%32)==DLL_SUCCESS;
+         test_model_insert(model, &size, size, position%32);
+    }
+    for(op=0; op<TEST_MODEL_OPS&&ok; op++)
+    {
+         data=test_random(&seed)%32;
+
+         if(size<TEST_MODEL_SIZE&&(size==0||test_random(&seed)%2==0))
+         {
+              position=test_random(&seed)%(size+1);
+              ok=(dll_unrolled_add_node(list, position, data)==DLL_SUCCESS);
+              test_model_insert(model, &size, position, data);
+         }
+         else
+         {
+              position=test_random(&seed)%size;
+              ok=(dll_unrolled_remove_node(list, position, &found)==DLL_SUCCESS&&
+                  found==test_model_remove(model, &size, position));
+         }
+
+         position=test_model_search(model, size, data);
+         ok=ok&&((position==size)? dll_unrolled_search(list, data, &found)==DLL_DATA_MISSING:
+                                   dll_unrolled_search(list, data, &found)==DLL_SUCCESS&&found==position);
+    }
+    CHECK(ok);
+
+    /*every position reads back; size, count and find_all agree*/
+    for(position=0; position<size; position++)
+         ok=ok&&dll_unrolled_get(list, position, &found)==DLL_SUCCESS&&found==model[position];
+    CHECK(ok);
+    CHECK(dll_unrolled_size(list, &found)==DLL_SUCCESS&&found==size);
+    if(size>0)
+    {
+         for(position=0, matches=0; position<size; position++)
+              matches+=(model[position]==model[0]);
+         CHECK(dll_unrolled_count(list, model[0], &found)==DLL_SUCCESS&&found==matches);
+         CHECK(dll_unrolled_find_all(list, model[0], positions, 1, &found)==DLL_SUCCESS&&
+               found==matches&&positions[0]==0);
+    }
+    CHECK(dll_unrolled_find_all(list, 1000, NULL, 0, &found)==DLL_SUCCESS&&found==0);
+    CHECK(dll_unrolled_add_node(list, size+1, 0)==DLL_BAD_POSITION);
+    CHECK(dll_unrolled_get(list, size, &found)==DLL_BAD_POSITION);
+
+    /*nodes are cache line aligned*/
+    CHECK(((uintptr_t)list->head%DLL_UNROLLED_NODE_ALIGN)==0);
+
+    CHECK(dll_unrolled_destroy(list)==DLL_SUCCESS);
+    CHECK(dll_unrolled_init(NULL)==DLL_NULL_PTR);
+    CHECK(dll_unrolled_get(NULL, 0, &data)==DLL_NULL_PTR);
+}
+
+
+void test_indexed(void)
+{
+    uint32_t model[TEST_MODEL_SIZE+1], size=0, op, data, position, found, seed=4u;
+    dll_indexed_ptr list;
+    int ok=1;
+
+    CHECK(dll_indexed_init(&list)==DLL_SUCCESS);
+    CHECK(dll_indexed_get(list, 0, &data)==DLL_BAD_POSITION);
+    CHECK(dll_indexed_remove_node(list, 0, &data)==DLL_BAD_POSITION);
+    CHECK(dll_indexed_search(list, 1, &found)==DLL_DATA_MISSING);
+
+    for(op=0; op<TEST_MODEL_OPS&&ok; op++)
+    {
+         data=test_random(&seed)%64;
+
+         if(size<TEST_MODEL_SIZE&&(size==0||test_random(&seed)%3!=0))
+         {
+              position=test_random(&seed)%(size+1);
+              ok=(dll_indexed_add_node(list, position, data)==DLL_SUCCESS);
+              test_model_insert(model, &size, position, data);
+         }
+         else
+         {
+              position=test_random(&seed)%size;
+              ok=(dll_indexed_remove_node(list, position, &found)==DLL_SUCCESS&&
+                  found==test_model_remove(model, &size, position));
+         }
+
+         if(size>0)
+         {
+              position=test_random(&seed)%size;
+              ok=ok&&dll_indexed_get(list, position, &found)==DLL_SUCCESS&&found==model[position];
+         }
+         position=test_model_search(model, size, data);
+         ok=ok&&((position==size)? dll_indexed_search(list, data, &found)==DLL_DATA_MISSING:
+                                   dll_indexed_search(list, data, &found)==DLL_SUCCESS&&found==position);
+    }
+    CHECK(ok);
+
+    for(position=0; position<size; position++)
+         ok=ok&&dll_indexed_get(list, position, &found)==DLL_SUCCESS&&found==model[position];
+    CHECK(ok);
+    CHECK(dll_indexed_size(list, &found)==DLL_SUCCESS&&found==size);
+    CHECK(dll_indexed_add_node(list, size+1, 0)==DLL_BAD_POSITION);
+    CHECK(dll_indexed_get(list, size, &found)==DLL_BAD_POSITION);
+
+    CHECK(dll_indexed_destroy(list)==DLL_SUCCESS);
+    CHECK(dll_indexed_init(NULL)==DLL_NULL_PTR);
+    CHECK(dll_indexed_get(NULL, 0, &data)==DLL_NULL_PTR);
+}
+
+
+void test_hash(void)
+{
+    static const uint32_t values[]={5, 3, 5, 9, 3, 3, 7, 5};
+    dll_node nodes[4];
+    dll_list_ptr list, rest;
+    dll_node_ptr node;
+    dll_hash_ptr hash;
+    uint32_t index, position;
+
+    /*the index directly: one slot per key, holding its first node*/
+    CHECK(dll_hash_init(&hash, 0)==DLL_SUCCESS);
+    for(index=0; index<4; index++)
+    {
+         nodes[index].data=(index<2)? 1: 2;
+         nodes[index].prev_ptr=(index>0)? &nodes[index-1]: NULL;
+         nodes[index].next_ptr=(index<3)? &nodes[index+1]: NULL;
+    }
+    CHECK(dll_hash_insert_range(hash, &nodes[0], &nodes[3])==DLL_SUCCESS);
+    CHECK(dll_hash_find(hash, 1, &node)==DLL_SUCCESS&&node==&nodes[0]);
+    CHECK(dll_hash_find(hash, 2, &node)==DLL_SUCCESS&&node==&nodes[2]);
+    CHECK(dll_hash_find(hash, 3, &node)==DLL_DATA_MISSING);
+    CHECK(dll_hash_remove(hash, &nodes[0])==DLL_SUCCESS);
+    CHECK(dll_hash_find(hash, 1, &node)==DLL_SUCCESS&&node==&nodes[1]);
+    CHECK(dll_hash_remove(hash, &nodes[0])==DLL_DATA_MISSING);
+    CHECK(dll_hash_clear(hash)==DLL_SUCCESS);
+    CHECK(dll_hash_find(hash, 2, &node)==DLL_DATA_MISSING);
+    CHECK(dll_hash_destroy(hash)==DLL_SUCCESS);
+
+    /*a list with an index under random edits*/
+    CHECK(dll_list_init(&list)==DLL_SUCCESS);
+    CHECK(dll_list_attach_index(list)==DLL_SUCCESS);
+    test_list_model(list, 5u);
+    CHECK(dll_list_destroy(list)==DLL_SUCCESS);
+
+    /*bulk moves between indexed lists keep the first duplicates right*/
+    CHECK(dll_list_init(&list)==DLL_SUCCESS);
+    CHECK(dll_list_from_array(list, values, 8)==DLL_SUCCESS);
+    CHECK(dll_list_attach_index(list)==DLL_SUCCESS);
+    CHECK(dll_list_find(list, 3, &node)==DLL_SUCCESS&&node==list->head->next_ptr);
+    CHECK(dll_list_search(list, 7, &position)==DLL_SUCCESS&&position==6);
+    CHECK(dll_list_search(list, 4, &position)==DLL_DATA_MISSING);
+
+    CHECK(dll_list_split(list, list->head->next_ptr->next_ptr->next_ptr, &rest)==DLL_SUCCESS);
+    CHECK(rest->index!=NULL&&list->count==3&&rest->count==5);
+    CHECK(test_list_index_matches(list)&&test_list_index_matches(rest));
+    CHECK(dll_list_find(list, 9, &node)==DLL_DATA_MISSING);
+    CHECK(dll_list_splice(list, list->head, rest)==DLL_SUCCESS);
+    CHECK(list->count==8&&rest->count==0&&list->head->data==9);
+    CHECK(test_list_index_matches(list));
+    CHECK(dll_list_splice(list, NULL, list)==DLL_INCOMPATIBLE);
+
+    CHECK(dll_list_remove_value(list, 5)==DLL_SUCCESS);
+    CHECK(test_list_index_matches(list));
+    CHECK(dll_list_detach_index(list)==DLL_SUCCESS&&list->index==NULL);
+    CHECK(dll_list_find(list, 7, &node)==DLL_SUCCESS&&node->data==7);
+
+    CHECK(dll_list_destroy(rest)==DLL_SUCCESS);
+    CHECK(dll_list_destroy(list)==DLL_SUCCESS);
+
+    CHECK(dll_hash_init(NULL, 0)==DLL_NULL_PTR);
+    CHECK(dll_list_find(NULL, 1, &node)==DLL_NULL_PTR);
+}
+
+
+typedef struct test_evictions
+{
+    uint32_t count;
+    uint32_t key;
+    uint32_t value;
+}test_evictions;
+
+/*
+ * Function:     test_lru_evict(uint32_t key, uint32_t value, void* context)
+ * -----------------------------------------------------------------------------
+ * Description:  Records the last eviction in the test_evictions at context.
+ * ----------------------------------------------------------------------------
+ */
+static void test_lru_evict(uint32_t key, uint32_t value, void* context)
+{
+    test_evictions *evictions=(test_evictions*)context;
+
+    evictions->count++;
+    evictions->key=key;
+    evictions->value=value;
+}
+
+void test_lru(void)
+{
+    test_evictions evictions={0, 0, 0};
+    uint64_t hits, misses, evicted;
+    uint32_t value, key;
+    dll_lru_ptr lru;
+
+    CHECK(dll_lru_init(&lru, 0, NULL, NULL)==DLL_BAD_DATA);
+    CHECK(dll_lru_init(NULL, 2, NULL, NULL)==DLL_NULL_PTR);
+    CHECK(dll_lru_init(&lru, 2, test_lru_evict, &evictions)==DLL_SUCCESS);
+
+    CHECK(dll_lru_get(lru, 1, &value)==DLL_DATA_MISSING);
+    CHECK(dll_lru_put(lru, 1, 10)==DLL_SUCCESS);
+    CHECK(dll_lru_put(lru, 2, 20)==DLL_SUCCESS);
+    CHECK(dll_lru_get(lru, 1, &value)==DLL_SUCCESS&&value==10);
+
+    /*full: the least recently used entry (2) makes room*/
+    CHECK(dll_lru_put(lru, 3, 30)==DLL_SUCCESS);
+    CHECK(evictions.count==1&&evictions.key==2&&evictions.value==20);
+    CHECK(dll_lru_get(lru, 2, &value)==DLL_DATA_MISSING);
+
+    /*touch and update change the order without evicting*/
+    CHECK(dll_lru_touch(lru, 1)==DLL_SUCCESS);
+    CHECK(dll_lru_put(lru, 3, 31)==DLL_SUCCESS);
+    CHECK(evictions.count==1);
+    CHECK(dll_lru_put(lru, 4, 40)==DLL_SUCCESS);
+    CHECK(evictions.count==2&&evictions.key==1&&evictions.value==10);
+    CHECK(dll_lru_get(lru, 3, &value)==DLL_SUCCESS&&value==31);
+
+    /*a removed entry frees its node without a callback*/
+    CHECK(dll_lru_remove(lru, 4)==DLL_SUCCESS);
+    CHECK(dll_lru_remove(lru, 4)==DLL_DATA_MISSING);
+    CHECK(dll_lru_touch(lru, 4)==DLL_DATA_MISSING);
+    CHECK(dll_lru_put(lru, 5, 50)==DLL_SUCCESS);
+    CHECK(evictions.count==2&&lru->count==2);
+
+    /*many keys through a small cache*/
+    for(key=100; key<1100; key++)
+         CHECK(dll_lru_put(lru, key, key*2)==DLL_SUCCESS);
+    CHECK(dll_lru_get(lru, 1099, &value)==DLL_SUCCESS&&value==2198);
+    CHECK(dll_lru_get(lru, 1098, &value)==DLL_SUCCESS&&value==2196);
+    CHECK(dll_lru_get(lru, 1097, &value)==DLL_DATA_MISSING);
+    CHECK(evictions.count==1002);
+
+    CHECK(dll_lru_stats(lru, &hits, &misses, &evicted)==DLL_SUCCESS);
+    CHECK(hits==4&&misses==3&&evicted==1002);
+
+    CHECK(dll_lru_get(lru, 1, NULL)==DLL_NULL_PTR);
+    CHECK(dll_lru_destroy(lru)==DLL_SUCCESS);
+    CHECK(dll_lru_destroy(NULL)==DLL_NULL_PTR);
+}
+
+
+void test_simd(void)
+{
+    uint32_t values[70], indices[70], count, match, index, found, matches;
+    int ok=1;
+
+    CHECK(dll_simd_active()<=DLL_SIMD_AVX2);
+
+    /*every length up to past two AVX2 vectors, with the match at every index
+     *so that the vector body and the scalar tail are both covered*/
+    for(count=0; count<=70; count++)
+    {
+         for(index=0; index<count; index++)
+              values[index]=index+1;
+         ok=ok&&dll_simd_find(values, count, 0, &found)==DLL_DATA_MISSING;
+         ok=ok&&dll_simd_count(values, count, 0, &matches)==DLL_SUCCESS&&matches==0;
+
+         for(match=0; match<count; match++)
+         {
+              values[match]=0;
+              ok=ok&&dll_simd_find(values, count, 0, &found)==DLL_SUCCESS&&found==match;
+              values[match]=match+1;
+         }
+
+         /*every third value matches*/
+         for(index=0; index<count; index+=3)
+              values[index]=0;
+         ok=ok&&dll_simd_count(values, count, 0, &matches)==DLL_SUCCESS&&matches==(count+2)/3;
+         ok=ok&&dll_simd_find_all(values, count, 0, indices, 70, &matches)==DLL_SUCCESS&&
+            matches==(count+2)/3;
+         for(index=0; index<matches; index++)
+              ok=ok&&indices[index]==3*index;
+         ok=ok&&dll_simd_find_all(values, count, 0, indices, 1, &matches)==DLL_SUCCESS&&
+            matches==(count+2)/3;
+    }
+    CHECK(ok);
+
+    CHECK(dll_simd_find(values, 4, 0, NULL)==DLL_NULL_PTR);
+    CHECK(dll_simd_count(NULL, 4, 0, &matches)==DLL_NULL_PTR);
+    CHECK(dll_simd_find_all(values, 4, 0, NULL, 0, &matches)==DLL_SUCCESS);
+}
+
+
+typedef struct test_item
+{
+    uint32_t value;
+    dll_link link;
+}test_item;
+
+void test_intrusive(void)
+{
+    test_item items[4];
+    dll_link head, *pos, *tmp;
+    uint32_t index, order[4], count=0;
+
+    CHECK(dll_link_init(&head)==DLL_SUCCESS);
+    CHECK(dll_link_empty(&head));
+    CHECK(dll_link_first(&head)==NULL&&dll_link_last(&head)==NULL);
+
+    for(index=0; index<4; index++)
+    {
+         items[index].value=index;
+         CHECK(dll_link_init(&items[index].link)==DLL_SUCCESS);
+    }
+
+    /*build 1 0 3 2 through every insert*/
+    CHECK(dll_link_push_back(&head, &items[0].link)==DLL_SUCCESS);
+    CHECK(dll_link_push_front(&head, &items[1].link)==DLL_SUCCESS);
+    CHECK(dll_link_push_back(&head, &items[2].link)==DLL_SUCCESS);
+    CHECK(dll_link_insert_before(&items[2].link, &items[3].link)==DLL_SUCCESS);
+    DLL_LINK_FOR_EACH(pos, &head)
+         if(count<4)
+              order[count++]=DLL_CONTAINER_OF(pos, test_item, link)->value;
+    CHECK(count==4&&order[0]==1&&order[1]==0&&order[2]==3&&order[3]==2);
+
+    /*the ends, and walking off them*/
+    CHECK(dll_link_first(&head)==&items[1].link&&dll_link_last(&head)==&items[2].link);
+    CHECK(dll_link_prev(&head, &items[1].link)==NULL&&dll_link_next(&head, &items[2].link)==NULL);
+    CHECK(dll_link_next(&head, &items[0].link)==&items[3].link);
+
+    /*an unlinked element points to itself*/
+    CHECK(dll_link_unlink(&items[0].link)==DLL_SUCCESS);
+    CHECK(items[0].link.next_ptr==&items[0].link&&dll_link_next(&head, &items[1].link)==&items[3].link);
+    CHECK(dll_link_insert_after(&items[3].link, &items[0].link)==DLL_SUCCESS);
+    CHECK(dll_link_prev(&head, &items[2].link)==&items[0].link);
+
+    count=0;
+    DLL_LINK_FOR_EACH_SAFE(pos, tmp, &head)
+    {
+         dll_link_unlink(pos);
+         count++;
+    }
+    CHECK(count==4&&dll_link_empty(&head));
+
+    CHECK(dll_link_init(NULL)==DLL_NULL_PTR);
+    CHECK(dll_link_push_back(&head, NULL)==DLL_NULL_PTR);
+    CHECK(dll_link_unlink(NULL)==DLL_NULL_PTR);
+}
+
+
+typedef struct test_conc_args
+{
+    dll_conc_ptr list;
+    uint32_t seed;
+    _Atomic int32_t *balance;
+    _Atomic int *done;
+    int ok;
+}test_conc_args;
+
+/*
+ * Function:     test_conc_writer(void* arg)
+ * -----------------------------------------------------------------------------
+ * Description:  Adds, removes by position and by value and searches random
+ *               values on the shared list, and keeps the number of adds less
+ *               removes of every value in balance. Positions may be stale by
+ *               the time they are used, so DLL_BAD_POSITION and
+ *               DLL_DATA_MISSING are expected; ok is cleared on any other
+ *               failure.
+ * ----------------------------------------------------------------------------
+ */
+static void* test_conc_writer(void* arg)
+{
+    test_conc_args *args=(test_conc_args*)arg;
+    uint32_t op, data, position, size, found;
+    dll_code status;
+
+    for(op=0; op<TEST_CONC_OPS; op++)
+    {
+         data=test_random(&args->seed)%TEST_CONC_VALUES;
+         dll_conc_size(args->list, &size);
+         position=test_random(&args->seed)%(size+1);
+
+         switch(test_random(&args->seed)%5)
+         {
+              case 0:
+              case 1:
+                   if(size>=TEST_MODEL_SIZE)
+                        break;
+                   status=dll_conc_add_node(args->list, position, data);
+                   if(status==DLL_SUCCESS)
+                        atomic_fetch_add(&args->balance[data], 1);
+                   args->ok&=(status==DLL_SUCCESS||status==DLL_BAD_POSITION);
+                   break;
+              case 2:
+                   status=dll_conc_remove_node(args->list, position, &found);
+                   if(status==DLL_SUCCESS)
+                   {
+                        args->ok&=(found<TEST_CONC_VALUES);
+                        atomic_fetch_sub(&args->balance[found%TEST_CONC_VALUES], 1);
+                   }
+                   args->ok&=(status==DLL_SUCCESS||status==DLL_BAD_POSITION);
+                   break;
+              case 3:
+                   status=dll_conc_remove_value(args->list, data);
+                   if(status==DLL_SUCCESS)
+                        atomic_fetch_sub(&args->balance[data], 1);
+                   args->ok&=(status==DLL_SUCCESS||status==DLL_DATA_MISSING);
+                   break;
+              default:
+                   status=dll_conc_search(args->list, data, &found);
+                   args->ok&=(status==DLL_SUCCESS||status==DLL_DATA_MISSING);
+                   break;
+         }
+    }
+
+    return NULL;
+}
+
+/*
+ * Function:     test_conc_reader(void* arg)
+ * -----------------------------------------------------------------------------
+ * Description:  Searches random values until the writers are done, so the
+ *               writers always meet read locks on their way; they must still
+ *               get through.
+ * ----------------------------------------------------------------------------
+ */
+static void* test_conc_reader(void* arg)
+{
+    test_conc_args *args=(test_conc_args*)arg;
+    uint32_t position;
+    dll_code status;
+
+    while(!atomic_load(args->done))
+    {
+         status=dll_conc_search(args->list, test_random(&args->seed)%TEST_CONC_VALUES, &position);
+         args->ok&=(status==DLL_SUCCESS||status==DLL_DATA_MISSING);
+    }
+
+    return NULL;
+}
+
+/*
+ * Function:     test_conc_matches(dll_conc_ptr list, _Atomic int32_t* balance)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns 1 if the links of the quiet list agree in both
+ *               directions, its count is the number of nodes and it holds
+ *               balance[value] nodes of every value.
+ * ----------------------------------------------------------------------------
+ */
+static int test_conc_matches(dll_conc_ptr list, _Atomic int32_t* balance)
+{
+    dll_conc_node_ptr node, prev=NULL;
+    int32_t left[TEST_CONC_VALUES];
+    uint32_t value, count=0, size;
+
+    for(value=0; value<TEST_CONC_VALUES; value++)
+         left[value]=atomic_load(&balance[value]);
+
+    for(node=list->head.next_ptr; node!=NULL; prev=node, node=node->next_ptr)
+    {
+         if(node->prev_ptr!=prev||node->data>=TEST_CONC_VALUES)
+              return 0;
+         left[node->data]--;
+         count++;
+    }
+
+    for(value=0; value<TEST_CONC_VALUES; value++)
+         if(left[value]!=0)
+              return 0;
+
+    return dll_conc_size(list, &size)==DLL_SUCCESS&&size==count;
+}
+
+void test_conc(void)
+{
+    uint32_t model[TEST_MODEL_SIZE+1], size=0, op, data, position, found, seed=6u;
+    dll_conc_ptr list;
+    dll_code status;
+    int ok=1;
+
+    CHECK(dll_conc_init(&list)==DLL_SUCCESS);
+    CHECK(dll_conc_remove_node(list, 0, &data)==DLL_BAD_POSITION);
+    CHECK(dll_conc_remove_value(list, 1)==DLL_DATA_MISSING);
+
+    /*on one thread it behaves like the plain list*/
+    for(op=0; op<TEST_MODEL_OPS&&ok; op++)
+    {
+         data=test_random(&seed)%32;
+
+         switch(test_random(&seed)%4)
+         {
+              case 0:
+              case 1:
+                   if(size==TEST_MODEL_SIZE)
+                        break;
+                   position=test_random(&seed)%(size+1);
+                   ok=(dll_conc_add_node(list, position, data)==DLL_SUCCESS);
+                   test_model_insert(model, &size, position, data);
+                   break;
+              case 2:
+                   if(size==0)
+                        break;
+                   position=test_random(&seed)%size;
+                   ok=(dll_conc_remove_node(list, position, &found)==DLL_SUCCESS&&
+                       found==test_model_remove(model, &size, position));
+                   break;
+              default:
+                   position=test_model_search(model, size, data);
+                   status=dll_conc_remove_value(list, data);
+                   if(position==size)
+                        ok=(status==DLL_DATA_MISSING);
+                   else
+                   {
+                        ok=(status==DLL_SUCCESS);
+                        test_model_remove(model, &size, position);
+                   }
+                   break;
+         }
+
+         position=test_model_search(model, size, data);
+         ok=ok&&((position==size)? dll_conc_search(list, data, &found)==DLL_DATA_MISSING:
+                                   dll_conc_search(list, data, &found)==DLL_SUCCESS&&found==position);
+         ok=ok&&dll_conc_size(list, &found)==DLL_SUCCESS&&found==size;
+    }
+    CHECK(ok);
+    CHECK(dll_conc_add_node(list, size+1, 0)==DLL_BAD_POSITION);
+    CHECK(dll_conc_remove_node(list, size, &found)==DLL_BAD_POSITION);
+
+    CHECK(dll_conc_destroy(list)==DLL_SUCCESS);
+
+    /*writers and readers at once; the list that is left is well linked and
+     *holds what was added and not removed*/
+    {
+         pthread_t threads[TEST_CONC_WRITERS+TEST_CONC_READERS];
+         test_conc_args args[TEST_CONC_WRITERS+TEST_CONC_READERS];
+         _Atomic int32_t balance[TEST_CONC_VALUES];
+         _Atomic int done=0;
+         uint32_t index;
+
+         for(index=0; index<TEST_CONC_VALUES; index++)
+              atomic_init(&balance[index], 0);
+
+         CHECK(dll_conc_init(&list)==DLL_SUCCESS);
+         for(index=0; index<TEST_CONC_WRITERS+TEST_CONC_READERS; index++)
+         {
+              args[index].list=list;
+              args[index].seed=7u+index*2654435761u;
+              args[index].balance=balance;
+              args[index].done=&done;
+              args[index].ok=1;
+              CHECK(pthread_create(&threads[index], NULL, (index<TEST_CONC_WRITERS)? test_conc_writer:
+                                   test_conc_reader, &args[index])==0);
+         }
+         for(index=0; index<TEST_CONC_WRITERS; index++)
+              pthread_join(threads[index], NULL);
+         atomic_store(&done, 1);
+         for(index=TEST_CONC_WRITERS; index<TEST_CONC_WRITERS+TEST_CONC_READERS; index++)
+              pthread_join(threads[index], NULL);
+
+         for(index=0; index<TEST_CONC_WRITERS+TEST_CONC_READERS; index++)
+              CHECK(args[index].ok);
+         CHECK(test_conc_matches(list, balance));
+         CHECK(dll_conc_destroy(list)==DLL_SUCCESS);
+    }
+
+    CHECK(dll_conc_init(NULL)==DLL_NULL_PTR);
+    CHECK(dll_conc_size(NULL, &found)==DLL_NULL_PTR);
+}
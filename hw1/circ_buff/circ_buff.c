@@ -10,27 +10,316 @@
  * */
 
 
+/*memfd_create is a GNU extension*/
+#define _GNU_SOURCE
+
 #include "circ_buff.h"
+#include "circ_buff_stats.h"
+#include "circ_buff_file.h"
 #include<stdint.h>
 #include<stdlib.h>
 #include<stdio.h>
 #include<inttypes.h>
+#include<string.h>
+#include<unistd.h>
+#include<errno.h>
+#include<sys/mman.h>
+#include<sys/uio.h>
+#include<stdatomic.h>
+
+
+/*
+ * Function:     circ_buff_advance(circ_buff_ptr circ_buff_pointer, uint32_t* ptr, uint32_t count)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns ptr (the head or the tail of the buffer) moved forward
+ *               by count elements circularly. count must not exceed total_size.
+ * ----------------------------------------------------------------------------
+ */
+static uint32_t* circ_buff_advance(circ_buff_ptr circ_buff_pointer, uint32_t* ptr, uint32_t count)
+{
+    uint32_t total_buff_size=circ_buff_pointer->total_size;
+    uint32_t index=(ptr-circ_buff_pointer->base)+count;
+    
+    if(index>=total_buff_size)
+	 index-=total_buff_size;
+    
+    return circ_buff_pointer->base+index;
+}
+
+/*
+ * Function:     circ_buff_map_mirror(size_t bytes)
+ * -----------------------------------------------------------------------------
+ * Description:  Maps the same 'bytes' long memfd twice back to back and
+ *               returns the start of the first mapping, or NULL on failure.
+ *               bytes must be a multiple of the page size. Whatever is
+ *               written at base+i is also visible at base+bytes+i, so a
+ *               region starting anywhere in the first mapping is contiguous
+ *               for up to bytes.
+ * ----------------------------------------------------------------------------
+ */
+static uint32_t* circ_buff_map_mirror(size_t bytes)
+{
+    uint8_t *area, *first, *second;
+    int fd=memfd_create("circ_buff", MFD_CLOEXEC);
+
+    if(fd<0)
+	 return NULL;
+
+    if(ftruncate(fd, (off_t)bytes)!=0)
+    {
+	 close(fd);
+	 return NULL;
+    }
+
+    /*reserve an address range for both copies first*/
+    area=(uint8_t*)mmap(NULL, 2*bytes, PROT_NONE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if(area==MAP_FAILED)
+    {
+	 close(fd);
+	 return NULL;
+    }
+
+    /*map the file over each half of the reserved range*/
+    first=(uint8_t*)mmap(area, bytes, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_FIXED, fd, 0);
+    second=(uint8_t*)mmap(area+bytes, bytes, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_FIXED, fd, 0);
+
+    /*the mappings keep the memory alive; the descriptor is not needed anymore*/
+    close(fd);
+
+    if(first!=area||second!=area+bytes)
+    {
+	 munmap(area, 2*bytes);
+	 return NULL;
+    }
+
+    return (uint32_t*)area;
+}
+
+/*
+ * Function:     circ_buff_write_all(int fd, struct iovec* iov, int iovcnt)
+ * -----------------------------------------------------------------------------
+ * Description:  Writes all of iov to fd with writev, picking up after short
+ *               writes and EINTR. Returns 0 on success and -1 on failure.
+ * ----------------------------------------------------------------------------
+ */
+static int circ_buff_write_all(int fd, struct iovec* iov, int iovcnt)
+{
+    while(iovcnt>0)
+    {
+	 ssize_t done=writev(fd, iov, iovcnt);
+	 
+	 if(done<0)
+	 {
+	      if(errno==EINTR)
+		   continue;
+	      return -1;
+	 }
+
+	 /*skip the pieces written completely, trim the one written partly*/
+	 while(iovcnt>0&&(size_t)done>=iov->iov_len)
+	 {
+	      done-=iov->iov_len;
+	      iov++;
+	      iovcnt--;
+	 }
+	 if(iovcnt>0)
+	 {
+	      iov->iov_base=(uint8_t*)iov->iov_base+done;
+	      iov->iov_len-=done;
+	 }
+    }
+
+    return 0;
+}
+
+/*
+ * Function:     circ_buff_u32_to_text(uint32_t value, char* out)
+ * -----------------------------------------------------------------------------
+ * Description:  Writes value in decimal at out and returns the position after
+ *               the last digit. Two digits are produced per division using a
+ *               table of the 100 two digit pairs.
+ * ----------------------------------------------------------------------------
+ */
+static char* circ_buff_u32_to_text(uint32_t value, char* out)
+{
+    static const char pairs[201]=
+         "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+         "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+         "8081828384858687888990919293949596979899";
+    char digits[10];
+    char* p=digits+10;
+    size_t length;
+
+    while(value>=100)
+    {
+	 uint32_t pair=(value%100)*2;
+	 value/=100;
+	 *--p=pairs[pair+1];
+	 *--p=pairs[pair];
+    }
+    if(value>=10)
+    {
+	 *--p=pairs[value*2+1];
+	 *--p=pairs[value*2];
+    }
+    else
+	 *--p=(char)('0'+value);
 
+    length=(size_t)(digits+10-p);
+    memcpy(out, p, length);
+    return out+length;
+}
 
+/*
+ * Function:     circ_buff_contiguous(circ_buff_ptr circ_buff_pointer, uint32_t index)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns how many elements can be accessed contiguously from
+ *               base+index before the end of base. In the mirrored mode the
+ *               whole buffer is always contiguous.
+ * ----------------------------------------------------------------------------
+ */
+static inline uint32_t circ_buff_contiguous(circ_buff_ptr circ_buff_pointer, uint32_t index)
+{
+    if(circ_buff_pointer->mode&CIRC_BUFF_MODE_VMIRROR)
+	 return circ_buff_pointer->total_size;
+    else
+	 return circ_buff_pointer->total_size-index;
+}
+
+/*
+ * Function:     circ_buff_used(circ_buff_ptr circ_buff_pointer)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the number of elements in the buffer. In the power of
+ *               two mode this is derived from the free running counters.
+ * ----------------------------------------------------------------------------
+ */
+static inline uint32_t circ_buff_used(circ_buff_ptr circ_buff_pointer)
+{
+    if(circ_buff_pointer->mode&CIRC_BUFF_MODE_POW2)
+	 return circ_buff_pointer->tail_count-circ_buff_pointer->head_count;
+    else
+	 return circ_buff_pointer->size_occupied;
+}
+
+/*
+ * Function:     circ_buff_head_index(circ_buff_ptr circ_buff_pointer)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the offset of the head element from base.
+ * ----------------------------------------------------------------------------
+ */
+static inline uint32_t circ_buff_head_index(circ_buff_ptr circ_buff_pointer)
+{
+    if(circ_buff_pointer->mode&CIRC_BUFF_MODE_POW2)
+	 return circ_buff_pointer->head_count&circ_buff_pointer->mask;
+    else
+	 return circ_buff_pointer->head-circ_buff_pointer->base;
+}
+
+/*
+ * Function:     circ_buff_tail_index(circ_buff_ptr circ_buff_pointer)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the offset of the next free slot from base.
+ * ----------------------------------------------------------------------------
+ */
+static inline uint32_t circ_buff_tail_index(circ_buff_ptr circ_buff_pointer)
+{
+    if(circ_buff_pointer->mode&CIRC_BUFF_MODE_POW2)
+	 return circ_buff_pointer->tail_count&circ_buff_pointer->mask;
+    else
+	 return circ_buff_pointer->tail-circ_buff_pointer->base;
+}
+
+/*
+ * Function:     circ_buff_file_move_head(circ_buff_ptr circ_buff_pointer, uint32_t count)
+ * -----------------------------------------------------------------------------
+ * Description:  Moves the head counter in the header of a file backed buffer
+ *               forward by count; does nothing for other buffers. Called
+ *               after the elements were read, so the file never shows a slot
+ *               as free before its data was taken.
+ * ----------------------------------------------------------------------------
+ */
+static inline void circ_buff_file_move_head(circ_buff_ptr circ_buff_pointer, uint32_t count)
+{
+    if(circ_buff_pointer->file!=NULL)
+    {
+	 circ_buff_file_header *header=circ_buff_pointer->file->header;
+	 atomic_store_explicit(&header->head_count,
+			       atomic_load_explicit(&header->head_count, memory_order_relaxed)+count,
+			       memory_order_release);
+    }
+}
+
+/*
+ * Function:     circ_buff_file_move_tail(circ_buff_ptr circ_buff_pointer, uint32_t count)
+ * -----------------------------------------------------------------------------
+ * Description:  Moves the tail counter in the header of a file backed buffer
+ *               forward by count; does nothing for other buffers. The release
+ *               store orders it after the data it publishes, so the file
+ *               never shows an element that was not written yet.
+ * ----------------------------------------------------------------------------
+ */
+static inline void circ_buff_file_move_tail(circ_buff_ptr circ_buff_pointer, uint32_t count)
+{
+    if(circ_buff_pointer->file!=NULL)
+    {
+	 circ_buff_file_header *header=circ_buff_pointer->file->header;
+	 atomic_store_explicit(&header->tail_count,
+			       atomic_load_explicit(&header->tail_count, memory_order_relaxed)+count,
+			       memory_order_release);
+    }
+}
+
+/*
+ * Function:     circ_buff_move_head(circ_buff_ptr circ_buff_pointer, uint32_t count)
+ * -----------------------------------------------------------------------------
+ * Description:  Drops count elements from the head. count must not exceed the
+ *               number of elements in the buffer.
+ * ----------------------------------------------------------------------------
+ */
+static inline void circ_buff_move_head(circ_buff_ptr circ_buff_pointer, uint32_t count)
+{
+    if(circ_buff_pointer->mode&CIRC_BUFF_MODE_POW2)
+	 circ_buff_pointer->head_count+=count;
+    else
+    {
+	 circ_buff_pointer->head=circ_buff_advance(circ_buff_pointer, circ_buff_pointer->head, count);
+	 circ_buff_pointer->size_occupied-=count;
+    }
+    circ_buff_file_move_head(circ_buff_pointer, count);
+}
+
+/*
+ * Function:     circ_buff_move_tail(circ_buff_ptr circ_buff_pointer, uint32_t count)
+ * -----------------------------------------------------------------------------
+ * Description:  Publishes count elements written at the tail. count must not
+ *               exceed the free space in the buffer.
+ * ----------------------------------------------------------------------------
+ */
+static inline void circ_buff_move_tail(circ_buff_ptr circ_buff_pointer, uint32_t count)
+{
+    if(circ_buff_pointer->mode&CIRC_BUFF_MODE_POW2)
+	 circ_buff_pointer->tail_count+=count;
+    else
+    {
+	 circ_buff_pointer->tail=circ_buff_advance(circ_buff_pointer, circ_buff_pointer->tail, count);
+	 circ_buff_pointer->size_occupied+=count;
+    }
+    circ_buff_file_move_tail(circ_buff_pointer, count);
+}
 
 
 /*								                
  * Function:     circ_buff_init(circ_buff_ptr* circ_buff_pointer, int16_t size)
  * -----------------------------------------------------------------------------
- * Description:  Assigns memory specified by 'size' to the circular buffer 
- *               structure pointed to by the pointer argument on the heap. 
+ * Description:  Assigns memory for 'size' uint32_t elements to the circular
+ *               buffer structure pointed to by the pointer argument on the heap. 
  *               Also initialises various parameters to this buffer, like the 
  *               head, tail, total size, and size_occupied, etc.  
  *              
  *           
  * Usage:        Pass a pointer to the ptr of the circular buffer struc which 
- *               needs to be allocated memory on the heap, and a uin32_t type 
- *               specifying the size in that order.
+ *               needs to be allocated memory on the heap, and an int32_t type 
+ *               specifying the number of elements in that order.
  * 
  * Returns:      Error codes:
  *               CIRC_BUFF_NULL_POINTER: The pointer passed is detected to be a 
@@ -44,28 +333,124 @@
  *               CIRC_BUFF_SUCCESS: The funcion returns successfully.
  */
 circ_buff_code circ_buff_init(circ_buff_ptr* circ_buff_pointer, int32_t size)
+{
+    return circ_buff_init_mode(circ_buff_pointer, size, CIRC_BUFF_MODE_DEFAULT);
+}
+
+
+/*								                
+ * Function:     circ_buff_init_mode(circ_buff_ptr* circ_buff_pointer, int32_t size,
+ *                                   uint32_t mode)
+ * -----------------------------------------------------------------------------
+ * Description:  Same as circ_buff_init, but selects the mode the buffer runs
+ *               in. mode is CIRC_BUFF_MODE_DEFAULT or an or of the 
+ *               CIRC_BUFF_MODE_* flags:
+ *
+ *               CIRC_BUFF_MODE_POW2: 'size' is rounded up to a power of two 
+ *               and head/tail are kept as free running 32 bit counters 
+ *               (head_count, tail_count). The slot of a counter is 
+ *               counter&mask and the occupancy is tail_count-head_count, so
+ *               the head/tail pointers and size_occupied are not maintained
+ *               and the read/write paths have no wraparound branch.
+ *
+ *               CIRC_BUFF_MODE_VMIRROR: 'size' is rounded up to whole pages 
+ *               and the data region is a memfd mapped twice back to back, so
+ *               base[total_size+i] is base[i]. Batch copies never split at 
+ *               the wrap point, and reserve/peek always hand out all of the
+ *               free/occupied space as one region (which can be passed
+ *               straight to write(2)/writev).
+ *
+ *               CIRC_BUFF_MODE_OVERWRITE: writes to a full buffer always
+ *               succeed; the oldest elements are dropped to make room (head
+ *               is moved forward) and counted in 'dropped', so the buffer
+ *               keeps the newest total_size elements like a flight recorder.
+ *           
+ * Usage:        Pass a pointer to the ptr of the circular buffer struc, the 
+ *               number of elements and the mode in that order.
+ * 
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_POINTER: The pointer passed is detected to be a 
+ *               null. The function halts execution and returns w/o completion.   
+ *                  
+ *               CIRC_BUFF_BAD_DATA: The size parameter is less than or equal 
+ *               to zero, or mode has unknown flags set.
+ *               
+ *               CIRC_BUFF_MALLOC_FAIL: The call to malloc, or setting up the
+ *               mirrored mapping, fails.
+ *
+ *               CIRC_BUFF_SUCCESS: The funcion returns successfully.
+ */
+circ_buff_code circ_buff_init_mode(circ_buff_ptr* circ_buff_pointer, int32_t size, uint32_t mode)
 {
     /*check if the pointer is NULLi*/
     if(circ_buff_pointer==NULL)                                                 
          return CIRC_BUFF_NULL_PTR;   
 
+    /*a buffer needs room for at least one element; reject unknown modes*/
+    if(size<=0||(mode&~CIRC_BUFF_MODE_ALL)!=0)
+         return CIRC_BUFF_BAD_DATA;
+
+    uint32_t total_buff_size=(uint32_t)size;
+
+    /*round the size up to a power of two so wraparound is a mask*/
+    if(mode&CIRC_BUFF_MODE_POW2)
+    {
+         uint32_t rounded=1;
+         while(rounded<total_buff_size)
+              rounded<<=1;
+         total_buff_size=rounded;
+    }
+
+    /*the mirrored mapping is made of whole pages; pages are a power of two, so
+     *a power of two size stays one*/
+    if(mode&CIRC_BUFF_MODE_VMIRROR)
+    {
+         uint32_t page_elements=(uint32_t)sysconf(_SC_PAGESIZE)/sizeof(uint32_t);
+         total_buff_size=(total_buff_size+page_elements-1)/page_elements*page_elements;
+    }
+
     /*assign the circ buff struct on the heap*/
     *(circ_buff_pointer)=(circ_buff_ptr)malloc(sizeof(circ_buff));
     if((*circ_buff_pointer)==NULL)
          return CIRC_BUFF_MALLOC_FAIL;
 
     /*access the buff pointer and allocate memory on the heap*/ 
-    (*circ_buff_pointer)->base=(uint32_t*)malloc(size);                             
+    if(mode&CIRC_BUFF_MODE_VMIRROR)
+         (*circ_buff_pointer)->base=circ_buff_map_mirror((size_t)total_buff_size*sizeof(uint32_t));
+    else
+         (*circ_buff_pointer)->base=(uint32_t*)malloc((size_t)total_buff_size*sizeof(uint32_t));                             
     if((*circ_buff_pointer)->base==NULL)
+    {
+         free(*circ_buff_pointer);
          return CIRC_BUFF_MALLOC_FAIL;
+    }
 
     /*Initialise total and current size to the allocated memory*/
     (*circ_buff_pointer)->size_occupied=0;             
-    (*circ_buff_pointer)->total_size=size;
+    (*circ_buff_pointer)->total_size=total_buff_size;
+    (*circ_buff_pointer)->mode=mode;
+    (*circ_buff_pointer)->mask=(mode&CIRC_BUFF_MODE_POW2)? total_buff_size-1: 0;
+    (*circ_buff_pointer)->head_count=0;
+    (*circ_buff_pointer)->tail_count=0;
+    (*circ_buff_pointer)->dropped=0;
+    (*circ_buff_pointer)->file=NULL;
+    (*circ_buff_pointer)->stats=NULL;
     
     /*Initialise the head and tail positions to base*/
     (*circ_buff_pointer)->head=(*circ_buff_pointer)->base;                        
     (*circ_buff_pointer)->tail=(*circ_buff_pointer)->base;   
+
+#ifdef CIRC_BUFF_STATS
+    if(circ_buff_stats_init(&(*circ_buff_pointer)->stats, total_buff_size)!=CIRC_BUFF_SUCCESS)
+    {
+         if(mode&CIRC_BUFF_MODE_VMIRROR)
+              munmap((*circ_buff_pointer)->base, 2*(size_t)total_buff_size*sizeof(uint32_t));
+         else
+              free((*circ_buff_pointer)->base);
+         free(*circ_buff_pointer);
+         return CIRC_BUFF_MALLOC_FAIL;
+    }
+#endif
     
     /*return successfully*/
     return CIRC_BUFF_SUCCESS;                          
@@ -97,8 +482,20 @@ circ_buff_code circ_buff_destroy(circ_buff_ptr circ_buff_pointer)
     if(circ_buff_pointer==NULL)
 	 return CIRC_BUFF_NULL_PTR;
     
-    /*free the memory of the buffer on the heap*/
-    free(circ_buff_pointer->base);
+    /*free the memory of the buffer on the heap, or unmap both copies, or
+     *checkpoint and unmap the file*/
+    if(circ_buff_pointer->file!=NULL)
+	 circ_buff_pointer->file->close(circ_buff_pointer);
+    else if(circ_buff_pointer->mode&CIRC_BUFF_MODE_VMIRROR)
+	 munmap(circ_buff_pointer->base, 2*(size_t)circ_buff_pointer->total_size*sizeof(uint32_t));
+    else
+	 free(circ_buff_pointer->base);
+
+#ifdef CIRC_BUFF_STATS
+    /*stats is only ever allocated in a stats build*/
+    if(circ_buff_pointer->stats!=NULL)
+	 circ_buff_stats_destroy(circ_buff_pointer->stats);
+#endif
 
     /*Reassign all the parameters to 0*/
     circ_buff_pointer->size_occupied=0;             
@@ -139,7 +536,7 @@ circ_buff_code if_circ_buff_full(circ_buff_ptr circ_buff_pointer)
 	 return CIRC_BUFF_NULL_PTR;
 
     /*collect total and current size values of the buffer in a local variables*/ 
-    uint32_t current_buff_size=circ_buff_pointer->size_occupied, total_buff_size= circ_buff_pointer->total_size;
+    uint32_t current_buff_size=circ_buff_used(circ_buff_pointer), total_buff_size= circ_buff_pointer->total_size;
     
     /*check if the buffer is full*/
     if(current_buff_size ==total_buff_size)
@@ -172,7 +569,7 @@ circ_buff_code if_circ_buff_empty(circ_buff_ptr circ_buff_pointer)
 	 return CIRC_BUFF_NULL_PTR;
 
     /*read current buffer size*/
-    uint32_t current_buff_size=circ_buff_pointer->size_occupied;  
+    uint32_t current_buff_size=circ_buff_used(circ_buff_pointer);  
     
     /*check if the buffer is emptry*/
     if(current_buff_size ==0)
@@ -197,7 +594,9 @@ circ_buff_code if_circ_buff_empty(circ_buff_ptr circ_buff_pointer)
  *               returns.
  *
  *               CIRC_BUFF_FULL: The buffer is currently full and thus new
- *               data can not be written to it.
+ *               data can not be written to it. Never returned in 
+ *               CIRC_BUFF_MODE_OVERWRITE, where the oldest element is dropped
+ *               instead.
  *
  *               CIRC_BUFF_SUCCESS: The function completes execution 
  *               successfully.   
@@ -209,26 +608,66 @@ circ_buff_code circ_buff_write(circ_buff_ptr circ_buff_pointer, uint32_t data)
     if(circ_buff_pointer==NULL)
 	 return CIRC_BUFF_NULL_PTR;
     
+    /*power of two mode: occupancy is tail-head and the slot is a mask*/
+    if(circ_buff_pointer->mode&CIRC_BUFF_MODE_POW2)
+    {
+	 uint32_t tail=circ_buff_pointer->tail_count;
+
+	 if(tail-circ_buff_pointer->head_count==circ_buff_pointer->total_size)
+	 {
+	      if(!(circ_buff_pointer->mode&CIRC_BUFF_MODE_OVERWRITE))
+	      {
+		   CIRC_BUFF_STATS_FULL(circ_buff_pointer);
+		   return CIRC_BUFF_FULL;
+	      }
+
+	      /*flight recorder: drop the oldest element to make room*/
+	      circ_buff_pointer->head_count++;
+	      circ_buff_pointer->dropped++;
+	      circ_buff_file_move_head(circ_buff_pointer, 1);
+	 }
+
+	 circ_buff_pointer->base[tail&circ_buff_pointer->mask]=data;
+	 circ_buff_pointer->tail_count=tail+1;
+	 circ_buff_file_move_tail(circ_buff_pointer, 1);
+	 CIRC_BUFF_STATS_WRITE(circ_buff_pointer, tail&circ_buff_pointer->mask, 1,
+			       tail+1-circ_buff_pointer->head_count);
+	 return CIRC_BUFF_SUCCESS;
+    }
+
     /*call if_circ_buff_full to check if a write is feasible at all*/
     circ_buff_code if_write_ok=if_circ_buff_full(circ_buff_pointer);
     
     if(if_write_ok!=CIRC_BUFF_CAN_WRITE)
-	 return CIRC_BUFF_FULL;
+    {
+	 if(!(circ_buff_pointer->mode&CIRC_BUFF_MODE_OVERWRITE))
+	 {
+	      CIRC_BUFF_STATS_FULL(circ_buff_pointer);
+	      return CIRC_BUFF_FULL;
+	 }
+
+	 /*flight recorder: drop the oldest element to make room*/
+	 circ_buff_move_head(circ_buff_pointer, 1);
+	 circ_buff_pointer->dropped++;
+    }
 
     /*collect total size in a variable*/
     uint32_t total_buff_size= circ_buff_pointer->total_size;
     
     /*grab the tail and write to it*/
     *(circ_buff_pointer->tail)=data;  
+    CIRC_BUFF_STATS_WRITE(circ_buff_pointer, circ_buff_pointer->tail-circ_buff_pointer->base, 1,
+			  circ_buff_pointer->size_occupied+1);
     
     /*update tail circularly*/
-    if((circ_buff_pointer->tail-circ_buff_pointer->base)!=total_buff_size)
+    if((circ_buff_pointer->tail-circ_buff_pointer->base)!=total_buff_size-1)
          circ_buff_pointer->tail++;           
     else
 	 circ_buff_pointer->tail=circ_buff_pointer->base;
 
     /*update the size occupied by the buffer*/
     circ_buff_pointer->size_occupied++;
+    circ_buff_file_move_tail(circ_buff_pointer, 1);
     
     /*return successfully*/
     return CIRC_BUFF_SUCCESS;
@@ -263,32 +702,511 @@ circ_buff_code circ_buff_read(circ_buff_ptr circ_buff_pointer, uint32_t* data)
     if(circ_buff_pointer==NULL||data==NULL)
 	 return CIRC_BUFF_NULL_PTR;
 
+    /*power of two mode: occupancy is tail-head and the slot is a mask*/
+    if(circ_buff_pointer->mode&CIRC_BUFF_MODE_POW2)
+    {
+	 uint32_t head=circ_buff_pointer->head_count;
+
+	 if(head==circ_buff_pointer->tail_count)
+	 {
+	      CIRC_BUFF_STATS_EMPTY(circ_buff_pointer);
+	      return CIRC_BUFF_EMPTY;
+	 }
+
+	 *data=circ_buff_pointer->base[head&circ_buff_pointer->mask];
+	 CIRC_BUFF_STATS_READ(circ_buff_pointer, head&circ_buff_pointer->mask, 1);
+	 circ_buff_pointer->head_count=head+1;
+	 circ_buff_file_move_head(circ_buff_pointer, 1);
+	 return CIRC_BUFF_SUCCESS;
+    }
+
     /*get buffer status- find if data can be read*/
     circ_buff_code if_read_ok=if_circ_buff_empty(circ_buff_pointer);     
     
     /*check if a read is feasible at all*/ 
     if(if_read_ok!=CIRC_BUFF_CAN_READ)
+    {
+	 CIRC_BUFF_STATS_EMPTY(circ_buff_pointer);
 	 return CIRC_BUFF_EMPTY;                      
+    }
     
     /*collect total size in a local variable*/ 
     uint32_t total_buff_size= circ_buff_pointer->total_size;
     
     /*assign the byte located at head to data and complete the read*/
     *data= *(circ_buff_pointer->head);  
+    CIRC_BUFF_STATS_READ(circ_buff_pointer, circ_buff_pointer->head-circ_buff_pointer->base, 1);
 
     /*update head circularly*/
-    if((circ_buff_pointer->head-circ_buff_pointer->base)!=total_buff_size)
+    if((circ_buff_pointer->head-circ_buff_pointer->base)!=total_buff_size-1)
          circ_buff_pointer->head++;           
     else
 	 circ_buff_pointer->head=(circ_buff_pointer->base);
 
     /*update the size occupied by the buffer*/
     circ_buff_pointer->size_occupied--;
+    circ_buff_file_move_head(circ_buff_pointer, 1);
+    
+    /*return successfully*/
+    return CIRC_BUFF_SUCCESS;
+}	
+
+/*								                
+ * Function:     circ_buff_write_n(circ_buff_ptr circ_buff_pointer, const uint32_t* data,
+ *                                 uint32_t count, uint32_t* written)
+ * -----------------------------------------------------------------------------
+ * Description:  Writes up to count elements from the data array to the 
+ *               circular buffer at circ_buff_ptr.
+ *               
+ * Working:      Writes as many elements as there is space for. The free region
+ *               starting at tail is at most two contiguous pieces (up to the
+ *               end of base, then from base), so the copy is at most two 
+ *               memcpy calls. Updates tail and size_occupied once.
+ *               In CIRC_BUFF_MODE_OVERWRITE all count elements are accepted;
+ *               the oldest elements are dropped to make room. A count of 0
+ *               writes nothing and succeeds in every mode.
+ * 
+ * Usage:        Pass a pointer to the circular buffer, the array to write, the
+ *               number of elements in the array and a pointer to a uint32_t in
+ *               that order. The uint32_t will contain the number of elements 
+ *               actually written.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed to the function is a
+ *               NULL and is thus invalid. The function halts execution and 
+ *               returns.
+ *
+ *               CIRC_BUFF_FULL: The buffer is full and count is non-zero; 
+ *               nothing was written.
+ *
+ *               CIRC_BUFF_SUCCESS: *written elements were written; this may
+ *               be less than count if the buffer filled up.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_write_n(circ_buff_ptr circ_buff_pointer, const uint32_t* data, uint32_t count, uint32_t* written)
+{
+    /*basic pointer check; error handling*/	
+    if(circ_buff_pointer==NULL||data==NULL||written==NULL)
+	 return CIRC_BUFF_NULL_PTR;
+
+    /*nothing to write is a no-op in every mode, full or not*/
+    *written=0;
+    if(count==0)
+	 return CIRC_BUFF_SUCCESS;
+
+    uint32_t total_buff_size=circ_buff_pointer->total_size;
+    uint32_t free_space=total_buff_size-circ_buff_used(circ_buff_pointer);
+    uint32_t tail_index=circ_buff_tail_index(circ_buff_pointer), skipped=0;
+    
+    /*overwrite mode: make room by dropping the oldest elements. Whatever is
+     *more than total_size at the front of data would be overwritten by the
+     *rest of data anyway, so it is skipped instead of copied*/
+    if((circ_buff_pointer->mode&CIRC_BUFF_MODE_OVERWRITE)&&count>free_space)
+    {
+	 if(count>total_buff_size)
+	 {
+	      skipped=count-total_buff_size;
+	      data+=skipped;
+	      count=total_buff_size;
+	 }
+	 
+	 circ_buff_move_head(circ_buff_pointer, count-free_space);
+	 circ_buff_pointer->dropped+=skipped+(count-free_space);
+	 free_space=count;
+    }
+    
+    /*write only as much as fits*/
+    if(count>free_space)
+	 count=free_space;
+    
+    /*count was non-zero, so nothing fits only if the buffer is full*/
+    if(count==0)
+    {
+	 CIRC_BUFF_STATS_FULL(circ_buff_pointer);
+	 return CIRC_BUFF_FULL;
+    }
+
+    *written=skipped+count;
+
+    /*first piece: from tail up to the end of base (all of it when mirrored)*/
+    uint32_t first=circ_buff_contiguous(circ_buff_pointer, tail_index);
+    if(first>count)
+	 first=count;
+    
+    memcpy(circ_buff_pointer->base+tail_index, data, (size_t)first*sizeof(uint32_t));
+    
+    /*second piece: whatever is left goes to the start of base*/
+    memcpy(circ_buff_pointer->base, data+first, (size_t)(count-first)*sizeof(uint32_t));
+
+    /*update tail circularly and the size occupied by the buffer*/
+    circ_buff_move_tail(circ_buff_pointer, count);
+    CIRC_BUFF_STATS_WRITE(circ_buff_pointer, tail_index, count, circ_buff_used(circ_buff_pointer));
+
+    /*return successfully*/
+    return CIRC_BUFF_SUCCESS;
+}
+
+/*								                
+ * Function:     circ_buff_read_n(circ_buff_ptr circ_buff_pointer, uint32_t* data,
+ *                                uint32_t count, uint32_t* read)
+ * -----------------------------------------------------------------------------
+ * Description:  Reads up to count elements from the head of the circular
+ *               buffer at circ_buff_ptr into the data array.
+ *               
+ * Working:      Reads as many elements as are present. The occupied region 
+ *               starting at head is at most two contiguous pieces, so the copy
+ *               is at most two memcpy calls. Updates head and size_occupied 
+ *               once.
+ * 
+ * Usage:        Pass a pointer to the circular buffer, an array with room for
+ *               count elements, count and a pointer to a uint32_t in that 
+ *               order. The uint32_t will contain the number of elements 
+ *               actually read.
+ *                
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed to the function is a
+ *               NULL and is thus invalid. The function halts execution and 
+ *               returns.
+ *               
+ *               CIRC_BUFF_EMPTY: The buffer is empty and count is non-zero;
+ *               nothing was read.
+ *               
+ *               CIRC_BUFF_SUCCESS: *read elements were read; this may be less
+ *               than count if the buffer ran empty.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_read_n(circ_buff_ptr circ_buff_pointer, uint32_t* data, uint32_t count, uint32_t* read)
+{
+    /*basic pointer check; error handling*/	
+    if(circ_buff_pointer==NULL||data==NULL||read==NULL)
+	 return CIRC_BUFF_NULL_PTR;
+
+    /*nothing to read is a no-op, empty or not*/
+    *read=0;
+    if(count==0)
+	 return CIRC_BUFF_SUCCESS;
+
+    uint32_t occupied=circ_buff_used(circ_buff_pointer);
+    uint32_t head_index=circ_buff_head_index(circ_buff_pointer);
+    
+    /*read only as much as is present*/
+    if(count>occupied)
+	 count=occupied;
+    
+    /*count was non-zero, so nothing is read only if the buffer is empty*/
+    if(count==0)
+    {
+	 CIRC_BUFF_STATS_EMPTY(circ_buff_pointer);
+	 return CIRC_BUFF_EMPTY;
+    }
+
+    *read=count;
+
+    /*first piece: from head up to the end of base (all of it when mirrored)*/
+    uint32_t first=circ_buff_contiguous(circ_buff_pointer, head_index);
+    if(first>count)
+	 first=count;
+    
+    memcpy(data, circ_buff_pointer->base+head_index, (size_t)first*sizeof(uint32_t));
+    
+    /*second piece: the rest wrapped around to the start of base*/
+    memcpy(data+first, circ_buff_pointer->base, (size_t)(count-first)*sizeof(uint32_t));
+
+    /*update head circularly and the size occupied by the buffer*/
+    CIRC_BUFF_STATS_READ(circ_buff_pointer, head_index, count);
+    circ_buff_move_head(circ_buff_pointer, count);
     
     /*return successfully*/
     return CIRC_BUFF_SUCCESS;
 }	
 
+/*								                
+ * Function:     circ_buff_reserve(circ_buff_ptr circ_buff_pointer, uint32_t** region,
+ *                                 uint32_t* length)
+ * -----------------------------------------------------------------------------
+ * Description:  Hands the producer the free region at the tail of the buffer
+ *               so that it can be filled in place instead of being copied in
+ *               through circ_buff_write.
+ *               
+ * Working:      *region is set to tail and *length to the number of free 
+ *               elements that are contiguous from tail, i.e. up to the end of
+ *               base or up to head, whichever comes first. Nothing is made
+ *               visible to the reader until circ_buff_commit is called.
+ * 
+ * Usage:        Pass a pointer to the circular buffer, a pointer to a uint32_t
+ *               pointer and a pointer to a uint32_t in that order. Fill at most
+ *               *length elements from *region and call circ_buff_commit with
+ *               the number actually filled.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed to the function is a
+ *               NULL and is thus invalid. The function halts execution and 
+ *               returns.
+ *
+ *               CIRC_BUFF_FULL: The buffer is full; there is no region to 
+ *               hand out.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution 
+ *               successfully.   
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_reserve(circ_buff_ptr circ_buff_pointer, uint32_t** region, uint32_t* length)
+{
+    /*basic pointer check; error handling*/	
+    if(circ_buff_pointer==NULL||region==NULL||length==NULL)
+	 return CIRC_BUFF_NULL_PTR;
+
+    uint32_t free_space=circ_buff_pointer->total_size-circ_buff_used(circ_buff_pointer);
+    uint32_t till_end=circ_buff_contiguous(circ_buff_pointer, circ_buff_tail_index(circ_buff_pointer));
+
+    if(free_space==0)
+    {
+	 CIRC_BUFF_STATS_FULL(circ_buff_pointer);
+	 return CIRC_BUFF_FULL;
+    }
+
+    /*the free region stops at the end of base or at head*/
+    *region=circ_buff_pointer->base+circ_buff_tail_index(circ_buff_pointer);
+    *length=free_space<till_end? free_space: till_end;
+
+    /*return successfully*/
+    return CIRC_BUFF_SUCCESS;
+}
+
+/*								                
+ * Function:     circ_buff_commit(circ_buff_ptr circ_buff_pointer, uint32_t count)
+ * -----------------------------------------------------------------------------
+ * Description:  Makes count elements filled in place after circ_buff_reserve
+ *               visible to the reader.
+ *               
+ * Working:      Moves tail forward by count circularly and adds count to the
+ *               size occupied.
+ * 
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed to the function is a
+ *               NULL and is thus invalid. The function halts execution and 
+ *               returns.
+ *
+ *               CIRC_BUFF_BAD_DATA: count is larger than the region that 
+ *               circ_buff_reserve can hand out; nothing is committed.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution 
+ *               successfully.   
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_commit(circ_buff_ptr circ_buff_pointer, uint32_t count)
+{
+    /*basic pointer check; error handling*/	
+    if(circ_buff_pointer==NULL)
+	 return CIRC_BUFF_NULL_PTR;
+
+    uint32_t free_space=circ_buff_pointer->total_size-circ_buff_used(circ_buff_pointer);
+    uint32_t till_end=circ_buff_contiguous(circ_buff_pointer, circ_buff_tail_index(circ_buff_pointer));
+
+    /*only the contiguous region handed out by reserve can have been filled*/
+    if(count>free_space||count>till_end)
+	 return CIRC_BUFF_BAD_DATA;
+
+    /*update tail circularly and the size occupied by the buffer*/
+    CIRC_BUFF_STATS_WRITE(circ_buff_pointer, circ_buff_tail_index(circ_buff_pointer), count,
+			  circ_buff_used(circ_buff_pointer)+count);
+    circ_buff_move_tail(circ_buff_pointer, count);
+
+    /*return successfully*/
+    return CIRC_BUFF_SUCCESS;
+}
+
+/*								                
+ * Function:     circ_buff_commit_pad(circ_buff_ptr circ_buff_pointer, uint32_t count)
+ * -----------------------------------------------------------------------------
+ * Description:  Same as circ_buff_commit for count elements that only pad the
+ *               buffer, e.g. the pad records of circ_buff_rec.h. The move is
+ *               not counted as a write in the statistics.
+ * 
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed to the function is a
+ *               NULL and is thus invalid.
+ *
+ *               CIRC_BUFF_BAD_DATA: count is larger than the region that 
+ *               circ_buff_reserve can hand out; nothing is committed.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution 
+ *               successfully.   
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_commit_pad(circ_buff_ptr circ_buff_pointer, uint32_t count)
+{
+    /*basic pointer check; error handling*/	
+    if(circ_buff_pointer==NULL)
+	 return CIRC_BUFF_NULL_PTR;
+
+    uint32_t free_space=circ_buff_pointer->total_size-circ_buff_used(circ_buff_pointer);
+    uint32_t till_end=circ_buff_contiguous(circ_buff_pointer, circ_buff_tail_index(circ_buff_pointer));
+
+    if(count>free_space||count>till_end)
+	 return CIRC_BUFF_BAD_DATA;
+
+    /*padding is not data- no statistics hook*/
+    circ_buff_move_tail(circ_buff_pointer, count);
+
+    return CIRC_BUFF_SUCCESS;
+}
+
+/*								                
+ * Function:     circ_buff_peek(circ_buff_ptr circ_buff_pointer, uint32_t** region,
+ *                              uint32_t* length)
+ * -----------------------------------------------------------------------------
+ * Description:  Hands the consumer the data at the head of the buffer so that
+ *               it can be processed in place instead of being copied out 
+ *               through circ_buff_read.
+ *               
+ * Working:      *region is set to head and *length to the number of occupied 
+ *               elements that are contiguous from head, i.e. up to the end of
+ *               base or up to tail, whichever comes first. The data stays in 
+ *               the buffer until circ_buff_release is called.
+ * 
+ * Usage:        Pass a pointer to the circular buffer, a pointer to a uint32_t
+ *               pointer and a pointer to a uint32_t in that order. Process at 
+ *               most *length elements from *region and call circ_buff_release
+ *               with the number consumed. If *length is less than the size
+ *               occupied, the rest of the data starts at base and is returned
+ *               by the next peek after the release.
+ *                
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed to the function is a
+ *               NULL and is thus invalid. The function halts execution and 
+ *               returns.
+ *               
+ *               CIRC_BUFF_EMPTY: The buffer is empty; there is no data to 
+ *               hand out.
+ *               
+ *               CIRC_BUFF_SUCCESS: The function completes execution 
+ *               completely.   
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_peek(circ_buff_ptr circ_buff_pointer, uint32_t** region, uint32_t* length)
+{
+    /*basic pointer check; error handling*/	
+    if(circ_buff_pointer==NULL||region==NULL||length==NULL)
+	 return CIRC_BUFF_NULL_PTR;
+
+    uint32_t occupied=circ_buff_used(circ_buff_pointer);
+    uint32_t till_end=circ_buff_contiguous(circ_buff_pointer, circ_buff_head_index(circ_buff_pointer));
+
+    if(occupied==0)
+    {
+	 CIRC_BUFF_STATS_EMPTY(circ_buff_pointer);
+	 return CIRC_BUFF_EMPTY;
+    }
+
+    /*the data region stops at the end of base or at tail*/
+    *region=circ_buff_pointer->base+circ_buff_head_index(circ_buff_pointer);
+    *length=occupied<till_end? occupied: till_end;
+
+    /*return successfully*/
+    return CIRC_BUFF_SUCCESS;
+}
+
+/*								                
+ * Function:     circ_buff_release(circ_buff_ptr circ_buff_pointer, uint32_t count)
+ * -----------------------------------------------------------------------------
+ * Description:  Drops count elements from the head of the buffer once the 
+ *               consumer is done with them after circ_buff_peek.
+ *               
+ * Working:      Moves head forward by count circularly and subtracts count 
+ *               from the size occupied. count may span the wrap point, so this
+ *               can also be used to discard data without reading it.
+ * 
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed to the function is a
+ *               NULL and is thus invalid. The function halts execution and 
+ *               returns.
+ *               
+ *               CIRC_BUFF_BAD_DATA: count is larger than the size occupied;
+ *               nothing is released.
+ *               
+ *               CIRC_BUFF_SUCCESS: The function completes execution 
+ *               completely.   
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_release(circ_buff_ptr circ_buff_pointer, uint32_t count)
+{
+    /*basic pointer check; error handling*/	
+    if(circ_buff_pointer==NULL)
+	 return CIRC_BUFF_NULL_PTR;
+
+    if(count>circ_buff_used(circ_buff_pointer))
+	 return CIRC_BUFF_BAD_DATA;
+
+    /*update head circularly and the size occupied by the buffer*/
+    CIRC_BUFF_STATS_READ(circ_buff_pointer, circ_buff_head_index(circ_buff_pointer), count);
+    circ_buff_move_head(circ_buff_pointer, count);
+
+    /*return successfully*/
+    return CIRC_BUFF_SUCCESS;
+}
+
+/*								                
+ * Function:     circ_buff_release_pad(circ_buff_ptr circ_buff_pointer, uint32_t count)
+ * -----------------------------------------------------------------------------
+ * Description:  Same as circ_buff_release for count elements committed with
+ *               circ_buff_commit_pad. The move is not counted as a read in
+ *               the statistics.
+ * 
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed to the function is a
+ *               NULL and is thus invalid.
+ *
+ *               CIRC_BUFF_BAD_DATA: count is larger than the size occupied;
+ *               nothing is released.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution 
+ *               successfully.   
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_release_pad(circ_buff_ptr circ_buff_pointer, uint32_t count)
+{
+    /*basic pointer check; error handling*/	
+    if(circ_buff_pointer==NULL)
+	 return CIRC_BUFF_NULL_PTR;
+
+    if(count>circ_buff_used(circ_buff_pointer))
+	 return CIRC_BUFF_BAD_DATA;
+
+    /*padding is not data- no statistics hook*/
+    circ_buff_move_head(circ_buff_pointer, count);
+
+    return CIRC_BUFF_SUCCESS;
+}
+
+/*								                
+ * Function:     circ_buff_dropped(circ_buff_ptr circ_buff_pointer, uint64_t* dropped)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the number of elements dropped by writes to a full
+ *               buffer in CIRC_BUFF_MODE_OVERWRITE since init.
+ *               
+ * Usage:        Pass a pointer to the circular buffer and a pointer to a 
+ *               uint64_t in that order.
+ *                
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed to the function is a
+ *               NULL and is thus invalid.
+ *               
+ *               CIRC_BUFF_SUCCESS: The function completes execution 
+ *               completely.   
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_dropped(circ_buff_ptr circ_buff_pointer, uint64_t* dropped)
+{
+    /*basic pointer check; error handling*/	
+    if(circ_buff_pointer==NULL||dropped==NULL)
+	 return CIRC_BUFF_NULL_PTR;
+
+    *dropped=circ_buff_pointer->dropped;
+
+    return CIRC_BUFF_SUCCESS;
+}
+
 /*								                
  * Function:     circ_buff_dump(circ_buff_ptr cb)
  * -----------------------------------------------------------------------------
@@ -313,8 +1231,12 @@ circ_buff_code circ_buff_read(circ_buff_ptr circ_buff_pointer, uint32_t* data)
  */
 circ_buff_code dump(circ_buff_ptr cb)
 {
+    /*basic pointer check; error handling*/	
+    if(cb==NULL)
+	 return CIRC_BUFF_NULL_PTR;
+
     uint32_t total_size= cb->total_size, index; 
-    uint32_t head=cb->head-cb->base, tail=cb->tail-cb->base;
+    uint32_t head=circ_buff_head_index(cb), tail=circ_buff_tail_index(cb);
     
     FILE* fp1;
     
@@ -343,8 +1265,10 @@ circ_buff_code dump(circ_buff_ptr cb)
      *  base_ptr   tail_ptr    head_ptr     base_ptr+total_size
      *  #-Data element
      *  *-empty element
+     *
+     *  A full buffer has head==tail and is also printed this way.
      * */
-    if(head>tail)
+    if(head>tail||(head==tail&&circ_buff_used(cb)!=0))
     {
          /*using for loop to print as per the above scenario*/
 	 for(index=0; index<tail; index++)
@@ -383,5 +1307,115 @@ circ_buff_code dump(circ_buff_ptr cb)
     
     }    
     /*the above scenarios encompass all the buffer states*/ 
+    fclose(fp1);
+    return CIRC_BUFF_SUCCESS;
+}
+
+/*								                
+ * Function:     circ_buff_dump_fd(circ_buff_ptr cb, int fd, circ_buff_dump_format format)
+ * -----------------------------------------------------------------------------
+ * Description:  Writes a snapshot of the data in the circular buffer pointed 
+ *               by cb to the file descriptor fd chosen by the caller.
+ *               
+ * Working:      CIRC_BUFF_DUMP_BINARY: a circ_buff_dump_header followed by 
+ *               the 'count' elements from head to tail in native byte order.
+ *               The live region is at most two contiguous pieces of base, so
+ *               the header and the data go out in a single writev call (more
+ *               only if the kernel accepts a short write).
+ *
+ *               CIRC_BUFF_DUMP_TEXT: the elements from head to tail in 
+ *               decimal, one per line. The numbers are formatted by hand into
+ *               a local buffer that is written out whenever it fills up, 
+ *               instead of one fprintf per element.
+ * 
+ * Usage:        Pass a pointer to the circular buffer, an open file descriptor
+ *               and the format in that order. The descriptor is not closed.
+ *               Unlike dump, an empty buffer is not an error.
+ * 
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed to the function is a
+ *               NULL and is thus invalid.
+ *               
+ *               CIRC_BUFF_BAD_DATA: fd is negative or format is unknown.
+ *
+ *               CIRC_BUFF_WRITE_FAILED: A write to fd failed.
+ *               
+ *               CIRC_BUFF_SUCCESS: The function completes execution 
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_dump_fd(circ_buff_ptr cb, int fd, circ_buff_dump_format format)
+{
+    /*basic pointer check; error handling*/	
+    if(cb==NULL)
+	 return CIRC_BUFF_NULL_PTR;
+
+    if(fd<0||(format!=CIRC_BUFF_DUMP_BINARY&&format!=CIRC_BUFF_DUMP_TEXT))
+	 return CIRC_BUFF_BAD_DATA;
+
+    uint32_t head=circ_buff_head_index(cb), count=circ_buff_used(cb);
+    
+    /*the live region: from head up to the end of base, then from base*/
+    uint32_t first=circ_buff_contiguous(cb, head);
+    if(first>count)
+	 first=count;
+
+    if(format==CIRC_BUFF_DUMP_BINARY)
+    {
+	 circ_buff_dump_header header;
+	 struct iovec iov[3];
+
+	 header.magic=CIRC_BUFF_DUMP_MAGIC;
+	 header.version=CIRC_BUFF_DUMP_VERSION;
+	 header.total_size=cb->total_size;
+	 header.head=head;
+	 header.tail=circ_buff_tail_index(cb);
+	 header.count=count;
+
+	 iov[0].iov_base=&header;
+	 iov[0].iov_len=sizeof(header);
+	 iov[1].iov_base=cb->base+head;
+	 iov[1].iov_len=(size_t)first*sizeof(uint32_t);
+	 iov[2].iov_base=cb->base;
+	 iov[2].iov_len=(size_t)(count-first)*sizeof(uint32_t);
+
+	 if(circ_buff_write_all(fd, iov, 3)!=0)
+	      return CIRC_BUFF_WRITE_FAILED;
+
+	 return CIRC_BUFF_SUCCESS;
+    }
+
+    /*text: at most 10 digits and a newline per element*/
+    char text[CIRC_BUFF_DUMP_TEXT_CHUNK];
+    char* out=text;
+    uint32_t index;
+    struct iovec iov;
+
+    for(index=0; index<count; index++)
+    {
+	 uint32_t slot=head+index;
+	 
+	 if(slot>=cb->total_size)
+	      slot-=cb->total_size;
+
+	 out=circ_buff_u32_to_text(cb->base[slot], out);
+	 *out++='\n';
+
+	 /*flush when another element might not fit*/
+	 if(text+sizeof(text)-out<11)
+	 {
+	      iov.iov_base=text;
+	      iov.iov_len=(size_t)(out-text);
+	      if(circ_buff_write_all(fd, &iov, 1)!=0)
+		   return CIRC_BUFF_WRITE_FAILED;
+	      out=text;
+	 }
+    }
+
+    iov.iov_base=text;
+    iov.iov_len=(size_t)(out-text);
+    if(circ_buff_write_all(fd, &iov, 1)!=0)
+	 return CIRC_BUFF_WRITE_FAILED;
+
     return CIRC_BUFF_SUCCESS;
 }
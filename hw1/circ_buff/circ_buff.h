@@ -7,7 +7,47 @@
 #include<stdint.h>
 #define FILE_NAME "stdout"
 
-typedef enum {CIRC_BUFF_SUCCESS, CIRC_BUFF_NULL_PTR, CIRC_BUFF_MALLOC_FAIL, CIRC_BUFF_BAD_DATA, CIRC_BUFF_EMPTY, CIRC_BUFF_FULL, CIRC_BUFF_CAN_WRITE, CIRC_BUFF_CAN_READ, CIRC_BUFF_FILE_OPEN_FAILED} circ_buff_code;
+/*size of a cache line; indices written by different threads live on separate lines*/
+#define CIRC_BUFF_CACHE_LINE 64
+
+/*modes selected at circ_buff_init_mode; flags can be or'ed together*/
+#define CIRC_BUFF_MODE_DEFAULT   0x0u
+#define CIRC_BUFF_MODE_POW2      0x1u
+#define CIRC_BUFF_MODE_VMIRROR   0x2u
+#define CIRC_BUFF_MODE_OVERWRITE 0x4u
+#define CIRC_BUFF_MODE_ALL       (CIRC_BUFF_MODE_POW2|CIRC_BUFF_MODE_VMIRROR|CIRC_BUFF_MODE_OVERWRITE)
+
+typedef enum {CIRC_BUFF_SUCCESS, CIRC_BUFF_NULL_PTR, CIRC_BUFF_MALLOC_FAIL, CIRC_BUFF_BAD_DATA, CIRC_BUFF_EMPTY, CIRC_BUFF_FULL, CIRC_BUFF_CAN_WRITE, CIRC_BUFF_CAN_READ, CIRC_BUFF_FILE_OPEN_FAILED, CIRC_BUFF_TIMEOUT, CIRC_BUFF_WRITE_FAILED, CIRC_BUFF_IN_USE} circ_buff_code;
+
+/*formats written by circ_buff_dump_fd*/
+typedef enum {CIRC_BUFF_DUMP_BINARY, CIRC_BUFF_DUMP_TEXT} circ_buff_dump_format;
+
+/*identifies a binary dump ("CBUF") and its layout*/
+#define CIRC_BUFF_DUMP_MAGIC   0x46554243u
+#define CIRC_BUFF_DUMP_VERSION 1u
+
+/*size of the stack buffer the text dump formats into before each write*/
+#define CIRC_BUFF_DUMP_TEXT_CHUNK 65536
+
+
+/*								                
+ * Structure:    circ_buff_dump_header 
+ * -----------------------------------------------------------------------------
+ * Description:  Header at the start of a binary dump. head and tail are the 
+ *               offsets from base at the time of the dump and count elements
+ *               follow the header in read order. All fields are in native
+ *               byte order.
+ * ----------------------------------------------------------------------------
+ */
+typedef struct circ_buff_dump_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t total_size;
+    uint32_t head;
+    uint32_t tail;
+    uint32_t count;
+}circ_buff_dump_header;
 
 
 /*								                
@@ -15,6 +55,14 @@ typedef enum {CIRC_BUFF_SUCCESS, CIRC_BUFF_NULL_PTR, CIRC_BUFF_MALLOC_FAIL, CIRC
  * -----------------------------------------------------------------------------
  * Description:  A circular buffer structure that tracks the head, the tail, 
  *               the total size and the current size of the circular buffer.
+ *               In CIRC_BUFF_MODE_POW2 head_count/tail_count and mask are used
+ *               in place of head, tail and size_occupied. dropped counts the
+ *               elements overwritten in CIRC_BUFF_MODE_OVERWRITE. stats is NULL
+ *               unless statistics are compiled in with -DCIRC_BUFF_STATS (see
+ *               circ_buff_stats.h); the member is always there, so the
+ *               layout does not depend on the define. file is
+ *               NULL unless the buffer was opened with circ_buff_init_file
+ *               (see circ_buff_file.h).
  *           
  * Usage:        Use regular structure syntax to access any of the members of 
  *               this structure       
@@ -24,6 +72,12 @@ typedef enum {CIRC_BUFF_SUCCESS, CIRC_BUFF_NULL_PTR, CIRC_BUFF_MALLOC_FAIL, CIRC
 /*typedef a circ_buff ptr type so that "*" does not have to be used always*/
 typedef struct circ_buff *circ_buff_ptr;
 
+/*defined in circ_buff_stats.h; only allocated with -DCIRC_BUFF_STATS*/
+typedef struct circ_buff_stats *circ_buff_stats_ptr;
+
+/*defined in circ_buff_file.h*/
+typedef struct circ_buff_file *circ_buff_file_ptr;
+
 
 typedef struct circ_buff
 {
@@ -32,21 +86,28 @@ typedef struct circ_buff
     uint32_t *tail;
     uint32_t  total_size;
     uint32_t  size_occupied;
+    uint32_t  mode;
+    uint32_t  mask;
+    uint32_t  head_count;
+    uint32_t  tail_count;
+    uint64_t  dropped;
+    circ_buff_file_ptr file;
+    circ_buff_stats_ptr stats;
 }circ_buff;
 
 
 /*								                
  * Function:     circ_buff_init(circ_buff_ptr* circ_buff_pointer, int16_t size)
  * -----------------------------------------------------------------------------
- * Description:  Assigns memory specified by 'size' to the circular buffer 
- *               structure pointed to by the pointer argument on the heap. 
+ * Description:  Assigns memory for 'size' uint32_t elements to the circular
+ *               buffer structure pointed to by the pointer argument on the heap. 
  *               Also initialises various parameters to this buffer, like the 
  *               head, tail, total size, and size_occupied, etc.  
  *              
  *           
  * Usage:        Pass a pointer to the ptr of the circular buffer struc which 
- *               needs to be allocated memory on the heap, and a uin32_t type 
- *               specifying the size in that order.
+ *               needs to be allocated memory on the heap, and an int32_t type 
+ *               specifying the number of elements in that order.
  * 
  * Returns:      Error codes:
  *               CIRC_BUFF_NULL_POINTER: The pointer passed is detected to be a 
@@ -60,6 +121,51 @@ typedef struct circ_buff
  *               CIRC_BUFF_SUCCESS: The funcion returns successfully.
  */
 circ_buff_code circ_buff_init(circ_buff_ptr* circ_buff_pointer, int32_t size);
+
+/*								                
+ * Function:     circ_buff_init_mode(circ_buff_ptr* circ_buff_pointer, int32_t size,
+ *                                   uint32_t mode)
+ * -----------------------------------------------------------------------------
+ * Description:  Same as circ_buff_init, but selects the mode the buffer runs
+ *               in. mode is CIRC_BUFF_MODE_DEFAULT or an or of the 
+ *               CIRC_BUFF_MODE_* flags:
+ *
+ *               CIRC_BUFF_MODE_POW2: 'size' is rounded up to a power of two 
+ *               and head/tail are kept as free running 32 bit counters 
+ *               (head_count, tail_count). The slot of a counter is 
+ *               counter&mask and the occupancy is tail_count-head_count, so
+ *               the head/tail pointers and size_occupied are not maintained
+ *               and the read/write paths have no wraparound branch.
+ *
+ *               CIRC_BUFF_MODE_VMIRROR: 'size' is rounded up to whole pages 
+ *               and the data region is a memfd mapped twice back to back, so
+ *               base[total_size+i] is base[i]. Batch copies never split at 
+ *               the wrap point, and reserve/peek always hand out all of the
+ *               free/occupied space as one region (which can be passed
+ *               straight to write(2)/writev).
+ *
+ *               CIRC_BUFF_MODE_OVERWRITE: writes to a full buffer always
+ *               succeed; the oldest elements are dropped to make room (head
+ *               is moved forward) and counted in 'dropped', so the buffer
+ *               keeps the newest total_size elements like a flight recorder.
+ *           
+ * Usage:        Pass a pointer to the ptr of the circular buffer struc, the 
+ *               number of elements and the mode in that order.
+ * 
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_POINTER: The pointer passed is detected to be a 
+ *               null. The function halts execution and returns w/o completion.   
+ *                  
+ *               CIRC_BUFF_BAD_DATA: The size parameter is less than or equal 
+ *               to zero, or mode has unknown flags set.
+ *               
+ *               CIRC_BUFF_MALLOC_FAIL: The call to malloc, or setting up the
+ *               mirrored mapping, fails.
+ *
+ *               CIRC_BUFF_SUCCESS: The funcion returns successfully.
+ */
+circ_buff_code circ_buff_init_mode(circ_buff_ptr* circ_buff_pointer, int32_t size, uint32_t mode);
+
 /*								                
  * Function:     circ_buff_destroy(circ_buff_ptr circ_buff_ptr)
  * -----------------------------------------------------------------------------
@@ -134,7 +240,9 @@ circ_buff_code if_circ_buff_empty(circ_buff_ptr circ_buff_pointer);
  *               returns.
  *
  *               CIRC_BUFF_FULL: The buffer is currently full and thus new
- *               data can not be written to it.
+ *               data can not be written to it. Never returned in 
+ *               CIRC_BUFF_MODE_OVERWRITE, where the oldest element is dropped
+ *               instead.
  *
  *               CIRC_BUFF_SUCCESS: The function completes execution 
  *               successfully.   
@@ -168,6 +276,246 @@ circ_buff_code circ_buff_write(circ_buff_ptr circ_buff_pointer, uint32_t data);
 circ_buff_code circ_buff_read(circ_buff_ptr circ_buff_pointer, uint32_t* data);
 
 
+/*								                
+ * Function:     circ_buff_write_n(circ_buff_ptr circ_buff_pointer, const uint32_t* data,
+ *                                 uint32_t count, uint32_t* written)
+ * -----------------------------------------------------------------------------
+ * Description:  Writes up to count elements from the data array to the 
+ *               circular buffer at circ_buff_ptr.
+ *               
+ * Working:      Writes as many elements as there is space for. The free region
+ *               starting at tail is at most two contiguous pieces (up to the
+ *               end of base, then from base), so the copy is at most two 
+ *               memcpy calls. Updates tail and size_occupied once.
+ *               In CIRC_BUFF_MODE_OVERWRITE all count elements are accepted;
+ *               the oldest elements are dropped to make room. A count of 0
+ *               writes nothing and succeeds in every mode.
+ * 
+ * Usage:        Pass a pointer to the circular buffer, the array to write, the
+ *               number of elements in the array and a pointer to a uint32_t in
+ *               that order. The uint32_t will contain the number of elements 
+ *               actually written.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed to the function is a
+ *               NULL and is thus invalid. The function halts execution and 
+ *               returns.
+ *
+ *               CIRC_BUFF_FULL: The buffer is full and count is non-zero; 
+ *               nothing was written.
+ *
+ *               CIRC_BUFF_SUCCESS: *written elements were written; this may
+ *               be less than count if the buffer filled up.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_write_n(circ_buff_ptr circ_buff_pointer, const uint32_t* data, uint32_t count, uint32_t* written);
+
+/*								                
+ * Function:     circ_buff_read_n(circ_buff_ptr circ_buff_pointer, uint32_t* data,
+ *                                uint32_t count, uint32_t* read)
+ * -----------------------------------------------------------------------------
+ * Description:  Reads up to count elements from the head of the circular
+ *               buffer at circ_buff_ptr into the data array.
+ *               
+ * Working:      Reads as many elements as are present. The occupied region 
+ *               starting at head is at most two contiguous pieces, so the copy
+ *               is at most two memcpy calls. Updates head and size_occupied 
+ *               once.
+ * 
+ * Usage:        Pass a pointer to the circular buffer, an array with room for
+ *               count elements, count and a pointer to a uint32_t in that 
+ *               order. The uint32_t will contain the number of elements 
+ *               actually read.
+ *                
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed to the function is a
+ *               NULL and is thus invalid. The function halts execution and 
+ *               returns.
+ *               
+ *               CIRC_BUFF_EMPTY: The buffer is empty and count is non-zero;
+ *               nothing was read.
+ *               
+ *               CIRC_BUFF_SUCCESS: *read elements were read; this may be less
+ *               than count if the buffer ran empty.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_read_n(circ_buff_ptr circ_buff_pointer, uint32_t* data, uint32_t count, uint32_t* read);
+
+
+/*								                
+ * Function:     circ_buff_reserve(circ_buff_ptr circ_buff_pointer, uint32_t** region,
+ *                                 uint32_t* length)
+ * -----------------------------------------------------------------------------
+ * Description:  Hands the producer the free region at the tail of the buffer
+ *               so that it can be filled in place instead of being copied in
+ *               through circ_buff_write.
+ *               
+ * Working:      *region is set to tail and *length to the number of free 
+ *               elements that are contiguous from tail, i.e. up to the end of
+ *               base or up to head, whichever comes first. Nothing is made
+ *               visible to the reader until circ_buff_commit is called.
+ * 
+ * Usage:        Pass a pointer to the circular buffer, a pointer to a uint32_t
+ *               pointer and a pointer to a uint32_t in that order. Fill at most
+ *               *length elements from *region and call circ_buff_commit with
+ *               the number actually filled.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed to the function is a
+ *               NULL and is thus invalid. The function halts execution and 
+ *               returns.
+ *
+ *               CIRC_BUFF_FULL: The buffer is full; there is no region to 
+ *               hand out.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution 
+ *               successfully.   
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_reserve(circ_buff_ptr circ_buff_pointer, uint32_t** region, uint32_t* length);
+
+/*								                
+ * Function:     circ_buff_commit(circ_buff_ptr circ_buff_pointer, uint32_t count)
+ * -----------------------------------------------------------------------------
+ * Description:  Makes count elements filled in place after circ_buff_reserve
+ *               visible to the reader.
+ *               
+ * Working:      Moves tail forward by count circularly and adds count to the
+ *               size occupied.
+ * 
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed to the function is a
+ *               NULL and is thus invalid. The function halts execution and 
+ *               returns.
+ *
+ *               CIRC_BUFF_BAD_DATA: count is larger than the region that 
+ *               circ_buff_reserve can hand out; nothing is committed.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution 
+ *               successfully.   
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_commit(circ_buff_ptr circ_buff_pointer, uint32_t count);
+
+/*								                
+ * Function:     circ_buff_commit_pad(circ_buff_ptr circ_buff_pointer, uint32_t count)
+ * -----------------------------------------------------------------------------
+ * Description:  Same as circ_buff_commit for count elements that only pad the
+ *               buffer, e.g. the pad records of circ_buff_rec.h. The move is
+ *               not counted as a write in the statistics.
+ * 
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed to the function is a
+ *               NULL and is thus invalid.
+ *
+ *               CIRC_BUFF_BAD_DATA: count is larger than the region that 
+ *               circ_buff_reserve can hand out; nothing is committed.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution 
+ *               successfully.   
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_commit_pad(circ_buff_ptr circ_buff_pointer, uint32_t count);
+
+/*								                
+ * Function:     circ_buff_peek(circ_buff_ptr circ_buff_pointer, uint32_t** region,
+ *                              uint32_t* length)
+ * -----------------------------------------------------------------------------
+ * Description:  Hands the consumer the data at the head of the buffer so that
+ *               it can be processed in place instead of being copied out 
+ *               through circ_buff_read.
+ *               
+ * Working:      *region is set to head and *length to the number of occupied 
+ *               elements that are contiguous from head, i.e. up to the end of
+ *               base or up to tail, whichever comes first. The data stays in 
+ *               the buffer until circ_buff_release is called.
+ * 
+ * Usage:        Pass a pointer to the circular buffer, a pointer to a uint32_t
+ *               pointer and a pointer to a uint32_t in that order. Process at 
+ *               most *length elements from *region and call circ_buff_release
+ *               with the number consumed. If *length is less than the size
+ *               occupied, the rest of the data starts at base and is returned
+ *               by the next peek after the release.
+ *                
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed to the function is a
+ *               NULL and is thus invalid. The function halts execution and 
+ *               returns.
+ *               
+ *               CIRC_BUFF_EMPTY: The buffer is empty; there is no data to 
+ *               hand out.
+ *               
+ *               CIRC_BUFF_SUCCESS: The function completes execution 
+ *               completely.   
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_peek(circ_buff_ptr circ_buff_pointer, uint32_t** region, uint32_t* length);
+
+/*								                
+ * Function:     circ_buff_release(circ_buff_ptr circ_buff_pointer, uint32_t count)
+ * -----------------------------------------------------------------------------
+ * Description:  Drops count elements from the head of the buffer once the 
+ *               consumer is done with them after circ_buff_peek.
+ *               
+ * Working:      Moves head forward by count circularly and subtracts count 
+ *               from the size occupied. count may span the wrap point, so this
+ *               can also be used to discard data without reading it.
+ * 
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed to the function is a
+ *               NULL and is thus invalid. The function halts execution and 
+ *               returns.
+ *               
+ *               CIRC_BUFF_BAD_DATA: count is larger than the size occupied;
+ *               nothing is released.
+ *               
+ *               CIRC_BUFF_SUCCESS: The function completes execution 
+ *               completely.   
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_release(circ_buff_ptr circ_buff_pointer, uint32_t count);
+
+/*								                
+ * Function:     circ_buff_release_pad(circ_buff_ptr circ_buff_pointer, uint32_t count)
+ * -----------------------------------------------------------------------------
+ * Description:  Same as circ_buff_release for count elements committed with
+ *               circ_buff_commit_pad. The move is not counted as a read in
+ *               the statistics.
+ * 
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed to the function is a
+ *               NULL and is thus invalid.
+ *
+ *               CIRC_BUFF_BAD_DATA: count is larger than the size occupied;
+ *               nothing is released.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution 
+ *               successfully.   
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_release_pad(circ_buff_ptr circ_buff_pointer, uint32_t count);
+
+
+/*								                
+ * Function:     circ_buff_dropped(circ_buff_ptr circ_buff_pointer, uint64_t* dropped)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the number of elements dropped by writes to a full
+ *               buffer in CIRC_BUFF_MODE_OVERWRITE since init.
+ *               
+ * Usage:        Pass a pointer to the circular buffer and a pointer to a 
+ *               uint64_t in that order.
+ *                
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed to the function is a
+ *               NULL and is thus invalid.
+ *               
+ *               CIRC_BUFF_SUCCESS: The function completes execution 
+ *               completely.   
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_dropped(circ_buff_ptr circ_buff_pointer, uint64_t* dropped);
+
+
 /*								                
  * Function:     circ_buff_dump(circ_buff_ptr cb)
  * -----------------------------------------------------------------------------
@@ -192,4 +540,40 @@ circ_buff_code circ_buff_read(circ_buff_ptr circ_buff_pointer, uint32_t* data);
  */
 circ_buff_code dump(circ_buff_ptr cb);
 
-#endif    
+
+/*								                
+ * Function:     circ_buff_dump_fd(circ_buff_ptr cb, int fd, circ_buff_dump_format format)
+ * -----------------------------------------------------------------------------
+ * Description:  Writes a snapshot of the data in the circular buffer pointed 
+ *               by cb to the file descriptor fd chosen by the caller.
+ *               
+ * Working:      CIRC_BUFF_DUMP_BINARY: a circ_buff_dump_header followed by 
+ *               the 'count' elements from head to tail in native byte order.
+ *               The live region is at most two contiguous pieces of base, so
+ *               the header and the data go out in a single writev call (more
+ *               only if the kernel accepts a short write).
+ *
+ *               CIRC_BUFF_DUMP_TEXT: the elements from head to tail in 
+ *               decimal, one per line. The numbers are formatted by hand into
+ *               a local buffer that is written out whenever it fills up, 
+ *               instead of one fprintf per element.
+ * 
+ * Usage:        Pass a pointer to the circular buffer, an open file descriptor
+ *               and the format in that order. The descriptor is not closed.
+ *               Unlike dump, an empty buffer is not an error.
+ * 
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed to the function is a
+ *               NULL and is thus invalid.
+ *               
+ *               CIRC_BUFF_BAD_DATA: fd is negative or format is unknown.
+ *
+ *               CIRC_BUFF_WRITE_FAILED: A write to fd failed.
+ *               
+ *               CIRC_BUFF_SUCCESS: The function completes execution 
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_dump_fd(circ_buff_ptr cb, int fd, circ_buff_dump_format format);
+
+#endif
@@ -0,0 +1,414 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         circ_buff_file.c
+ *
+ * Description:  Contains an implementation of the file backed mode of the
+ *               circular buffer, which maps its data region and a header
+ *               with the head and tail counters from a file so that a
+ *               restarted process finds the buffer as it was left.
+ *
+ * */
+
+
+/*ftruncate, msync and flock are POSIX/BSD*/
+#define _GNU_SOURCE
+
+#include "circ_buff_file.h"
+#include "circ_buff_stats.h"
+#include<stdint.h>
+#include<stdlib.h>
+#include<stddef.h>
+#include<string.h>
+#include<stdatomic.h>
+#include<errno.h>
+#include<fcntl.h>
+#include<unistd.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<sys/file.h>
+
+
+/*
+ * Function:     circ_buff_file_checksum(const circ_buff_file_header* header)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the FNV-1a hash of the fields of the header before
+ *               checksum.
+ * ----------------------------------------------------------------------------
+ */
+static uint64_t circ_buff_file_checksum(const circ_buff_file_header* header)
+{
+    const unsigned char *byte=(const unsigned char*)header;
+    uint64_t hash=UINT64_C(0xcbf29ce484222325);
+    size_t i;
+
+    for(i=0; i<offsetof(circ_buff_file_header, checksum); i++)
+         hash=(hash^byte[i])*UINT64_C(0x100000001b3);
+
+    return hash;
+}
+
+/*
+ * Function:     circ_buff_file_check(const circ_buff_file_header* header, size_t map_size,
+ *                                    uint32_t total_size, uint32_t mode)
+ * -----------------------------------------------------------------------------
+ * Description:  Checks that an existing file holds a buffer of total_size
+ *               elements (any size if 0) in the given mode that fits the
+ *               mapping, and that its counters describe a valid occupancy.
+ * ----------------------------------------------------------------------------
+ */
+static circ_buff_code circ_buff_file_check(const circ_buff_file_header* header, size_t map_size,
+                                           uint32_t total_size, uint32_t mode)
+{
+    uint64_t page=(uint64_t)sysconf(_SC_PAGESIZE);
+
+    if(header->magic!=CIRC_BUFF_FILE_MAGIC||header->version!=CIRC_BUFF_FILE_VERSION||
+       header->checksum!=circ_buff_file_checksum(header))
+         return CIRC_BUFF_BAD_DATA;
+
+    if(header->mode!=mode||header->total_size==0||header->total_size>(UINT32_C(1)<<30)||
+       ((mode&CIRC_BUFF_MODE_POW2)&&(header->total_size&(header->total_size-1))!=0))
+         return CIRC_BUFF_BAD_DATA;
+
+    if(header->data_offset<sizeof(circ_buff_file_header)||header->data_offset%page!=0||
+       header->data_offset+(uint64_t)header->total_size*sizeof(uint32_t)>map_size)
+         return CIRC_BUFF_BAD_DATA;
+
+    if(total_size!=0&&total_size!=header->total_size)
+         return CIRC_BUFF_BAD_DATA;
+
+    if(atomic_load(&header->tail_count)-atomic_load(&header->head_count)>header->total_size)
+         return CIRC_BUFF_BAD_DATA;
+
+    return CIRC_BUFF_SUCCESS;
+}
+
+/*
+ * Function:     circ_buff_file_blank(int fd, size_t file_size)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns 1 if the file holds no committed header: it is shorter
+ *               than a header, or magic and checksum are still 0. The header
+ *               is committed by storing them last, so such a file is one
+ *               whose creation did not finish and may be formatted again.
+ * ----------------------------------------------------------------------------
+ */
+static int circ_buff_file_blank(int fd, size_t file_size)
+{
+    circ_buff_file_header header;
+
+    if(file_size<sizeof(circ_buff_file_header))
+         return 1;
+
+    if(pread(fd, &header, sizeof(header), 0)!=(ssize_t)sizeof(header))
+         return 0;
+
+    return header.magic==0&&header.checksum==0;
+}
+
+/*
+ * Function:     circ_buff_file_format(circ_buff_file_header* header, int fd, uint32_t total_size,
+ *                                     uint32_t mode, size_t page)
+ * -----------------------------------------------------------------------------
+ * Description:  Writes the header of a new file. Every field but magic and
+ *               checksum goes to disk first; only then are those two stored
+ *               and flushed, so a crash at any point leaves either a blank
+ *               header or a complete one.
+ * ----------------------------------------------------------------------------
+ */
+static circ_buff_code circ_buff_file_format(circ_buff_file_header* header, int fd, uint32_t total_size,
+                                            uint32_t mode, size_t page)
+{
+    header->magic=0;
+    header->checksum=0;
+    header->version=CIRC_BUFF_FILE_VERSION;
+    header->total_size=total_size;
+    header->mode=mode;
+    header->data_offset=page;
+    atomic_store(&header->head_count, 0);
+    atomic_store(&header->tail_count, 0);
+    header->dropped=0;
+
+    /*barrier: the fields and the size of the file before the commit*/
+    if(msync(header, page, MS_SYNC)!=0||fsync(fd)!=0)
+         return CIRC_BUFF_WRITE_FAILED;
+
+    header->magic=CIRC_BUFF_FILE_MAGIC;
+    header->checksum=circ_buff_file_checksum(header);
+
+    if(msync(header, page, MS_SYNC)!=0)
+         return CIRC_BUFF_WRITE_FAILED;
+
+    return CIRC_BUFF_SUCCESS;
+}
+
+
+/*
+ * Function:     circ_buff_init_file(circ_buff_ptr* circ_buff_pointer, const char* path,
+ *                                   int32_t size, uint32_t mode)
+ * -----------------------------------------------------------------------------
+ * Description:  Opens the file backed buffer at path, creating the file if it
+ *               does not exist or has no committed header.
+ *
+ * Working:      A new file is sized to one header page plus the data region
+ *               and mapped shared. Its header is written with magic and
+ *               checksum last, after an msync and fsync of the other fields,
+ *               so a crash during creation leaves them 0; a file in that
+ *               state, or shorter than a header, is formatted again as a new
+ *               one. An existing file is mapped as it is after the
+ *               consistency check: the magic, version and checksum of the
+ *               header must match, the file must be large enough for the data
+ *               region, size and mode must match the ones it was created with
+ *               and the counters must describe at most total_size elements.
+ *               head and tail are then rebuilt from the counters.
+ *               The file is locked with flock while it is open, so a second
+ *               process can not use the same buffer at the same time.
+ *
+ * Usage:        Pass a pointer to the ptr of the circular buffer, the path of
+ *               the file, the number of elements and the mode as for
+ *               circ_buff_init_mode. size may be 0 to accept the size of an
+ *               existing file. CIRC_BUFF_MODE_VMIRROR is not supported.
+ *               Changes survive the process at any point; call
+ *               circ_buff_sync to make them survive a crash of the machine.
+ *               After such a crash the file holds at least the state of the
+ *               last sync; elements written after it may read back stale.
+ *               circ_buff_destroy syncs, unmaps and closes the file.
+ *               Elements found in the file are time stamped at the open
+ *               when statistics are on.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_BAD_DATA: size is out of range or 0 for a new file,
+ *               mode is unknown or has CIRC_BUFF_MODE_VMIRROR, or an existing
+ *               file fails the consistency check.
+ *
+ *               CIRC_BUFF_FILE_OPEN_FAILED: The file can not be opened,
+ *               sized or mapped.
+ *
+ *               CIRC_BUFF_WRITE_FAILED: The header of a new file can not be
+ *               flushed to disk.
+ *
+ *               CIRC_BUFF_IN_USE: Another open buffer holds the file.
+ *
+ *               CIRC_BUFF_MALLOC_FAIL: A call to malloc fails.
+ *
+ *               CIRC_BUFF_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_init_file(circ_buff_ptr* circ_buff_pointer, const char* path,
+                                   int32_t size, uint32_t mode)
+{
+    /*basic pointer check; error handling*/
+    if(circ_buff_pointer==NULL||path==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    /*the mirror is two mappings of an anonymous file; it can not be ours*/
+    if(size<0||(uint32_t)size>(UINT32_C(1)<<30)||(mode&~CIRC_BUFF_MODE_ALL)!=0||
+       (mode&CIRC_BUFF_MODE_VMIRROR))
+         return CIRC_BUFF_BAD_DATA;
+
+    /*round the size up to a power of two as circ_buff_init_mode does*/
+    uint32_t total_size=(uint32_t)size;
+    if(total_size!=0&&(mode&CIRC_BUFF_MODE_POW2))
+    {
+         uint32_t rounded=1;
+         while(rounded<total_size)
+              rounded<<=1;
+         total_size=rounded;
+    }
+
+    int fd=open(path, O_RDWR|O_CREAT, 0600);
+    if(fd<0)
+         return CIRC_BUFF_FILE_OPEN_FAILED;
+
+    /*one user per file; the lock goes away with the descriptor, also when
+     *the process dies*/
+    if(flock(fd, LOCK_EX|LOCK_NB)!=0)
+    {
+         close(fd);
+         return (errno==EWOULDBLOCK)? CIRC_BUFF_IN_USE: CIRC_BUFF_FILE_OPEN_FAILED;
+    }
+
+    struct stat info;
+    if(fstat(fd, &info)!=0)
+    {
+         close(fd);
+         return CIRC_BUFF_FILE_OPEN_FAILED;
+    }
+
+    size_t page=(size_t)sysconf(_SC_PAGESIZE);
+    size_t map_size=(size_t)info.st_size;
+    int created=circ_buff_file_blank(fd, map_size);
+
+    if(created)
+    {
+         if(total_size==0)
+         {
+              close(fd);
+              return CIRC_BUFF_BAD_DATA;
+         }
+
+         map_size=page+(size_t)total_size*sizeof(uint32_t);
+         if(ftruncate(fd, (off_t)map_size)!=0)
+         {
+              close(fd);
+              return CIRC_BUFF_FILE_OPEN_FAILED;
+         }
+    }
+
+    void *map=mmap(NULL, map_size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    if(map==MAP_FAILED)
+    {
+         close(fd);
+         return CIRC_BUFF_FILE_OPEN_FAILED;
+    }
+
+    circ_buff_file_header *header=(circ_buff_file_header*)map;
+    circ_buff_code status;
+
+    if(created)
+         status=circ_buff_file_format(header, fd, total_size, mode, page);
+    else
+         status=circ_buff_file_check(header, map_size, total_size, mode);
+
+    if(status!=CIRC_BUFF_SUCCESS)
+    {
+         munmap(map, map_size);
+         close(fd);
+         return status;
+    }
+
+    /*assign the circ buff struct and the file handle on the heap*/
+    circ_buff_ptr cb=(circ_buff_ptr)malloc(sizeof(circ_buff));
+    circ_buff_file_ptr file=(circ_buff_file_ptr)malloc(sizeof(circ_buff_file));
+    if(cb==NULL||file==NULL)
+    {
+         free(cb);
+         free(file);
+         munmap(map, map_size);
+         close(fd);
+         return CIRC_BUFF_MALLOC_FAIL;
+    }
+
+    file->header=header;
+    file->map_size=map_size;
+    file->fd=fd;
+    file->close=circ_buff_file_close;
+
+    /*rebuild head and tail from the counters; the pow2 counters are their low
+     *32 bits, which keeps both the slot and the difference*/
+    uint64_t head_count=atomic_load(&header->head_count);
+    uint64_t tail_count=atomic_load(&header->tail_count);
+    uint32_t total=header->total_size;
+
+    cb->base=(uint32_t*)((char*)map+header->data_offset);
+    cb->total_size=total;
+    cb->size_occupied=(uint32_t)(tail_count-head_count);
+    cb->mode=mode;
+    cb->mask=(mode&CIRC_BUFF_MODE_POW2)? total-1: 0;
+    cb->head_count=(uint32_t)head_count;
+    cb->tail_count=(uint32_t)tail_count;
+    cb->dropped=header->dropped;
+    cb->head=cb->base+head_count%total;
+    cb->tail=cb->base+tail_count%total;
+    cb->file=file;
+    cb->stats=NULL;
+
+#ifdef CIRC_BUFF_STATS
+    if(circ_buff_stats_init(&cb->stats, total)!=CIRC_BUFF_SUCCESS)
+    {
+         free(cb);
+         free(file);
+         munmap(map, map_size);
+         close(fd);
+         return CIRC_BUFF_MALLOC_FAIL;
+    }
+
+    /*stamp the elements found in the file without counting them as writes*/
+    circ_buff_stats_on_write(cb->stats, (uint32_t)(head_count%total), cb->size_occupied, cb->size_occupied);
+    circ_buff_reset_stats(cb);
+#endif
+
+    *circ_buff_pointer=cb;
+
+    /*return successfully*/
+    return CIRC_BUFF_SUCCESS;
+}
+
+/*
+ * Function:     circ_buff_sync(circ_buff_ptr circ_buff_pointer)
+ * -----------------------------------------------------------------------------
+ * Description:  Checkpoints a file backed buffer: writes the dropped count to
+ *               the header and flushes the data region and then the header
+ *               to the file with msync, so the state at this call survives a
+ *               crash of the machine.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_BAD_DATA: The buffer is not file backed.
+ *
+ *               CIRC_BUFF_WRITE_FAILED: msync fails.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_sync(circ_buff_ptr circ_buff_pointer)
+{
+    /*basic pointer check; error handling*/
+    if(circ_buff_pointer==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    circ_buff_file_ptr file=circ_buff_pointer->file;
+    if(file==NULL)
+         return CIRC_BUFF_BAD_DATA;
+
+    circ_buff_file_header *header=file->header;
+    header->dropped=circ_buff_pointer->dropped;
+
+    /*data first, so the counters on disk never cover data that is not*/
+    if(msync((char*)header+header->data_offset, file->map_size-header->data_offset, MS_SYNC)!=0||
+       msync(header, header->data_offset, MS_SYNC)!=0)
+         return CIRC_BUFF_WRITE_FAILED;
+
+    return CIRC_BUFF_SUCCESS;
+}
+
+/*
+ * Function:     circ_buff_file_close(circ_buff_ptr circ_buff_pointer)
+ * -----------------------------------------------------------------------------
+ * Description:  Syncs, unmaps and closes the file of a file backed buffer.
+ *               Called by circ_buff_destroy, through the close member of the
+ *               file, in place of freeing base.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL or the buffer
+ *               is not file backed.
+ *
+ *               CIRC_BUFF_WRITE_FAILED: The final msync fails; the file is
+ *               still unmapped and closed.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_file_close(circ_buff_ptr circ_buff_pointer)
+{
+    /*basic pointer check*/
+    if(circ_buff_pointer==NULL||circ_buff_pointer->file==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    circ_buff_file_ptr file=circ_buff_pointer->file;
+    circ_buff_code status=circ_buff_sync(circ_buff_pointer);
+
+    /*closing the descriptor drops the lock*/
+    munmap(file->header, file->map_size);
+    close(file->fd);
+    free(file);
+
+    circ_buff_pointer->file=NULL;
+    circ_buff_pointer->base=NULL;
+
+    return status;
+}
@@ -0,0 +1,181 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         circ_buff_file.h
+ *
+ * Description:  Contains the structures and function prototypes of the file
+ *               backed mode of the circular buffer in circ_buff.h, defined in
+ *               circ_buff_file.c in the same directory. The data region and a
+ *               header are mapped from a file, so the contents and the head
+ *               and tail of the buffer outlive the process and a restarted
+ *               process reopens the buffer without reloading anything.
+ *               Such a buffer is used with the regular circ_buff_* functions.
+ *
+ * */
+
+#ifndef _CIRC_BUFF_FILE_H
+#define _CIRC_BUFF_FILE_H
+
+#include<stdint.h>
+#include<stddef.h>
+#include<stdatomic.h>
+#include "circ_buff.h"
+
+/*marks a circ_buff file; "CBFL"*/
+#define CIRC_BUFF_FILE_MAGIC   0x4c464243u
+#define CIRC_BUFF_FILE_VERSION 1u
+
+
+/*
+ * Structure:    circ_buff_file_header
+ * -----------------------------------------------------------------------------
+ * Description:  The first page of a circ_buff file; the data region starts at
+ *               data_offset, a whole number of pages into the file. checksum
+ *               covers the fields before it, which never change after the
+ *               file is created. magic and checksum are stored last when the
+ *               file is created, so while both are 0 the header is not yet
+ *               committed.
+ *               head_count and tail_count are free running element counters;
+ *               the slot of a counter is counter%total_size and the number of
+ *               elements is tail_count-head_count. Every operation that moves
+ *               head or tail stores the new counter right after the data, so
+ *               the header is consistent whenever the process stops. dropped
+ *               is written at each checkpoint.
+ *
+ * Usage:        Written by circ_buff.c and circ_buff_file.c only.
+ * ----------------------------------------------------------------------------
+ */
+typedef struct circ_buff_file_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t total_size;
+    uint32_t mode;
+    uint64_t data_offset;
+    uint64_t checksum;
+
+    _Alignas(CIRC_BUFF_CACHE_LINE) _Atomic uint64_t head_count;
+    _Atomic uint64_t tail_count;
+    uint64_t dropped;
+}circ_buff_file_header;
+
+
+/*
+ * Structure:    circ_buff_file
+ * -----------------------------------------------------------------------------
+ * Description:  The process side of a file backed buffer: the mapping of the
+ *               whole file, starting with its header, its size, the open
+ *               descriptor that holds the file's lock and the close function
+ *               circ_buff_destroy calls, so that circ_buff.c links without
+ *               circ_buff_file.c.
+ *
+ * Usage:        Written by circ_buff.c and circ_buff_file.c only.
+ * ----------------------------------------------------------------------------
+ */
+typedef struct circ_buff_file
+{
+    circ_buff_file_header *header;
+    size_t map_size;
+    int fd;
+    circ_buff_code (*close)(circ_buff_ptr circ_buff_pointer);
+}circ_buff_file;
+
+
+/*
+ * Function:     circ_buff_init_file(circ_buff_ptr* circ_buff_pointer, const char* path,
+ *                                   int32_t size, uint32_t mode)
+ * -----------------------------------------------------------------------------
+ * Description:  Opens the file backed buffer at path, creating the file if it
+ *               does not exist or has no committed header.
+ *
+ * Working:      A new file is sized to one header page plus the data region
+ *               and mapped shared. Its header is written with magic and
+ *               checksum last, after an msync and fsync of the other fields,
+ *               so a crash during creation leaves them 0; a file in that
+ *               state, or shorter than a header, is formatted again as a new
+ *               one. An existing file is mapped as it is after the
+ *               consistency check: the magic, version and checksum of the
+ *               header must match, the file must be large enough for the data
+ *               region, size and mode must match the ones it was created with
+ *               and the counters must describe at most total_size elements.
+ *               head and tail are then rebuilt from the counters.
+ *               The file is locked with flock while it is open, so a second
+ *               process can not use the same buffer at the same time.
+ *
+ * Usage:        Pass a pointer to the ptr of the circular buffer, the path of
+ *               the file, the number of elements and the mode as for
+ *               circ_buff_init_mode. size may be 0 to accept the size of an
+ *               existing file. CIRC_BUFF_MODE_VMIRROR is not supported.
+ *               Changes survive the process at any point; call
+ *               circ_buff_sync to make them survive a crash of the machine.
+ *               After such a crash the file holds at least the state of the
+ *               last sync; elements written after it may read back stale.
+ *               circ_buff_destroy syncs, unmaps and closes the file.
+ *               Elements found in the file are time stamped at the open
+ *               when statistics are on.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_BAD_DATA: size is out of range or 0 for a new file,
+ *               mode is unknown or has CIRC_BUFF_MODE_VMIRROR, or an existing
+ *               file fails the consistency check.
+ *
+ *               CIRC_BUFF_FILE_OPEN_FAILED: The file can not be opened,
+ *               sized or mapped.
+ *
+ *               CIRC_BUFF_WRITE_FAILED: The header of a new file can not be
+ *               flushed to disk.
+ *
+ *               CIRC_BUFF_IN_USE: Another open buffer holds the file.
+ *
+ *               CIRC_BUFF_MALLOC_FAIL: A call to malloc fails.
+ *
+ *               CIRC_BUFF_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_init_file(circ_buff_ptr* circ_buff_pointer, const char* path,
+                                   int32_t size, uint32_t mode);
+
+/*
+ * Function:     circ_buff_sync(circ_buff_ptr circ_buff_pointer)
+ * -----------------------------------------------------------------------------
+ * Description:  Checkpoints a file backed buffer: writes the dropped count to
+ *               the header and flushes the data region and then the header
+ *               to the file with msync, so the state at this call survives a
+ *               crash of the machine.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_BAD_DATA: The buffer is not file backed.
+ *
+ *               CIRC_BUFF_WRITE_FAILED: msync fails.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_sync(circ_buff_ptr circ_buff_pointer);
+
+/*
+ * Function:     circ_buff_file_close(circ_buff_ptr circ_buff_pointer)
+ * -----------------------------------------------------------------------------
+ * Description:  Syncs, unmaps and closes the file of a file backed buffer.
+ *               Called by circ_buff_destroy, through the close member of the
+ *               file, in place of freeing base.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL or the buffer
+ *               is not file backed.
+ *
+ *               CIRC_BUFF_WRITE_FAILED: The final msync fails; the file is
+ *               still unmapped and closed.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_file_close(circ_buff_ptr circ_buff_pointer);
+
+#endif
@@ -0,0 +1,224 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         circ_buff_mpmc.c
+ *
+ * Description:  Contains an implementation of a bounded circular buffer that
+ *               several producer and consumer threads can use concurrently
+ *               without a lock, using a sequence number per slot.
+ *
+ * */
+
+
+#include "circ_buff_mpmc.h"
+#include<stdint.h>
+#include<stdlib.h>
+#include<stdatomic.h>
+
+
+/*
+ * Function:     circ_buff_mpmc_init(circ_buff_mpmc_ptr* circ_buff_pointer, int32_t size)
+ * -----------------------------------------------------------------------------
+ * Description:  Allocates an mpmc circular buffer structure and 'size' slots on
+ *               the heap. The size is rounded up to the next power of two.
+ *
+ * Usage:        Pass a pointer to the ptr of the mpmc circular buffer and the
+ *               number of elements it should hold in that order.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is detected to be a
+ *               null. The function halts execution and returns w/o completion.
+ *
+ *               CIRC_BUFF_BAD_DATA: The size parameter is less than or equal
+ *               to zero or larger than 2^30.
+ *
+ *               CIRC_BUFF_MALLOC_FAIL: A memory allocation fails.
+ *
+ *               CIRC_BUFF_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_mpmc_init(circ_buff_mpmc_ptr* circ_buff_pointer, int32_t size)
+{
+    /*check if the pointer is NULL*/
+    if(circ_buff_pointer==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    /*sequence numbers are compared as signed 32 bit distances*/
+    if(size<=0||(uint32_t)size>(UINT32_C(1)<<30))
+         return CIRC_BUFF_BAD_DATA;
+
+    /*round the size up to a power of two*/
+    uint32_t total_size=1, index;
+    while(total_size<(uint32_t)size)
+         total_size<<=1;
+
+    /*the structure is cache line aligned, so malloc is not enough*/
+    circ_buff_mpmc_ptr cb=(circ_buff_mpmc_ptr)aligned_alloc(CIRC_BUFF_CACHE_LINE, sizeof(circ_buff_mpmc));
+    if(cb==NULL)
+         return CIRC_BUFF_MALLOC_FAIL;
+
+    cb->base=(circ_buff_mpmc_slot*)malloc((size_t)total_size*sizeof(circ_buff_mpmc_slot));
+    if(cb->base==NULL)
+    {
+         free(cb);
+         return CIRC_BUFF_MALLOC_FAIL;
+    }
+
+    cb->total_size=total_size;
+    cb->mask=total_size-1;
+
+    /*slot i is free for the producer that claims position i*/
+    for(index=0; index<total_size; index++)
+         atomic_init(&cb->base[index].seq, index);
+
+    atomic_init(&cb->head, 0);
+    atomic_init(&cb->tail, 0);
+
+    *circ_buff_pointer=cb;
+
+    /*return successfully*/
+    return CIRC_BUFF_SUCCESS;
+}
+
+
+/*
+ * Function:     circ_buff_mpmc_destroy(circ_buff_mpmc_ptr circ_buff_pointer)
+ * -----------------------------------------------------------------------------
+ * Description:  De-allocates the slots and the mpmc buffer structure.
+ *
+ * Usage:        Pass a pointer to the mpmc buffer once no thread uses it.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed to the function is a
+ *               NULL and is thus invalid.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_mpmc_destroy(circ_buff_mpmc_ptr circ_buff_pointer)
+{
+    /*basic pointer check*/
+    if(circ_buff_pointer==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    free(circ_buff_pointer->base);
+    circ_buff_pointer->base=NULL;
+    circ_buff_pointer->total_size=0;
+
+    free(circ_buff_pointer);
+
+    /*return safely*/
+    return CIRC_BUFF_SUCCESS;
+}
+
+
+/*
+ * Function:     circ_buff_mpmc_write(circ_buff_mpmc_ptr circ_buff_pointer, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Claims the next position at the tail and writes data to its
+ *               slot. Safe to call from any number of threads.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_FULL: The buffer is currently full and thus new
+ *               data can not be written to it.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               successfully.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_mpmc_write(circ_buff_mpmc_ptr circ_buff_pointer, uint32_t data)
+{
+    /*basic pointer check; error handling*/
+    if(circ_buff_pointer==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    circ_buff_mpmc_slot *slot;
+    uint32_t pos=atomic_load_explicit(&circ_buff_pointer->tail, memory_order_relaxed);
+
+    for(;;)
+    {
+         slot=&circ_buff_pointer->base[pos&circ_buff_pointer->mask];
+         uint32_t seq=atomic_load_explicit(&slot->seq, memory_order_acquire);
+         int32_t diff=(int32_t)(seq-pos);
+
+         /*slot is free- try to claim the position*/
+         if(diff==0)
+         {
+              if(atomic_compare_exchange_weak_explicit(&circ_buff_pointer->tail, &pos, pos+1,
+                                                       memory_order_relaxed, memory_order_relaxed))
+                   break;
+              /*the failed CAS reloaded pos; retry with it*/
+         }
+         /*slot still holds data from one lap ago- the buffer is full*/
+         else if(diff<0)
+              return CIRC_BUFF_FULL;
+         /*another producer got this position first*/
+         else
+              pos=atomic_load_explicit(&circ_buff_pointer->tail, memory_order_relaxed);
+    }
+
+    /*fill the slot, then hand it to the consumer of this position*/
+    slot->data=data;
+    atomic_store_explicit(&slot->seq, pos+1, memory_order_release);
+
+    /*return successfully*/
+    return CIRC_BUFF_SUCCESS;
+}
+
+
+/*
+ * Function:     circ_buff_mpmc_read(circ_buff_mpmc_ptr circ_buff_pointer, uint32_t* data)
+ * -----------------------------------------------------------------------------
+ * Description:  Claims the next position at the head and returns the data of
+ *               its slot in *data. Safe to call from any number of threads.
+ *
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_EMPTY: The buffer is currently empty and thus can
+ *               not return any data.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_mpmc_read(circ_buff_mpmc_ptr circ_buff_pointer, uint32_t* data)
+{
+    /*basic pointer check; error handling*/
+    if(circ_buff_pointer==NULL||data==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    circ_buff_mpmc_slot *slot;
+    uint32_t pos=atomic_load_explicit(&circ_buff_pointer->head, memory_order_relaxed);
+
+    for(;;)
+    {
+         slot=&circ_buff_pointer->base[pos&circ_buff_pointer->mask];
+         uint32_t seq=atomic_load_explicit(&slot->seq, memory_order_acquire);
+         int32_t diff=(int32_t)(seq-(pos+1));
+
+         /*slot holds data- try to claim the position*/
+         if(diff==0)
+         {
+              if(atomic_compare_exchange_weak_explicit(&circ_buff_pointer->head, &pos, pos+1,
+                                                       memory_order_relaxed, memory_order_relaxed))
+                   break;
+         }
+         /*the producer of this position has not written yet- empty*/
+         else if(diff<0)
+              return CIRC_BUFF_EMPTY;
+         /*another consumer got this position first*/
+         else
+              pos=atomic_load_explicit(&circ_buff_pointer->head, memory_order_relaxed);
+    }
+
+    /*copy the data, then free the slot for the producer one lap ahead*/
+    *data=slot->data;
+    atomic_store_explicit(&slot->seq, pos+circ_buff_pointer->total_size, memory_order_release);
+
+    /*return successfully*/
+    return CIRC_BUFF_SUCCESS;
+}
@@ -0,0 +1,145 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         circ_buff_mpmc.h
+ *
+ * Description:  Contains the structures and function prototypes of a bounded
+ *               multi producer/multi consumer circular buffer defined in
+ *               circ_buff_mpmc.c in the same directory. It reuses the status
+ *               codes of circ_buff.h.
+ *
+ * */
+
+#ifndef _CIRC_BUFF_MPMC_H
+#define _CIRC_BUFF_MPMC_H
+
+#include<stdint.h>
+#include<stdatomic.h>
+#include "circ_buff.h"
+
+
+/*
+ * Structure:    circ_buff_mpmc_slot
+ * -----------------------------------------------------------------------------
+ * Description:  One element of the mpmc buffer along with its sequence number.
+ *               A slot with seq==pos is free for the producer that claimed
+ *               position pos; a slot with seq==pos+1 holds data for the
+ *               consumer that claimed position pos.
+ * ----------------------------------------------------------------------------
+ */
+typedef struct circ_buff_mpmc_slot
+{
+    _Atomic uint32_t seq;
+    uint32_t data;
+}circ_buff_mpmc_slot;
+
+
+/*
+ * Structure:    circ_buff_mpmc
+ * -----------------------------------------------------------------------------
+ * Description:  A bounded circular buffer that any number of producer and
+ *               consumer threads can use at the same time (Vyukov's bounded
+ *               queue). Producers claim a position by a CAS on tail and
+ *               consumers by a CAS on head; the hand off of each element is
+ *               done through the sequence number of its slot, so producers
+ *               and consumers only contend with each other on the slot they
+ *               share and never on a global lock or counter.
+ *
+ * Usage:        Use the circ_buff_mpmc_* functions; do not access the members
+ *               directly.
+ * ----------------------------------------------------------------------------
+ */
+typedef struct circ_buff_mpmc *circ_buff_mpmc_ptr;
+
+typedef struct circ_buff_mpmc
+{
+    /*position the next producer claims*/
+    _Alignas(CIRC_BUFF_CACHE_LINE) _Atomic uint32_t tail;
+
+    /*position the next consumer claims*/
+    _Alignas(CIRC_BUFF_CACHE_LINE) _Atomic uint32_t head;
+
+    /*read only after init*/
+    _Alignas(CIRC_BUFF_CACHE_LINE) circ_buff_mpmc_slot *base;
+    uint32_t  total_size;
+    uint32_t  mask;
+}circ_buff_mpmc;
+
+
+/*
+ * Function:     circ_buff_mpmc_init(circ_buff_mpmc_ptr* circ_buff_pointer, int32_t size)
+ * -----------------------------------------------------------------------------
+ * Description:  Allocates an mpmc circular buffer structure and 'size' slots on
+ *               the heap. The size is rounded up to the next power of two.
+ *
+ * Usage:        Pass a pointer to the ptr of the mpmc circular buffer and the
+ *               number of elements it should hold in that order.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is detected to be a
+ *               null. The function halts execution and returns w/o completion.
+ *
+ *               CIRC_BUFF_BAD_DATA: The size parameter is less than or equal
+ *               to zero or larger than 2^30.
+ *
+ *               CIRC_BUFF_MALLOC_FAIL: A memory allocation fails.
+ *
+ *               CIRC_BUFF_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_mpmc_init(circ_buff_mpmc_ptr* circ_buff_pointer, int32_t size);
+
+/*
+ * Function:     circ_buff_mpmc_destroy(circ_buff_mpmc_ptr circ_buff_pointer)
+ * -----------------------------------------------------------------------------
+ * Description:  De-allocates the slots and the mpmc buffer structure.
+ *
+ * Usage:        Pass a pointer to the mpmc buffer once no thread uses it.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed to the function is a
+ *               NULL and is thus invalid.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_mpmc_destroy(circ_buff_mpmc_ptr circ_buff_pointer);
+
+/*
+ * Function:     circ_buff_mpmc_write(circ_buff_mpmc_ptr circ_buff_pointer, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Claims the next position at the tail and writes data to its
+ *               slot. Safe to call from any number of threads.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_FULL: The buffer is currently full and thus new
+ *               data can not be written to it.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               successfully.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_mpmc_write(circ_buff_mpmc_ptr circ_buff_pointer, uint32_t data);
+
+/*
+ * Function:     circ_buff_mpmc_read(circ_buff_mpmc_ptr circ_buff_pointer, uint32_t* data)
+ * -----------------------------------------------------------------------------
+ * Description:  Claims the next position at the head and returns the data of
+ *               its slot in *data. Safe to call from any number of threads.
+ *
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_EMPTY: The buffer is currently empty and thus can
+ *               not return any data.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_mpmc_read(circ_buff_mpmc_ptr circ_buff_pointer, uint32_t* data);
+
+#endif
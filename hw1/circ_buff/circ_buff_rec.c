@@ -0,0 +1,274 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         circ_buff_rec.c
+ *
+ * Description:  Contains an implementation of a ring of length prefixed
+ *               variable length records on top of the reserve/commit and
+ *               peek/release calls of the circular buffer.
+ *
+ * */
+
+
+#include "circ_buff_rec.h"
+#include<stdint.h>
+#include<stddef.h>
+#include<string.h>
+
+
+/*
+ * Function:     circ_buff_rec_free(circ_buff_ptr circ_buff_pointer)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the number of free words in the buffer, wherever they
+ *               are.
+ * ----------------------------------------------------------------------------
+ */
+static uint32_t circ_buff_rec_free(circ_buff_ptr circ_buff_pointer)
+{
+    if(circ_buff_pointer->mode&CIRC_BUFF_MODE_POW2)
+         return circ_buff_pointer->total_size-(circ_buff_pointer->tail_count-circ_buff_pointer->head_count);
+    else
+         return circ_buff_pointer->total_size-circ_buff_pointer->size_occupied;
+}
+
+
+/*
+ * Function:     circ_buff_rec_init(circ_buff_ptr* circ_buff_pointer, int32_t size, uint32_t mode)
+ * -----------------------------------------------------------------------------
+ * Description:  Allocates a circular buffer for records with room for 'size'
+ *               bytes, rounded up to whole words, in the given mode.
+ *
+ * Usage:        mode is as for circ_buff_init_mode, except that
+ *               CIRC_BUFF_MODE_OVERWRITE is not supported. With
+ *               CIRC_BUFF_MODE_VMIRROR no pad records are needed. A record
+ *               takes CIRC_BUFF_REC_WORDS(length) words; the largest record
+ *               that fits is (total_size-1)*4 bytes.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_BAD_DATA: size is less than or equal to zero, or
+ *               mode has unknown flags or CIRC_BUFF_MODE_OVERWRITE set.
+ *
+ *               CIRC_BUFF_MALLOC_FAIL: The buffer can not be allocated.
+ *
+ *               CIRC_BUFF_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_rec_init(circ_buff_ptr* circ_buff_pointer, int32_t size, uint32_t mode)
+{
+    /*basic pointer check; error handling*/
+    if(circ_buff_pointer==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    /*dropping the oldest words would cut records in half*/
+    if(size<=0||(mode&CIRC_BUFF_MODE_OVERWRITE))
+         return CIRC_BUFF_BAD_DATA;
+
+    int32_t words=(int32_t)(((uint32_t)size+sizeof(uint32_t)-1)/sizeof(uint32_t));
+
+    return circ_buff_init_mode(circ_buff_pointer, words, mode);
+}
+
+/*
+ * Function:     circ_buff_rec_write(circ_buff_ptr circ_buff_pointer, const void* data,
+ *                                   uint32_t length)
+ * -----------------------------------------------------------------------------
+ * Description:  Writes the 'length' bytes at data as one record.
+ *
+ * Working:      The record is copied to the region handed out by
+ *               circ_buff_reserve and committed in one go. If that region
+ *               ends at the end of base before the record does, the region
+ *               is committed as a pad record and the record goes to base;
+ *               in an empty buffer head and tail are simply moved to base.
+ *               The unused bytes of the last word are zeroed.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_BAD_DATA: The record is larger than the buffer can
+ *               ever hold.
+ *
+ *               CIRC_BUFF_FULL: There is not enough contiguous free space for
+ *               the record now; nothing was written.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               successfully.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_rec_write(circ_buff_ptr circ_buff_pointer, const void* data, uint32_t length)
+{
+    /*basic pointer check; error handling*/
+    if(circ_buff_pointer==NULL||(data==NULL&&length!=0))
+         return CIRC_BUFF_NULL_PTR;
+
+    if(length>CIRC_BUFF_REC_LENGTH_MASK||CIRC_BUFF_REC_WORDS(length)>circ_buff_pointer->total_size)
+         return CIRC_BUFF_BAD_DATA;
+
+    uint32_t words=CIRC_BUFF_REC_WORDS(length);
+    uint32_t *region, contiguous;
+    circ_buff_code status=circ_buff_reserve(circ_buff_pointer, &region, &contiguous);
+    if(status!=CIRC_BUFF_SUCCESS)
+         return status;
+
+    /*the record does not fit before the end of base (or before head)*/
+    if(contiguous<words)
+    {
+         uint32_t free_words=circ_buff_rec_free(circ_buff_pointer);
+
+         if(free_words==circ_buff_pointer->total_size)
+         {
+              /*empty: skip the end of base without leaving a record behind*/
+              circ_buff_commit_pad(circ_buff_pointer, contiguous);
+              circ_buff_release_pad(circ_buff_pointer, contiguous);
+         }
+         else
+         {
+              /*the region stops at head, or the free words at base are too
+               *few as well*/
+              if(free_words-contiguous<words)
+                   return CIRC_BUFF_FULL;
+
+              region[0]=CIRC_BUFF_REC_PAD|(uint32_t)((contiguous-1)*sizeof(uint32_t));
+              circ_buff_commit_pad(circ_buff_pointer, contiguous);
+         }
+
+         circ_buff_reserve(circ_buff_pointer, &region, &contiguous);
+    }
+
+    /*clear the padding of the last word, then copy; publish the whole
+     *record with one commit*/
+    region[words-1]=0;
+    if(length!=0)
+         memcpy(region+1, data, length);
+    region[0]=length;
+
+    return circ_buff_commit(circ_buff_pointer, words);
+}
+
+/*
+ * Function:     circ_buff_rec_peek(circ_buff_ptr circ_buff_pointer, const void** data,
+ *                                  uint32_t* length)
+ * -----------------------------------------------------------------------------
+ * Description:  Hands out the oldest record in place: *data points to its
+ *               payload and *length is set to its length. The record stays
+ *               in the buffer until circ_buff_rec_release is called. Pad
+ *               records in front of it are dropped.
+ *
+ * Usage:        The payload is word aligned and valid until the record is
+ *               released.
+ *
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_EMPTY: There is no record to peek at.
+ *
+ *               CIRC_BUFF_BAD_DATA: The header at head is corrupt; it
+ *               describes a record that does not fit the data behind it.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_rec_peek(circ_buff_ptr circ_buff_pointer, const void** data, uint32_t* length)
+{
+    /*basic pointer check; error handling*/
+    if(circ_buff_pointer==NULL||data==NULL||length==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    for(;;)
+    {
+         uint32_t *region, contiguous;
+         circ_buff_code status=circ_buff_peek(circ_buff_pointer, &region, &contiguous);
+         if(status!=CIRC_BUFF_SUCCESS)
+              return status;
+
+         /*records never wrap, so a whole one is always in the region*/
+         uint32_t words=CIRC_BUFF_REC_WORDS(region[0]&CIRC_BUFF_REC_LENGTH_MASK);
+         if(words>contiguous)
+              return CIRC_BUFF_BAD_DATA;
+
+         if(region[0]&CIRC_BUFF_REC_PAD)
+         {
+              circ_buff_release_pad(circ_buff_pointer, words);
+              continue;
+         }
+
+         *data=region+1;
+         *length=region[0];
+         return CIRC_BUFF_SUCCESS;
+    }
+}
+
+/*
+ * Function:     circ_buff_rec_release(circ_buff_ptr circ_buff_pointer)
+ * -----------------------------------------------------------------------------
+ * Description:  Drops the oldest record, typically once the consumer is done
+ *               with it after circ_buff_rec_peek.
+ *
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_EMPTY: There is no record to drop.
+ *
+ *               CIRC_BUFF_BAD_DATA: The header at head is corrupt.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_rec_release(circ_buff_ptr circ_buff_pointer)
+{
+    /*basic pointer check; error handling*/
+    if(circ_buff_pointer==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    const void *data;
+    uint32_t length;
+    circ_buff_code status=circ_buff_rec_peek(circ_buff_pointer, &data, &length);
+    if(status!=CIRC_BUFF_SUCCESS)
+         return status;
+
+    return circ_buff_release(circ_buff_pointer, CIRC_BUFF_REC_WORDS(length));
+}
+
+/*
+ * Function:     circ_buff_rec_read(circ_buff_ptr circ_buff_pointer, void* data,
+ *                                  uint32_t size, uint32_t* length)
+ * -----------------------------------------------------------------------------
+ * Description:  Copies the oldest record to data, which has room for 'size'
+ *               bytes, sets *length to its length and drops it.
+ *
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_EMPTY: There is no record to read.
+ *
+ *               CIRC_BUFF_BAD_DATA: The record is longer than size; *length
+ *               is set to its length and it stays in the buffer. *length is
+ *               0 if the header at head is corrupt.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_rec_read(circ_buff_ptr circ_buff_pointer, void* data, uint32_t size, uint32_t* length)
+{
+    /*basic pointer check; error handling*/
+    if(circ_buff_pointer==NULL||length==NULL||(data==NULL&&size!=0))
+         return CIRC_BUFF_NULL_PTR;
+
+    const void *record;
+    *length=0;
+    circ_buff_code status=circ_buff_rec_peek(circ_buff_pointer, &record, length);
+    if(status!=CIRC_BUFF_SUCCESS)
+         return status;
+
+    if(*length>size)
+         return CIRC_BUFF_BAD_DATA;
+
+    if(*length!=0)
+         memcpy(data, record, *length);
+
+    return circ_buff_release(circ_buff_pointer, CIRC_BUFF_REC_WORDS(*length));
+}
@@ -0,0 +1,165 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         circ_buff_rec.h
+ *
+ * Description:  Contains the function prototypes of a record ring, defined in
+ *               circ_buff_rec.c in the same directory, that stores messages
+ *               of any length in a circular buffer from circ_buff.h. Records
+ *               are copied into the words of the buffer in place through
+ *               circ_buff_reserve/circ_buff_commit and handed out in place
+ *               through circ_buff_peek/circ_buff_release, so mixed size
+ *               messages are packed densely without a malloc per message.
+ *
+ *               A record is a one word header holding the length of the
+ *               payload in bytes, followed by the payload padded to whole
+ *               words, so every header is word aligned. A record never
+ *               wraps: if it does not fit before the end of base, the rest
+ *               of base is filled with a pad record (the CIRC_BUFF_REC_PAD
+ *               bit set in its header) that readers skip, and the record
+ *               starts at base. A record is committed only once it has been
+ *               copied in completely, so a reader never sees part of one.
+ *               Pads are moved with circ_buff_commit_pad/circ_buff_release_pad,
+ *               so the statistics of the buffer only count record words.
+ *
+ *               Any circ_buff can hold records as long as only the
+ *               circ_buff_rec_* functions are used on it, e.g. one opened
+ *               with circ_buff_init_file. circ_buff_destroy frees it.
+ *
+ * */
+
+#ifndef _CIRC_BUFF_REC_H
+#define _CIRC_BUFF_REC_H
+
+#include<stdint.h>
+#include "circ_buff.h"
+
+/*header bit of a pad record; the other bits hold the length in bytes*/
+#define CIRC_BUFF_REC_PAD         0x80000000u
+#define CIRC_BUFF_REC_LENGTH_MASK 0x7fffffffu
+
+/*words taken by a record with 'length' bytes of payload, header included*/
+#define CIRC_BUFF_REC_WORDS(length) (1+((uint32_t)(length)+(uint32_t)sizeof(uint32_t)-1)/(uint32_t)sizeof(uint32_t))
+
+
+/*
+ * Function:     circ_buff_rec_init(circ_buff_ptr* circ_buff_pointer, int32_t size, uint32_t mode)
+ * -----------------------------------------------------------------------------
+ * Description:  Allocates a circular buffer for records with room for 'size'
+ *               bytes, rounded up to whole words, in the given mode.
+ *
+ * Usage:        mode is as for circ_buff_init_mode, except that
+ *               CIRC_BUFF_MODE_OVERWRITE is not supported. With
+ *               CIRC_BUFF_MODE_VMIRROR no pad records are needed. A record
+ *               takes CIRC_BUFF_REC_WORDS(length) words; the largest record
+ *               that fits is (total_size-1)*4 bytes.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_BAD_DATA: size is less than or equal to zero, or
+ *               mode has unknown flags or CIRC_BUFF_MODE_OVERWRITE set.
+ *
+ *               CIRC_BUFF_MALLOC_FAIL: The buffer can not be allocated.
+ *
+ *               CIRC_BUFF_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_rec_init(circ_buff_ptr* circ_buff_pointer, int32_t size, uint32_t mode);
+
+/*
+ * Function:     circ_buff_rec_write(circ_buff_ptr circ_buff_pointer, const void* data,
+ *                                   uint32_t length)
+ * -----------------------------------------------------------------------------
+ * Description:  Writes the 'length' bytes at data as one record.
+ *
+ * Working:      The record is copied to the region handed out by
+ *               circ_buff_reserve and committed in one go. If that region
+ *               ends at the end of base before the record does, the region
+ *               is committed as a pad record and the record goes to base;
+ *               in an empty buffer head and tail are simply moved to base.
+ *               The unused bytes of the last word are zeroed.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_BAD_DATA: The record is larger than the buffer can
+ *               ever hold.
+ *
+ *               CIRC_BUFF_FULL: There is not enough contiguous free space for
+ *               the record now; nothing was written.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               successfully.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_rec_write(circ_buff_ptr circ_buff_pointer, const void* data, uint32_t length);
+
+/*
+ * Function:     circ_buff_rec_read(circ_buff_ptr circ_buff_pointer, void* data,
+ *                                  uint32_t size, uint32_t* length)
+ * -----------------------------------------------------------------------------
+ * Description:  Copies the oldest record to data, which has room for 'size'
+ *               bytes, sets *length to its length and drops it.
+ *
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_EMPTY: There is no record to read.
+ *
+ *               CIRC_BUFF_BAD_DATA: The record is longer than size; *length
+ *               is set to its length and it stays in the buffer. *length is
+ *               0 if the header at head is corrupt.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_rec_read(circ_buff_ptr circ_buff_pointer, void* data, uint32_t size, uint32_t* length);
+
+/*
+ * Function:     circ_buff_rec_peek(circ_buff_ptr circ_buff_pointer, const void** data,
+ *                                  uint32_t* length)
+ * -----------------------------------------------------------------------------
+ * Description:  Hands out the oldest record in place: *data points to its
+ *               payload and *length is set to its length. The record stays
+ *               in the buffer until circ_buff_rec_release is called. Pad
+ *               records in front of it are dropped.
+ *
+ * Usage:        The payload is word aligned and valid until the record is
+ *               released.
+ *
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_EMPTY: There is no record to peek at.
+ *
+ *               CIRC_BUFF_BAD_DATA: The header at head is corrupt; it
+ *               describes a record that does not fit the data behind it.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_rec_peek(circ_buff_ptr circ_buff_pointer, const void** data, uint32_t* length);
+
+/*
+ * Function:     circ_buff_rec_release(circ_buff_ptr circ_buff_pointer)
+ * -----------------------------------------------------------------------------
+ * Description:  Drops the oldest record, typically once the consumer is done
+ *               with it after circ_buff_rec_peek.
+ *
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_EMPTY: There is no record to drop.
+ *
+ *               CIRC_BUFF_BAD_DATA: The header at head is corrupt.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_rec_release(circ_buff_ptr circ_buff_pointer);
+
+#endif
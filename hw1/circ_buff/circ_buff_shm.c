@@ -0,0 +1,736 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         circ_buff_shm.c
+ *
+ * Description:  Contains an implementation of a single producer/single
+ *               consumer circular buffer in a named POSIX shared memory
+ *               segment that a producer process and a consumer process attach
+ *               to by name.
+ *
+ * */
+
+
+/*shm_open, ftruncate, posix_fallocate and kill are POSIX*/
+#define _GNU_SOURCE
+
+#include "circ_buff_shm.h"
+#include<stdint.h>
+#include<stdlib.h>
+#include<string.h>
+#include<stdatomic.h>
+#include<errno.h>
+#include<time.h>
+#include<fcntl.h>
+#include<signal.h>
+#include<unistd.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+
+
+/*
+ * Function:     circ_buff_shm_pid_alive(int32_t pid)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns 1 if a process with this pid exists. EPERM means it
+ *               exists but belongs to another user.
+ * ----------------------------------------------------------------------------
+ */
+static int circ_buff_shm_pid_alive(int32_t pid)
+{
+    return pid!=0&&(kill((pid_t)pid, 0)==0||errno==EPERM);
+}
+
+/*
+ * Function:     circ_buff_shm_pause(void)
+ * -----------------------------------------------------------------------------
+ * Description:  Sleeps for a millisecond while waiting for the creator of a
+ *               segment; only used on the attach path.
+ * ----------------------------------------------------------------------------
+ */
+static void circ_buff_shm_pause(void)
+{
+    struct timespec pause={0, 1000000L};
+
+    nanosleep(&pause, NULL);
+}
+
+/*
+ * Function:     circ_buff_shm_pid_slot(circ_buff_shm_ctrl* ctrl, circ_buff_shm_role role)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the pid field of the given side.
+ * ----------------------------------------------------------------------------
+ */
+static _Atomic int32_t* circ_buff_shm_pid_slot(circ_buff_shm_ctrl* ctrl, circ_buff_shm_role role)
+{
+    return (role==CIRC_BUFF_SHM_PRODUCER)? &ctrl->producer_pid: &ctrl->consumer_pid;
+}
+
+/*
+ * Function:     circ_buff_shm_claim(circ_buff_shm_ctrl* ctrl, circ_buff_shm_role role)
+ * -----------------------------------------------------------------------------
+ * Description:  Stores our pid in the given side if it is free or held by a
+ *               process that no longer exists. Returns CIRC_BUFF_IN_USE if a
+ *               live process, this one included, holds it.
+ * ----------------------------------------------------------------------------
+ */
+static circ_buff_code circ_buff_shm_claim(circ_buff_shm_ctrl* ctrl, circ_buff_shm_role role)
+{
+    _Atomic int32_t *slot=circ_buff_shm_pid_slot(ctrl, role);
+    int32_t me=(int32_t)getpid(), owner;
+
+    for(;;)
+    {
+         owner=atomic_load(slot);
+
+         if(owner!=0&&circ_buff_shm_pid_alive(owner))
+              return CIRC_BUFF_IN_USE;
+
+         /*free, or left behind by a dead process: the counters it published
+          *are in the segment, so the new owner just carries on from them*/
+         if(atomic_compare_exchange_strong(slot, &owner, me))
+              return CIRC_BUFF_SUCCESS;
+    }
+}
+
+/*
+ * Function:     circ_buff_shm_open(const char* name, uint32_t total_size, size_t* map_size,
+ *                                  int* created)
+ * -----------------------------------------------------------------------------
+ * Description:  Creates the segment with room for total_size elements, or
+ *               opens it if it exists (total_size 0 only opens). Returns the
+ *               file descriptor, or -1 with errno set, and the size to map
+ *               in *map_size.
+ * ----------------------------------------------------------------------------
+ */
+static int circ_buff_shm_open(const char* name, uint32_t total_size, size_t* map_size, int* created)
+{
+    struct stat info;
+    int fd, waited;
+
+    *map_size=sizeof(circ_buff_shm_ctrl)+(size_t)total_size*sizeof(uint32_t);
+    *created=0;
+
+    if(total_size!=0)
+    {
+         fd=shm_open(name, O_RDWR|O_CREAT|O_EXCL, 0600);
+         if(fd>=0)
+         {
+              if(ftruncate(fd, (off_t)*map_size)!=0)
+              {
+                   close(fd);
+                   shm_unlink(name);
+                   return -1;
+              }
+              *created=1;
+              return fd;
+         }
+         if(errno!=EEXIST)
+              return -1;
+    }
+
+    fd=shm_open(name, O_RDWR, 0);
+    if(fd<0)
+         return -1;
+
+    /*the creator may not have sized it yet*/
+    for(waited=0; ; waited++)
+    {
+         if(fstat(fd, &info)!=0)
+         {
+              close(fd);
+              return -1;
+         }
+         if((size_t)info.st_size>=sizeof(circ_buff_shm_ctrl)||waited>=CIRC_BUFF_SHM_ATTACH_TIMEOUT_MS)
+              break;
+         circ_buff_shm_pause();
+    }
+
+    /*still empty: the creator died before sizing it. Grow it to our size
+     *for the stale check in attach; posix_fallocate never shrinks, so two
+     *processes doing this at once can not cut each other's mapping short*/
+    if((size_t)info.st_size<sizeof(circ_buff_shm_ctrl)&&total_size!=0)
+    {
+         int error=posix_fallocate(fd, 0, (off_t)*map_size);
+         if(error!=0||fstat(fd, &info)!=0)
+         {
+              close(fd);
+              if(error!=0)
+                   errno=error;
+              return -1;
+         }
+    }
+
+    *map_size=(size_t)info.st_size;
+
+    return fd;
+}
+
+/*
+ * Function:     circ_buff_shm_init_ctrl(circ_buff_shm_ctrl* ctrl, uint32_t total_size)
+ * -----------------------------------------------------------------------------
+ * Description:  Fills in the control block of an empty buffer of total_size
+ *               elements and publishes it by storing magic last.
+ * ----------------------------------------------------------------------------
+ */
+static void circ_buff_shm_init_ctrl(circ_buff_shm_ctrl* ctrl, uint32_t total_size)
+{
+    ctrl->version=CIRC_BUFF_SHM_VERSION;
+    ctrl->total_size=total_size;
+    ctrl->mask=total_size-1;
+    ctrl->data_offset=sizeof(circ_buff_shm_ctrl);
+
+    /*zero already in a new segment, not necessarily in a stale one*/
+    atomic_store_explicit(&ctrl->tail, 0, memory_order_relaxed);
+    atomic_store_explicit(&ctrl->head, 0, memory_order_relaxed);
+    atomic_store_explicit(&ctrl->producer_pid, 0, memory_order_relaxed);
+    atomic_store_explicit(&ctrl->consumer_pid, 0, memory_order_relaxed);
+
+    atomic_store_explicit(&ctrl->magic, CIRC_BUFF_SHM_MAGIC, memory_order_release);
+}
+
+/*
+ * Function:     circ_buff_shm_wait(circ_buff_shm_ctrl* ctrl, int32_t* owner)
+ * -----------------------------------------------------------------------------
+ * Description:  Waits for the creator to publish the control block. Returns
+ *               CIRC_BUFF_SUCCESS once it has, or CIRC_BUFF_TIMEOUT with the
+ *               init_pid seen in *owner if the segment is stale: its
+ *               initialiser has died, or none stored its pid in time.
+ *               Returns CIRC_BUFF_BAD_DATA if the segment is not a shared
+ *               buffer or a live initialiser did not finish in time.
+ * ----------------------------------------------------------------------------
+ */
+static circ_buff_code circ_buff_shm_wait(circ_buff_shm_ctrl* ctrl, int32_t* owner)
+{
+    uint32_t magic;
+    int waited;
+
+    for(waited=0; (magic=atomic_load_explicit(&ctrl->magic, memory_order_acquire))!=CIRC_BUFF_SHM_MAGIC; waited++)
+    {
+         /*magic is only ever stored once, with its final value*/
+         if(magic!=0)
+              return CIRC_BUFF_BAD_DATA;
+
+         *owner=atomic_load(&ctrl->init_pid);
+         if(*owner!=0&&!circ_buff_shm_pid_alive(*owner))
+              return CIRC_BUFF_TIMEOUT;
+
+         if(waited>=CIRC_BUFF_SHM_ATTACH_TIMEOUT_MS)
+              return (*owner==0)? CIRC_BUFF_TIMEOUT: CIRC_BUFF_BAD_DATA;
+         circ_buff_shm_pause();
+    }
+
+    return CIRC_BUFF_SUCCESS;
+}
+
+/*
+ * Function:     circ_buff_shm_check(circ_buff_shm_ctrl* ctrl, size_t map_size, uint32_t total_size)
+ * -----------------------------------------------------------------------------
+ * Description:  Waits for the control block of an existing segment and checks
+ *               that it describes a buffer of total_size elements (any size
+ *               if 0) that fits the mapping. A stale segment is initialised
+ *               again for total_size elements if that fits the mapping; the
+ *               process whose compare and swap on init_pid wins does it and
+ *               the others wait for it.
+ * ----------------------------------------------------------------------------
+ */
+static circ_buff_code circ_buff_shm_check(circ_buff_shm_ctrl* ctrl, size_t map_size, uint32_t total_size)
+{
+    circ_buff_code status;
+    int32_t owner;
+
+    while((status=circ_buff_shm_wait(ctrl, &owner))==CIRC_BUFF_TIMEOUT)
+    {
+         if(total_size==0||map_size<sizeof(circ_buff_shm_ctrl)+(size_t)total_size*sizeof(uint32_t))
+              return CIRC_BUFF_BAD_DATA;
+
+         if(atomic_compare_exchange_strong(&ctrl->init_pid, &owner, (int32_t)getpid()))
+         {
+              circ_buff_shm_init_ctrl(ctrl, total_size);
+              return CIRC_BUFF_SUCCESS;
+         }
+    }
+
+    if(status!=CIRC_BUFF_SUCCESS)
+         return status;
+
+    if(ctrl->version!=CIRC_BUFF_SHM_VERSION||ctrl->total_size==0||
+       (ctrl->total_size&(ctrl->total_size-1))!=0||ctrl->mask!=ctrl->total_size-1||
+       ctrl->data_offset<sizeof(circ_buff_shm_ctrl)||
+       ctrl->data_offset+(uint64_t)ctrl->total_size*sizeof(uint32_t)>map_size)
+         return CIRC_BUFF_BAD_DATA;
+
+    if(total_size!=0&&total_size!=ctrl->total_size)
+         return CIRC_BUFF_BAD_DATA;
+
+    return CIRC_BUFF_SUCCESS;
+}
+
+
+/*
+ * Function:     circ_buff_shm_attach(circ_buff_shm_ptr* circ_buff_pointer, const char* name,
+ *                                    int32_t size, circ_buff_shm_role role)
+ * -----------------------------------------------------------------------------
+ * Description:  Attaches to the shared buffer 'name' as the producer or the
+ *               consumer, creating the segment if it does not exist yet.
+ *
+ * Working:      The process that creates the segment sizes and initialises
+ *               it; a process that finds it already there waits up to
+ *               CIRC_BUFF_SHM_ATTACH_TIMEOUT_MS for the creator to finish and
+ *               checks the control block. If the creator died before it was
+ *               done (the magic is still 0 and its init_pid is dead, or it
+ *               never stored one within the timeout), the segment is stale:
+ *               a process that passed a size grows it to that size if it is
+ *               empty and initialises it again. The side is then claimed by
+ *               storing our pid in it. If another process holds the side,
+ *               the claim fails unless that process no longer exists; then
+ *               its side is taken over and the buffer carries on from the
+ *               counters it left behind, so nothing it had published is lost.
+ *
+ * Usage:        Pass a pointer to the circ_buff_shm_ptr that should point to
+ *               the new handle, a name of the form "/some_name" as for
+ *               shm_open, the number of elements (rounded up to a power of
+ *               two; 0 accepts the size of an existing segment) and the side.
+ *               Either side may attach first.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_BAD_DATA: size is negative, larger than 2^30, 0 for
+ *               a segment that does not exist, or different from the size of
+ *               the existing segment; or the segment is not a shared buffer,
+ *               was not initialised in time by a live creator, or is stale
+ *               and size is 0 or too large for it.
+ *
+ *               CIRC_BUFF_FILE_OPEN_FAILED: The segment can not be created,
+ *               opened, sized or mapped.
+ *
+ *               CIRC_BUFF_IN_USE: A live process is attached as this side.
+ *
+ *               CIRC_BUFF_MALLOC_FAIL: The handle can not be allocated.
+ *
+ *               CIRC_BUFF_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_shm_attach(circ_buff_shm_ptr* circ_buff_pointer, const char* name,
+                                    int32_t size, circ_buff_shm_role role)
+{
+    /*basic pointer check; error handling*/
+    if(circ_buff_pointer==NULL||name==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    if(size<0||(uint32_t)size>(UINT32_C(1)<<30)||
+       (role!=CIRC_BUFF_SHM_PRODUCER&&role!=CIRC_BUFF_SHM_CONSUMER))
+         return CIRC_BUFF_BAD_DATA;
+
+    /*round the size up to a power of two; 0 stays 0 (attach only)*/
+    uint32_t total_size=0;
+    if(size>0)
+         for(total_size=1; total_size<(uint32_t)size; total_size<<=1)
+              ;
+
+    size_t map_size;
+    int created;
+    int fd=circ_buff_shm_open(name, total_size, &map_size, &created);
+    if(fd<0)
+         return (errno==ENOENT&&total_size==0)? CIRC_BUFF_BAD_DATA: CIRC_BUFF_FILE_OPEN_FAILED;
+
+    if(map_size<sizeof(circ_buff_shm_ctrl))
+    {
+         close(fd);
+         return CIRC_BUFF_BAD_DATA;
+    }
+
+    /*the mapping stays valid after the descriptor is closed*/
+    void *map=mmap(NULL, map_size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if(map==MAP_FAILED)
+    {
+         if(created)
+              shm_unlink(name);
+         return CIRC_BUFF_FILE_OPEN_FAILED;
+    }
+
+    circ_buff_shm_ctrl *ctrl=(circ_buff_shm_ctrl*)map;
+    circ_buff_code status;
+
+    if(created)
+    {
+         /*our pid first, so that attachers can tell if we die before the
+          *magic is stored*/
+         atomic_store(&ctrl->init_pid, (int32_t)getpid());
+         circ_buff_shm_init_ctrl(ctrl, total_size);
+    }
+    else if((status=circ_buff_shm_check(ctrl, map_size, total_size))!=CIRC_BUFF_SUCCESS)
+    {
+         munmap(map, map_size);
+         return status;
+    }
+
+    if((status=circ_buff_shm_claim(ctrl, role))!=CIRC_BUFF_SUCCESS)
+    {
+         munmap(map, map_size);
+         return status;
+    }
+
+    circ_buff_shm_ptr cb=(circ_buff_shm_ptr)malloc(sizeof(circ_buff_shm));
+    if(cb==NULL)
+    {
+         atomic_store(circ_buff_shm_pid_slot(ctrl, role), 0);
+         munmap(map, map_size);
+         return CIRC_BUFF_MALLOC_FAIL;
+    }
+
+    cb->ctrl=ctrl;
+    cb->base=(uint32_t*)((char*)map+ctrl->data_offset);
+    cb->map_size=map_size;
+    cb->role=role;
+    cb->index_cache=(role==CIRC_BUFF_SHM_PRODUCER)? atomic_load(&ctrl->head): atomic_load(&ctrl->tail);
+
+    *circ_buff_pointer=cb;
+
+    /*return successfully*/
+    return CIRC_BUFF_SUCCESS;
+}
+
+
+/*
+ * Function:     circ_buff_shm_detach(circ_buff_shm_ptr circ_buff_pointer)
+ * -----------------------------------------------------------------------------
+ * Description:  Gives up this process's side, unmaps the segment and frees
+ *               the handle. The segment and the data in it stay, so the same
+ *               or another process can attach again.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_shm_detach(circ_buff_shm_ptr circ_buff_pointer)
+{
+    /*basic pointer check*/
+    if(circ_buff_pointer==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    /*only give the side up if a new owner has not taken it over from us*/
+    int32_t me=(int32_t)getpid();
+    atomic_compare_exchange_strong(circ_buff_shm_pid_slot(circ_buff_pointer->ctrl, circ_buff_pointer->role),
+                                   &me, 0);
+
+    munmap(circ_buff_pointer->ctrl, circ_buff_pointer->map_size);
+    free(circ_buff_pointer);
+
+    /*return safely*/
+    return CIRC_BUFF_SUCCESS;
+}
+
+
+/*
+ * Function:     circ_buff_shm_unlink(const char* name)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes the segment 'name'. Processes still attached keep
+ *               their mapping until they detach.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_FILE_OPEN_FAILED: shm_unlink fails, e.g. the
+ *               segment does not exist.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_shm_unlink(const char* name)
+{
+    /*basic pointer check*/
+    if(name==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    if(shm_unlink(name)!=0)
+         return CIRC_BUFF_FILE_OPEN_FAILED;
+
+    return CIRC_BUFF_SUCCESS;
+}
+
+
+/*
+ * Function:     circ_buff_shm_peer_alive(circ_buff_shm_ptr circ_buff_pointer, int* alive)
+ * -----------------------------------------------------------------------------
+ * Description:  Sets *alive to 1 if a live process is attached as the other
+ *               side and to 0 if none is or it has died. A consumer that
+ *               finds the buffer empty for long can use this to tell a slow
+ *               producer from a dead one.
+ *
+ * Usage:        A pid can be reused after its process dies, so a peer that
+ *               died long ago may look alive.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_shm_peer_alive(circ_buff_shm_ptr circ_buff_pointer, int* alive)
+{
+    /*basic pointer check; error handling*/
+    if(circ_buff_pointer==NULL||alive==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    circ_buff_shm_role peer=(circ_buff_pointer->role==CIRC_BUFF_SHM_PRODUCER)?
+                            CIRC_BUFF_SHM_CONSUMER: CIRC_BUFF_SHM_PRODUCER;
+
+    *alive=circ_buff_shm_pid_alive(atomic_load(circ_buff_shm_pid_slot(circ_buff_pointer->ctrl, peer)));
+
+    return CIRC_BUFF_SUCCESS;
+}
+
+
+/*
+ * Function:     circ_buff_shm_write(circ_buff_shm_ptr circ_buff_pointer, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Writes data at the tail of the buffer and publishes it to the
+ *               consumer with a release store of tail.
+ *
+ * Usage:        Call only on a handle attached as the producer.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_BAD_DATA: The handle is not attached as the
+ *               producer.
+ *
+ *               CIRC_BUFF_FULL: The buffer is currently full and thus new
+ *               data can not be written to it.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               successfully.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_shm_write(circ_buff_shm_ptr circ_buff_pointer, uint32_t data)
+{
+    /*basic pointer check; error handling*/
+    if(circ_buff_pointer==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    /*only the producer may move tail*/
+    if(circ_buff_pointer->role!=CIRC_BUFF_SHM_PRODUCER)
+         return CIRC_BUFF_BAD_DATA;
+
+    circ_buff_shm_ctrl *ctrl=circ_buff_pointer->ctrl;
+
+    /*only the producer stores to tail, so a relaxed load sees our own value*/
+    uint32_t tail=atomic_load_explicit(&ctrl->tail, memory_order_relaxed);
+
+    /*looks full with the cached head- refresh it from the consumer's line*/
+    if(tail-circ_buff_pointer->index_cache==ctrl->total_size)
+    {
+         circ_buff_pointer->index_cache=atomic_load_explicit(&ctrl->head, memory_order_acquire);
+
+         if(tail-circ_buff_pointer->index_cache==ctrl->total_size)
+              return CIRC_BUFF_FULL;
+    }
+
+    /*fill the slot, then publish it*/
+    circ_buff_pointer->base[tail&ctrl->mask]=data;
+    atomic_store_explicit(&ctrl->tail, tail+1, memory_order_release);
+
+    /*return successfully*/
+    return CIRC_BUFF_SUCCESS;
+}
+
+
+/*
+ * Function:     circ_buff_shm_read(circ_buff_shm_ptr circ_buff_pointer, uint32_t* data)
+ * -----------------------------------------------------------------------------
+ * Description:  Reads the element at the head of the buffer into *data and
+ *               hands the slot back to the producer with a release store of
+ *               head.
+ *
+ * Usage:        Call only on a handle attached as the consumer.
+ *
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_BAD_DATA: The handle is not attached as the
+ *               consumer.
+ *
+ *               CIRC_BUFF_EMPTY: The buffer is currently empty and thus can
+ *               not return any data.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_shm_read(circ_buff_shm_ptr circ_buff_pointer, uint32_t* data)
+{
+    /*basic pointer check; error handling*/
+    if(circ_buff_pointer==NULL||data==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    /*only the consumer may move head*/
+    if(circ_buff_pointer->role!=CIRC_BUFF_SHM_CONSUMER)
+         return CIRC_BUFF_BAD_DATA;
+
+    circ_buff_shm_ctrl *ctrl=circ_buff_pointer->ctrl;
+
+    /*only the consumer stores to head*/
+    uint32_t head=atomic_load_explicit(&ctrl->head, memory_order_relaxed);
+
+    /*looks empty with the cached tail- refresh it from the producer's line*/
+    if(head==circ_buff_pointer->index_cache)
+    {
+         circ_buff_pointer->index_cache=atomic_load_explicit(&ctrl->tail, memory_order_acquire);
+
+         if(head==circ_buff_pointer->index_cache)
+              return CIRC_BUFF_EMPTY;
+    }
+
+    /*copy the element out before the slot is handed back*/
+    *data=circ_buff_pointer->base[head&ctrl->mask];
+    atomic_store_explicit(&ctrl->head, head+1, memory_order_release);
+
+    /*return successfully*/
+    return CIRC_BUFF_SUCCESS;
+}
+
+
+/*
+ * Function:     circ_buff_shm_write_n(circ_buff_shm_ptr circ_buff_pointer, const uint32_t* data,
+ *                                     uint32_t count, uint32_t* written)
+ * -----------------------------------------------------------------------------
+ * Description:  Writes up to count elements from the data array with at most
+ *               two memcpy calls and publishes them with one store of tail.
+ *
+ * Usage:        Call only on a handle attached as the producer. *written is
+ *               set to the number of elements actually written.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_BAD_DATA: The handle is not attached as the
+ *               producer.
+ *
+ *               CIRC_BUFF_FULL: The buffer is full and count is non-zero;
+ *               nothing was written.
+ *
+ *               CIRC_BUFF_SUCCESS: *written elements were written; this may
+ *               be less than count if the buffer filled up.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_shm_write_n(circ_buff_shm_ptr circ_buff_pointer, const uint32_t* data,
+                                     uint32_t count, uint32_t* written)
+{
+    /*basic pointer check; error handling*/
+    if(circ_buff_pointer==NULL||data==NULL||written==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    /*only the producer may move tail*/
+    if(circ_buff_pointer->role!=CIRC_BUFF_SHM_PRODUCER)
+         return CIRC_BUFF_BAD_DATA;
+
+    circ_buff_shm_ctrl *ctrl=circ_buff_pointer->ctrl;
+    uint32_t tail=atomic_load_explicit(&ctrl->tail, memory_order_relaxed);
+    uint32_t free_space=ctrl->total_size-(tail-circ_buff_pointer->index_cache);
+
+    /*not enough room with the cached head- refresh it*/
+    if(free_space<count||free_space==0)
+    {
+         circ_buff_pointer->index_cache=atomic_load_explicit(&ctrl->head, memory_order_acquire);
+         free_space=ctrl->total_size-(tail-circ_buff_pointer->index_cache);
+    }
+
+    if(count>free_space)
+         count=free_space;
+
+    *written=count;
+
+    if(count==0)
+         return free_space==0? CIRC_BUFF_FULL: CIRC_BUFF_SUCCESS;
+
+    /*first piece up to the end of the data region, the rest from its start*/
+    uint32_t index=tail&ctrl->mask;
+    uint32_t first=ctrl->total_size-index;
+    if(first>count)
+         first=count;
+
+    memcpy(circ_buff_pointer->base+index, data, (size_t)first*sizeof(uint32_t));
+    memcpy(circ_buff_pointer->base, data+first, (size_t)(count-first)*sizeof(uint32_t));
+
+    atomic_store_explicit(&ctrl->tail, tail+count, memory_order_release);
+
+    /*return successfully*/
+    return CIRC_BUFF_SUCCESS;
+}
+
+
+/*
+ * Function:     circ_buff_shm_read_n(circ_buff_shm_ptr circ_buff_pointer, uint32_t* data,
+ *                                    uint32_t count, uint32_t* read)
+ * -----------------------------------------------------------------------------
+ * Description:  Reads up to count elements into the data array with at most
+ *               two memcpy calls and hands the slots back with one store of
+ *               head.
+ *
+ * Usage:        Call only on a handle attached as the consumer. *read is set
+ *               to the number of elements actually read.
+ *
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_BAD_DATA: The handle is not attached as the
+ *               consumer.
+ *
+ *               CIRC_BUFF_EMPTY: The buffer is empty and count is non-zero;
+ *               nothing was read.
+ *
+ *               CIRC_BUFF_SUCCESS: *read elements were read; this may be less
+ *               than count if the buffer ran empty.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_shm_read_n(circ_buff_shm_ptr circ_buff_pointer, uint32_t* data,
+                                    uint32_t count, uint32_t* read)
+{
+    /*basic pointer check; error handling*/
+    if(circ_buff_pointer==NULL||data==NULL||read==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    /*only the consumer may move head*/
+    if(circ_buff_pointer->role!=CIRC_BUFF_SHM_CONSUMER)
+         return CIRC_BUFF_BAD_DATA;
+
+    circ_buff_shm_ctrl *ctrl=circ_buff_pointer->ctrl;
+    uint32_t head=atomic_load_explicit(&ctrl->head, memory_order_relaxed);
+    uint32_t occupied=circ_buff_pointer->index_cache-head;
+
+    /*fewer elements than wanted with the cached tail- refresh it*/
+    if(occupied<count||occupied==0)
+    {
+         circ_buff_pointer->index_cache=atomic_load_explicit(&ctrl->tail, memory_order_acquire);
+         occupied=circ_buff_pointer->index_cache-head;
+    }
+
+    if(count>occupied)
+         count=occupied;
+
+    *read=count;
+
+    if(count==0)
+         return occupied==0? CIRC_BUFF_EMPTY: CIRC_BUFF_SUCCESS;
+
+    /*first piece up to the end of the data region, the rest from its start*/
+    uint32_t index=head&ctrl->mask;
+    uint32_t first=ctrl->total_size-index;
+    if(first>count)
+         first=count;
+
+    memcpy(data, circ_buff_pointer->base+index, (size_t)first*sizeof(uint32_t));
+    memcpy(data+first, circ_buff_pointer->base, (size_t)(count-first)*sizeof(uint32_t));
+
+    atomic_store_explicit(&ctrl->head, head+count, memory_order_release);
+
+    /*return successfully*/
+    return CIRC_BUFF_SUCCESS;
+}
@@ -0,0 +1,310 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         circ_buff_shm.h
+ *
+ * Description:  Contains the structures and function prototypes of a single
+ *               producer/single consumer circular buffer that lives in a named
+ *               POSIX shared memory segment, defined in circ_buff_shm.c in the
+ *               same directory. A producer in one process and a consumer in
+ *               another attach to it by name and exchange elements through
+ *               the shared mapping; reads and writes make no system calls.
+ *
+ *               The segment holds a control block followed by the data
+ *               region. The control block keeps offsets and free running
+ *               counters instead of pointers, since every process maps the
+ *               segment at a different address, and the pid of the process
+ *               holding each side so that a side left behind by a crashed
+ *               process can be taken over.
+ *
+ *               shm_open is POSIX, so a file including this header must be
+ *               compiled with _POSIX_C_SOURCE or _GNU_SOURCE defined (or
+ *               -std=gnu11); older C libraries also need -lrt.
+ *
+ * */
+
+#ifndef _CIRC_BUFF_SHM_H
+#define _CIRC_BUFF_SHM_H
+
+#include<stdint.h>
+#include<stddef.h>
+#include<stdatomic.h>
+#include "circ_buff.h"
+
+/*marks a segment whose control block is fully initialised; "CBSH"*/
+#define CIRC_BUFF_SHM_MAGIC   0x48534243u
+#define CIRC_BUFF_SHM_VERSION 2u
+
+/*how long an attach waits for the creator to finish initialising*/
+#define CIRC_BUFF_SHM_ATTACH_TIMEOUT_MS 1000
+
+/*the side of the buffer a process attaches as*/
+typedef enum {CIRC_BUFF_SHM_PRODUCER, CIRC_BUFF_SHM_CONSUMER} circ_buff_shm_role;
+
+
+/*
+ * Structure:    circ_buff_shm_ctrl
+ * -----------------------------------------------------------------------------
+ * Description:  The control block at the start of the segment. data_offset
+ *               is where the data region starts, counted from the start of
+ *               the segment. tail and head are free running counters as in
+ *               circ_buff_spsc; the slot of a counter is counter&mask.
+ *               producer_pid/consumer_pid hold the pid of the process
+ *               attached as that side, or 0. init_pid is the pid of the
+ *               process initialising the block. magic is stored last by the
+ *               creator, so a process that sees it sees the whole block; a
+ *               segment whose magic is still 0 after its initialiser died is
+ *               stale and is initialised again by the next attach.
+ *
+ * Usage:        Use the circ_buff_shm_* functions; do not access the members
+ *               directly.
+ * ----------------------------------------------------------------------------
+ */
+typedef struct circ_buff_shm_ctrl
+{
+    /*read only after init*/
+    _Atomic uint32_t magic;
+    _Atomic int32_t init_pid;
+    uint32_t version;
+    uint32_t total_size;
+    uint32_t mask;
+    uint64_t data_offset;
+
+    /*producer cache line*/
+    _Alignas(CIRC_BUFF_CACHE_LINE) _Atomic uint32_t tail;
+    _Atomic int32_t producer_pid;
+
+    /*consumer cache line*/
+    _Alignas(CIRC_BUFF_CACHE_LINE) _Atomic uint32_t head;
+    _Atomic int32_t consumer_pid;
+}circ_buff_shm_ctrl;
+
+
+/*
+ * Structure:    circ_buff_shm
+ * -----------------------------------------------------------------------------
+ * Description:  One process's handle to an attached segment. ctrl and base
+ *               point into this process's mapping; index_cache is the last
+ *               seen value of the other side's counter (head for the
+ *               producer, tail for the consumer), so the other side's cache
+ *               line is only read when the buffer looks full or empty.
+ *
+ * Usage:        Use the circ_buff_shm_* functions; do not access the members
+ *               directly. A handle belongs to one thread.
+ * ----------------------------------------------------------------------------
+ */
+typedef struct circ_buff_shm *circ_buff_shm_ptr;
+
+typedef struct circ_buff_shm
+{
+    circ_buff_shm_ctrl *ctrl;
+    uint32_t *base;
+    size_t map_size;
+    circ_buff_shm_role role;
+    uint32_t index_cache;
+}circ_buff_shm;
+
+
+/*
+ * Function:     circ_buff_shm_attach(circ_buff_shm_ptr* circ_buff_pointer, const char* name,
+ *                                    int32_t size, circ_buff_shm_role role)
+ * -----------------------------------------------------------------------------
+ * Description:  Attaches to the shared buffer 'name' as the producer or the
+ *               consumer, creating the segment if it does not exist yet.
+ *
+ * Working:      The process that creates the segment sizes and initialises
+ *               it; a process that finds it already there waits up to
+ *               CIRC_BUFF_SHM_ATTACH_TIMEOUT_MS for the creator to finish and
+ *               checks the control block. If the creator died before it was
+ *               done (the magic is still 0 and its init_pid is dead, or it
+ *               never stored one within the timeout), the segment is stale:
+ *               a process that passed a size grows it to that size if it is
+ *               empty and initialises it again. The side is then claimed by
+ *               storing our pid in it. If another process holds the side,
+ *               the claim fails unless that process no longer exists; then
+ *               its side is taken over and the buffer carries on from the
+ *               counters it left behind, so nothing it had published is lost.
+ *
+ * Usage:        Pass a pointer to the circ_buff_shm_ptr that should point to
+ *               the new handle, a name of the form "/some_name" as for
+ *               shm_open, the number of elements (rounded up to a power of
+ *               two; 0 accepts the size of an existing segment) and the side.
+ *               Either side may attach first.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_BAD_DATA: size is negative, larger than 2^30, 0 for
+ *               a segment that does not exist, or different from the size of
+ *               the existing segment; or the segment is not a shared buffer,
+ *               was not initialised in time by a live creator, or is stale
+ *               and size is 0 or too large for it.
+ *
+ *               CIRC_BUFF_FILE_OPEN_FAILED: The segment can not be created,
+ *               opened, sized or mapped.
+ *
+ *               CIRC_BUFF_IN_USE: A live process is attached as this side.
+ *
+ *               CIRC_BUFF_MALLOC_FAIL: The handle can not be allocated.
+ *
+ *               CIRC_BUFF_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_shm_attach(circ_buff_shm_ptr* circ_buff_pointer, const char* name,
+                                    int32_t size, circ_buff_shm_role role);
+
+/*
+ * Function:     circ_buff_shm_detach(circ_buff_shm_ptr circ_buff_pointer)
+ * -----------------------------------------------------------------------------
+ * Description:  Gives up this process's side, unmaps the segment and frees
+ *               the handle. The segment and the data in it stay, so the same
+ *               or another process can attach again.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_shm_detach(circ_buff_shm_ptr circ_buff_pointer);
+
+/*
+ * Function:     circ_buff_shm_unlink(const char* name)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes the segment 'name'. Processes still attached keep
+ *               their mapping until they detach.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_FILE_OPEN_FAILED: shm_unlink fails, e.g. the
+ *               segment does not exist.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_shm_unlink(const char* name);
+
+/*
+ * Function:     circ_buff_shm_peer_alive(circ_buff_shm_ptr circ_buff_pointer, int* alive)
+ * -----------------------------------------------------------------------------
+ * Description:  Sets *alive to 1 if a live process is attached as the other
+ *               side and to 0 if none is or it has died. A consumer that
+ *               finds the buffer empty for long can use this to tell a slow
+ *               producer from a dead one.
+ *
+ * Usage:        A pid can be reused after its process dies, so a peer that
+ *               died long ago may look alive.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_shm_peer_alive(circ_buff_shm_ptr circ_buff_pointer, int* alive);
+
+/*
+ * Function:     circ_buff_shm_write(circ_buff_shm_ptr circ_buff_pointer, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Writes data at the tail of the buffer and publishes it to the
+ *               consumer with a release store of tail.
+ *
+ * Usage:        Call only on a handle attached as the producer.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_BAD_DATA: The handle is not attached as the
+ *               producer.
+ *
+ *               CIRC_BUFF_FULL: The buffer is currently full and thus new
+ *               data can not be written to it.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               successfully.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_shm_write(circ_buff_shm_ptr circ_buff_pointer, uint32_t data);
+
+/*
+ * Function:     circ_buff_shm_read(circ_buff_shm_ptr circ_buff_pointer, uint32_t* data)
+ * -----------------------------------------------------------------------------
+ * Description:  Reads the element at the head of the buffer into *data and
+ *               hands the slot back to the producer with a release store of
+ *               head.
+ *
+ * Usage:        Call only on a handle attached as the consumer.
+ *
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_BAD_DATA: The handle is not attached as the
+ *               consumer.
+ *
+ *               CIRC_BUFF_EMPTY: The buffer is currently empty and thus can
+ *               not return any data.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_shm_read(circ_buff_shm_ptr circ_buff_pointer, uint32_t* data);
+
+/*
+ * Function:     circ_buff_shm_write_n(circ_buff_shm_ptr circ_buff_pointer, const uint32_t* data,
+ *                                     uint32_t count, uint32_t* written)
+ * -----------------------------------------------------------------------------
+ * Description:  Writes up to count elements from the data array with at most
+ *               two memcpy calls and publishes them with one store of tail.
+ *
+ * Usage:        Call only on a handle attached as the producer. *written is
+ *               set to the number of elements actually written.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_BAD_DATA: The handle is not attached as the
+ *               producer.
+ *
+ *               CIRC_BUFF_FULL: The buffer is full and count is non-zero;
+ *               nothing was written.
+ *
+ *               CIRC_BUFF_SUCCESS: *written elements were written; this may
+ *               be less than count if the buffer filled up.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_shm_write_n(circ_buff_shm_ptr circ_buff_pointer, const uint32_t* data,
+                                     uint32_t count, uint32_t* written);
+
+/*
+ * Function:     circ_buff_shm_read_n(circ_buff_shm_ptr circ_buff_pointer, uint32_t* data,
+ *                                    uint32_t count, uint32_t* read)
+ * -----------------------------------------------------------------------------
+ * Description:  Reads up to count elements into the data array with at most
+ *               two memcpy calls and hands the slots back with one store of
+ *               head.
+ *
+ * Usage:        Call only on a handle attached as the consumer. *read is set
+ *               to the number of elements actually read.
+ *
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_BAD_DATA: The handle is not attached as the
+ *               consumer.
+ *
+ *               CIRC_BUFF_EMPTY: The buffer is empty and count is non-zero;
+ *               nothing was read.
+ *
+ *               CIRC_BUFF_SUCCESS: *read elements were read; this may be less
+ *               than count if the buffer ran empty.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_shm_read_n(circ_buff_shm_ptr circ_buff_pointer, uint32_t* data,
+                                    uint32_t count, uint32_t* read);
+
+#endif
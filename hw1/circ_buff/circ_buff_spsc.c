@@ -0,0 +1,496 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         circ_buff_spsc.c
+ *
+ * Description:  Contains an implementation of a lock-free circular buffer
+ *               that one producer thread and one consumer thread can use
+ *               concurrently without a mutex.
+ *
+ * */
+
+
+/*syscall() is a GNU extension*/
+#define _GNU_SOURCE
+
+#include "circ_buff_spsc.h"
+#include<stdint.h>
+#include<stdlib.h>
+#include<stdatomic.h>
+#include<time.h>
+#include<unistd.h>
+#include<sys/syscall.h>
+#include<linux/futex.h>
+#include<linux/membarrier.h>
+
+
+/*
+ * Function:     circ_buff_spsc_notify(circ_buff_spsc_ptr circ_buff_pointer, _Atomic uint32_t* waiting,
+ *                                     _Atomic uint32_t* word)
+ * -----------------------------------------------------------------------------
+ * Description:  Wakes the other side if it announced in 'waiting' that it
+ *               sleeps on 'word'. Called right after 'word' was stored.
+ * ----------------------------------------------------------------------------
+ */
+static void circ_buff_spsc_notify(circ_buff_spsc_ptr circ_buff_pointer, _Atomic uint32_t* waiting,
+                                  _Atomic uint32_t* word)
+{
+    /*order our store of word before the load of waiting; pairs with the
+     *store of waiting before the load of word in circ_buff_spsc_sleep. With
+     *membarrier the sleeper pays for the barrier, so only the compiler must
+     *keep the order here*/
+    if(circ_buff_pointer->membarrier)
+         atomic_signal_fence(memory_order_seq_cst);
+    else
+         atomic_thread_fence(memory_order_seq_cst);
+
+    if(atomic_load_explicit(waiting, memory_order_relaxed))
+         syscall(SYS_futex, (uint32_t*)word, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+
+/*
+ * Function:     circ_buff_spsc_sleep(circ_buff_spsc_ptr circ_buff_pointer, _Atomic uint32_t* waiting,
+ *                                    _Atomic uint32_t* word, uint32_t value,
+ *                                    const struct timespec* deadline)
+ * -----------------------------------------------------------------------------
+ * Description:  Sleeps until 'word' no longer holds 'value', the deadline on
+ *               CLOCK_MONOTONIC passes (NULL waits forever) or a spurious
+ *               wake up. Returns CIRC_BUFF_TIMEOUT if the deadline had already
+ *               passed and CIRC_BUFF_SUCCESS otherwise; the caller re-checks
+ *               the buffer either way.
+ * ----------------------------------------------------------------------------
+ */
+static circ_buff_code circ_buff_spsc_sleep(circ_buff_spsc_ptr circ_buff_pointer, _Atomic uint32_t* waiting,
+                                           _Atomic uint32_t* word, uint32_t value,
+                                           const struct timespec* deadline)
+{
+    struct timespec now, remaining, *timeout=NULL;
+
+    /*futex takes a relative timeout*/
+    if(deadline!=NULL)
+    {
+         clock_gettime(CLOCK_MONOTONIC, &now);
+         remaining.tv_sec=deadline->tv_sec-now.tv_sec;
+         remaining.tv_nsec=deadline->tv_nsec-now.tv_nsec;
+         if(remaining.tv_nsec<0)
+         {
+              remaining.tv_sec--;
+              remaining.tv_nsec+=1000000000L;
+         }
+         if(remaining.tv_sec<0)
+              return CIRC_BUFF_TIMEOUT;
+         timeout=&remaining;
+    }
+
+    /*announce the sleep, then re-check so that a store made before the
+     *announcement was seen is not missed; membarrier runs a full barrier on
+     *the other side in place of the fence it skips in circ_buff_spsc_notify*/
+    atomic_store(waiting, 1);
+    if(circ_buff_pointer->membarrier)
+         syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0);
+    if(atomic_load(word)==value)
+         syscall(SYS_futex, (uint32_t*)word, FUTEX_WAIT_PRIVATE, value, timeout, NULL, 0);
+    atomic_store_explicit(waiting, 0, memory_order_relaxed);
+
+    return CIRC_BUFF_SUCCESS;
+}
+
+/*
+ * Function:     circ_buff_spsc_deadline(struct timespec* deadline, int32_t timeout_ms)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns deadline, set timeout_ms from now on CLOCK_MONOTONIC,
+ *               or NULL for a negative timeout_ms (wait forever).
+ * ----------------------------------------------------------------------------
+ */
+static const struct timespec* circ_buff_spsc_deadline(struct timespec* deadline, int32_t timeout_ms)
+{
+    if(timeout_ms<0)
+         return NULL;
+
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_sec+=timeout_ms/1000;
+    deadline->tv_nsec+=(long)(timeout_ms%1000)*1000000L;
+    if(deadline->tv_nsec>=1000000000L)
+    {
+         deadline->tv_sec++;
+         deadline->tv_nsec-=1000000000L;
+    }
+
+    return deadline;
+}
+
+
+/*
+ * Function:     circ_buff_spsc_init(circ_buff_spsc_ptr* circ_buff_pointer, int32_t size)
+ * -----------------------------------------------------------------------------
+ * Description:  Allocates a spsc circular buffer structure and a data region
+ *               of 'size' uint32_t elements on the heap. The size is rounded up
+ *               to the next power of two so that wraparound is a mask.
+ *
+ * Usage:        Pass a pointer to the ptr of the spsc circular buffer and the
+ *               number of elements it should hold in that order. Call this
+ *               before the producer and consumer threads are started.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is detected to be a
+ *               null. The function halts execution and returns w/o completion.
+ *
+ *               CIRC_BUFF_BAD_DATA: The size parameter is less than or equal
+ *               to zero or larger than 2^31.
+ *
+ *               CIRC_BUFF_MALLOC_FAIL: A memory allocation fails.
+ *
+ *               CIRC_BUFF_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_spsc_init(circ_buff_spsc_ptr* circ_buff_pointer, int32_t size)
+{
+    /*check if the pointer is NULL*/
+    if(circ_buff_pointer==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    /*the counters are 32 bits wide, so at most 2^31 slots can be told apart*/
+    if(size<=0||(uint32_t)size>(UINT32_C(1)<<31))
+         return CIRC_BUFF_BAD_DATA;
+
+    /*round the size up to a power of two*/
+    uint32_t total_size=1;
+    while(total_size<(uint32_t)size)
+         total_size<<=1;
+
+    /*the structure is cache line aligned, so malloc is not enough*/
+    circ_buff_spsc_ptr cb=(circ_buff_spsc_ptr)aligned_alloc(CIRC_BUFF_CACHE_LINE, sizeof(circ_buff_spsc));
+    if(cb==NULL)
+         return CIRC_BUFF_MALLOC_FAIL;
+
+    /*allocate the data region*/
+    cb->base=(uint32_t*)malloc((size_t)total_size*sizeof(uint32_t));
+    if(cb->base==NULL)
+    {
+         free(cb);
+         return CIRC_BUFF_MALLOC_FAIL;
+    }
+
+    cb->total_size=total_size;
+    cb->mask=total_size-1;
+
+    /*both counters start at zero- the buffer is empty*/
+    atomic_init(&cb->head, 0);
+    atomic_init(&cb->tail, 0);
+    cb->head_cache=0;
+    cb->tail_cache=0;
+    atomic_init(&cb->producer_waiting, 0);
+    atomic_init(&cb->consumer_waiting, 0);
+
+    /*registering again is harmless; without it the wakers keep a fence*/
+    cb->membarrier=(syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0)==0);
+
+    *circ_buff_pointer=cb;
+
+    /*return successfully*/
+    return CIRC_BUFF_SUCCESS;
+}
+
+
+/*
+ * Function:     circ_buff_spsc_destroy(circ_buff_spsc_ptr circ_buff_pointer)
+ * -----------------------------------------------------------------------------
+ * Description:  De-allocates the data region and the spsc buffer structure.
+ *
+ * Usage:        Pass a pointer to the spsc buffer once both the producer and
+ *               the consumer are done with it.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed to the function is a
+ *               NULL and is thus invalid.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_spsc_destroy(circ_buff_spsc_ptr circ_buff_pointer)
+{
+    /*basic pointer check*/
+    if(circ_buff_pointer==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    free(circ_buff_pointer->base);
+    circ_buff_pointer->base=NULL;
+    circ_buff_pointer->total_size=0;
+
+    free(circ_buff_pointer);
+
+    /*return safely*/
+    return CIRC_BUFF_SUCCESS;
+}
+
+
+/*
+ * Function:     if_circ_buff_spsc_full(circ_buff_spsc_ptr circ_buff_pointer)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns code indicating whether or not the buffer is full. The
+ *               answer is only exact when called from the producer thread; from
+ *               any other thread it is a snapshot that may already be stale.
+ *
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_FULL: The circular buffer is full.
+ *
+ *               CIRC_BUFF_CAN_WRITE: There is space for at least one element.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code if_circ_buff_spsc_full(circ_buff_spsc_ptr circ_buff_pointer)
+{
+    /*basic pointer check*/
+    if(circ_buff_pointer==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    uint32_t tail=atomic_load_explicit(&circ_buff_pointer->tail, memory_order_relaxed);
+    uint32_t head=atomic_load_explicit(&circ_buff_pointer->head, memory_order_acquire);
+
+    if(tail-head==circ_buff_pointer->total_size)
+         return CIRC_BUFF_FULL;
+    else
+         return CIRC_BUFF_CAN_WRITE;
+}
+
+
+/*
+ * Function:     if_circ_buff_spsc_empty(circ_buff_spsc_ptr circ_buff_pointer)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns code indicating whether or not the buffer is empty. The
+ *               answer is only exact when called from the consumer thread.
+ *
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_EMPTY: The buffer is currently empty.
+ *
+ *               CIRC_BUFF_CAN_READ: The buffer is not empty; data can be read.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code if_circ_buff_spsc_empty(circ_buff_spsc_ptr circ_buff_pointer)
+{
+    /*basic pointer check*/
+    if(circ_buff_pointer==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    uint32_t head=atomic_load_explicit(&circ_buff_pointer->head, memory_order_relaxed);
+    uint32_t tail=atomic_load_explicit(&circ_buff_pointer->tail, memory_order_acquire);
+
+    if(tail==head)
+         return CIRC_BUFF_EMPTY;
+    else
+         return CIRC_BUFF_CAN_READ;
+}
+
+
+/*
+ * Function:     circ_buff_spsc_write(circ_buff_spsc_ptr circ_buff_pointer, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Writes data at the tail of the buffer and publishes it to the
+ *               consumer with a release store of tail.
+ *
+ * Usage:        Call only from the producer thread.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_FULL: The buffer is currently full and thus new
+ *               data can not be written to it.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               successfully.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_spsc_write(circ_buff_spsc_ptr circ_buff_pointer, uint32_t data)
+{
+    /*basic pointer check; error handling*/
+    if(circ_buff_pointer==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    /*only this thread stores to tail, so a relaxed load sees our own value*/
+    uint32_t tail=atomic_load_explicit(&circ_buff_pointer->tail, memory_order_relaxed);
+
+    /*looks full with the cached head- refresh it from the consumer's line*/
+    if(tail-circ_buff_pointer->head_cache==circ_buff_pointer->total_size)
+    {
+         circ_buff_pointer->head_cache=atomic_load_explicit(&circ_buff_pointer->head, memory_order_acquire);
+
+         if(tail-circ_buff_pointer->head_cache==circ_buff_pointer->total_size)
+              return CIRC_BUFF_FULL;
+    }
+
+    /*fill the slot, then publish it*/
+    circ_buff_pointer->base[tail&circ_buff_pointer->mask]=data;
+    atomic_store_explicit(&circ_buff_pointer->tail, tail+1, memory_order_release);
+
+    /*return successfully*/
+    return CIRC_BUFF_SUCCESS;
+}
+
+
+/*
+ * Function:     circ_buff_spsc_read(circ_buff_spsc_ptr circ_buff_pointer, uint32_t* data)
+ * -----------------------------------------------------------------------------
+ * Description:  Reads the element at the head of the buffer into *data and
+ *               hands the slot back to the producer with a release store of
+ *               head.
+ *
+ * Usage:        Call only from the consumer thread.
+ *
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_EMPTY: The buffer is currently empty and thus can
+ *               not return any data.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_spsc_read(circ_buff_spsc_ptr circ_buff_pointer, uint32_t* data)
+{
+    /*basic pointer check; error handling*/
+    if(circ_buff_pointer==NULL||data==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    /*only this thread stores to head*/
+    uint32_t head=atomic_load_explicit(&circ_buff_pointer->head, memory_order_relaxed);
+
+    /*looks empty with the cached tail- refresh it from the producer's line*/
+    if(head==circ_buff_pointer->tail_cache)
+    {
+         circ_buff_pointer->tail_cache=atomic_load_explicit(&circ_buff_pointer->tail, memory_order_acquire);
+
+         if(head==circ_buff_pointer->tail_cache)
+              return CIRC_BUFF_EMPTY;
+    }
+
+    /*copy the element out before the slot is handed back*/
+    *data=circ_buff_pointer->base[head&circ_buff_pointer->mask];
+    atomic_store_explicit(&circ_buff_pointer->head, head+1, memory_order_release);
+
+    /*return successfully*/
+    return CIRC_BUFF_SUCCESS;
+}
+
+
+/*
+ * Function:     circ_buff_spsc_write_wait(circ_buff_spsc_ptr circ_buff_pointer, uint32_t data,
+ *                                         int32_t timeout_ms)
+ * -----------------------------------------------------------------------------
+ * Description:  Same as circ_buff_spsc_write, but if the buffer is full the
+ *               producer sleeps on a futex until the consumer frees a slot or
+ *               timeout_ms milliseconds pass. After a successful write a
+ *               consumer sleeping in circ_buff_spsc_read_wait is woken up; the
+ *               wake system call is only made if the consumer is asleep.
+ *
+ * Usage:        Call only from the producer thread. A timeout_ms of -1 waits
+ *               forever and 0 does not wait at all (a non blocking write that
+ *               still wakes a sleeping consumer). A consumer that sleeps in
+ *               circ_buff_spsc_read_wait is only woken by writes made through
+ *               this function; plain circ_buff_spsc_write does not wake it.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_FULL: timeout_ms is 0 and the buffer is full.
+ *
+ *               CIRC_BUFF_TIMEOUT: The buffer stayed full for timeout_ms.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               successfully.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_spsc_write_wait(circ_buff_spsc_ptr circ_buff_pointer, uint32_t data, int32_t timeout_ms)
+{
+    /*basic pointer check; error handling*/
+    if(circ_buff_pointer==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    struct timespec deadline_storage;
+    const struct timespec* deadline=NULL;
+
+    if(timeout_ms>0)
+         deadline=circ_buff_spsc_deadline(&deadline_storage, timeout_ms);
+
+    for(;;)
+    {
+         if(circ_buff_spsc_write(circ_buff_pointer, data)==CIRC_BUFF_SUCCESS)
+         {
+              circ_buff_spsc_notify(circ_buff_pointer, &circ_buff_pointer->consumer_waiting,
+                                    &circ_buff_pointer->tail);
+              return CIRC_BUFF_SUCCESS;
+         }
+
+         if(timeout_ms==0)
+              return CIRC_BUFF_FULL;
+
+         /*the write just refreshed head_cache; sleep until head moves past it*/
+         if(circ_buff_spsc_sleep(circ_buff_pointer, &circ_buff_pointer->producer_waiting,
+                                 &circ_buff_pointer->head, circ_buff_pointer->head_cache,
+                                 deadline)==CIRC_BUFF_TIMEOUT)
+              return CIRC_BUFF_TIMEOUT;
+    }
+}
+
+
+/*
+ * Function:     circ_buff_spsc_read_wait(circ_buff_spsc_ptr circ_buff_pointer, uint32_t* data,
+ *                                        int32_t timeout_ms)
+ * -----------------------------------------------------------------------------
+ * Description:  Same as circ_buff_spsc_read, but if the buffer is empty the
+ *               consumer sleeps on a futex until the producer writes or
+ *               timeout_ms milliseconds pass. After a successful read a
+ *               producer sleeping in circ_buff_spsc_write_wait is woken up; the
+ *               wake system call is only made if the producer is asleep.
+ *
+ * Usage:        Call only from the consumer thread. A timeout_ms of -1 waits
+ *               forever and 0 does not wait at all. A producer that sleeps in
+ *               circ_buff_spsc_write_wait is only woken by reads made through
+ *               this function.
+ *
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_EMPTY: timeout_ms is 0 and the buffer is empty.
+ *
+ *               CIRC_BUFF_TIMEOUT: The buffer stayed empty for timeout_ms.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_spsc_read_wait(circ_buff_spsc_ptr circ_buff_pointer, uint32_t* data, int32_t timeout_ms)
+{
+    /*basic pointer check; error handling*/
+    if(circ_buff_pointer==NULL||data==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    struct timespec deadline_storage;
+    const struct timespec* deadline=NULL;
+
+    if(timeout_ms>0)
+         deadline=circ_buff_spsc_deadline(&deadline_storage, timeout_ms);
+
+    for(;;)
+    {
+         if(circ_buff_spsc_read(circ_buff_pointer, data)==CIRC_BUFF_SUCCESS)
+         {
+              circ_buff_spsc_notify(circ_buff_pointer, &circ_buff_pointer->producer_waiting,
+                                    &circ_buff_pointer->head);
+              return CIRC_BUFF_SUCCESS;
+         }
+
+         if(timeout_ms==0)
+              return CIRC_BUFF_EMPTY;
+
+         /*empty means tail still equals our head; sleep until it moves*/
+         uint32_t head=atomic_load_explicit(&circ_buff_pointer->head, memory_order_relaxed);
+         if(circ_buff_spsc_sleep(circ_buff_pointer, &circ_buff_pointer->consumer_waiting,
+                                 &circ_buff_pointer->tail, head, deadline)==CIRC_BUFF_TIMEOUT)
+              return CIRC_BUFF_TIMEOUT;
+    }
+}
@@ -0,0 +1,246 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         circ_buff_spsc.h
+ *
+ * Description:  Contains the structure and function prototypes of a lock-free
+ *               single producer/single consumer circular buffer defined in
+ *               circ_buff_spsc.c in the same directory. It reuses the status
+ *               codes of circ_buff.h.
+ *
+ * */
+
+#ifndef _CIRC_BUFF_SPSC_H
+#define _CIRC_BUFF_SPSC_H
+
+#include<stdint.h>
+#include<stdatomic.h>
+#include "circ_buff.h"
+
+
+/*
+ * Structure:    circ_buff_spsc
+ * -----------------------------------------------------------------------------
+ * Description:  A circular buffer that can be written by exactly one producer
+ *               thread and read by exactly one consumer thread at the same time
+ *               without any locks.
+ *               head and tail are free running counters; the slot of a counter
+ *               is counter&mask and the occupancy is tail-head, so there is no
+ *               shared size_occupied counter. The producer only stores to tail
+ *               and the consumer only stores to head. Each side also keeps a
+ *               cached copy of the other side's index on its own cache line so
+ *               that the shared line is only pulled in when the buffer looks
+ *               full (producer) or empty (consumer).
+ *               producer_waiting/consumer_waiting are set by a side that is
+ *               about to sleep in a *_wait function, so the other side only
+ *               makes a futex wake system call when someone actually sleeps.
+ *               Each flag has a cache line of its own that is only written
+ *               around a sleep, so checking it after every write_wait or
+ *               read_wait hits the checker's own cache instead of the other
+ *               side's index line. The store/load barrier the check needs is
+ *               paid by the sleeper with membarrier when the kernel supports
+ *               it (membarrier is 1); otherwise the checker keeps a fence.
+ *
+ * Usage:        Do not access the members directly from the producer or the
+ *               consumer; use the circ_buff_spsc_* functions.
+ * ----------------------------------------------------------------------------
+ */
+typedef struct circ_buff_spsc *circ_buff_spsc_ptr;
+
+typedef struct circ_buff_spsc
+{
+    /*producer cache line*/
+    _Alignas(CIRC_BUFF_CACHE_LINE) _Atomic uint32_t tail;
+    uint32_t head_cache;
+
+    /*consumer cache line*/
+    _Alignas(CIRC_BUFF_CACHE_LINE) _Atomic uint32_t head;
+    uint32_t tail_cache;
+
+    /*written only when a side goes to sleep and wakes up*/
+    _Alignas(CIRC_BUFF_CACHE_LINE) _Atomic uint32_t producer_waiting;
+    _Alignas(CIRC_BUFF_CACHE_LINE) _Atomic uint32_t consumer_waiting;
+
+    /*read only after init*/
+    _Alignas(CIRC_BUFF_CACHE_LINE) uint32_t *base;
+    uint32_t  total_size;
+    uint32_t  mask;
+    uint32_t  membarrier;
+}circ_buff_spsc;
+
+
+/*
+ * Function:     circ_buff_spsc_init(circ_buff_spsc_ptr* circ_buff_pointer, int32_t size)
+ * -----------------------------------------------------------------------------
+ * Description:  Allocates a spsc circular buffer structure and a data region
+ *               of 'size' uint32_t elements on the heap. The size is rounded up
+ *               to the next power of two so that wraparound is a mask.
+ *
+ * Usage:        Pass a pointer to the ptr of the spsc circular buffer and the
+ *               number of elements it should hold in that order. Call this
+ *               before the producer and consumer threads are started.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is detected to be a
+ *               null. The function halts execution and returns w/o completion.
+ *
+ *               CIRC_BUFF_BAD_DATA: The size parameter is less than or equal
+ *               to zero or larger than 2^31.
+ *
+ *               CIRC_BUFF_MALLOC_FAIL: A memory allocation fails.
+ *
+ *               CIRC_BUFF_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_spsc_init(circ_buff_spsc_ptr* circ_buff_pointer, int32_t size);
+
+/*
+ * Function:     circ_buff_spsc_destroy(circ_buff_spsc_ptr circ_buff_pointer)
+ * -----------------------------------------------------------------------------
+ * Description:  De-allocates the data region and the spsc buffer structure.
+ *
+ * Usage:        Pass a pointer to the spsc buffer once both the producer and
+ *               the consumer are done with it.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed to the function is a
+ *               NULL and is thus invalid.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_spsc_destroy(circ_buff_spsc_ptr circ_buff_pointer);
+
+/*
+ * Function:     if_circ_buff_spsc_full(circ_buff_spsc_ptr circ_buff_pointer)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns code indicating whether or not the buffer is full. The
+ *               answer is only exact when called from the producer thread; from
+ *               any other thread it is a snapshot that may already be stale.
+ *
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_FULL: The circular buffer is full.
+ *
+ *               CIRC_BUFF_CAN_WRITE: There is space for at least one element.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code if_circ_buff_spsc_full(circ_buff_spsc_ptr circ_buff_pointer);
+
+/*
+ * Function:     if_circ_buff_spsc_empty(circ_buff_spsc_ptr circ_buff_pointer)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns code indicating whether or not the buffer is empty. The
+ *               answer is only exact when called from the consumer thread.
+ *
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_EMPTY: The buffer is currently empty.
+ *
+ *               CIRC_BUFF_CAN_READ: The buffer is not empty; data can be read.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code if_circ_buff_spsc_empty(circ_buff_spsc_ptr circ_buff_pointer);
+
+/*
+ * Function:     circ_buff_spsc_write(circ_buff_spsc_ptr circ_buff_pointer, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Writes data at the tail of the buffer and publishes it to the
+ *               consumer with a release store of tail.
+ *
+ * Usage:        Call only from the producer thread.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_FULL: The buffer is currently full and thus new
+ *               data can not be written to it.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               successfully.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_spsc_write(circ_buff_spsc_ptr circ_buff_pointer, uint32_t data);
+
+/*
+ * Function:     circ_buff_spsc_read(circ_buff_spsc_ptr circ_buff_pointer, uint32_t* data)
+ * -----------------------------------------------------------------------------
+ * Description:  Reads the element at the head of the buffer into *data and
+ *               hands the slot back to the producer with a release store of
+ *               head.
+ *
+ * Usage:        Call only from the consumer thread.
+ *
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_EMPTY: The buffer is currently empty and thus can
+ *               not return any data.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_spsc_read(circ_buff_spsc_ptr circ_buff_pointer, uint32_t* data);
+
+/*
+ * Function:     circ_buff_spsc_write_wait(circ_buff_spsc_ptr circ_buff_pointer, uint32_t data,
+ *                                         int32_t timeout_ms)
+ * -----------------------------------------------------------------------------
+ * Description:  Same as circ_buff_spsc_write, but if the buffer is full the
+ *               producer sleeps on a futex until the consumer frees a slot or
+ *               timeout_ms milliseconds pass. After a successful write a
+ *               consumer sleeping in circ_buff_spsc_read_wait is woken up; the
+ *               wake system call is only made if the consumer is asleep.
+ *
+ * Usage:        Call only from the producer thread. A timeout_ms of -1 waits
+ *               forever and 0 does not wait at all (a non blocking write that
+ *               still wakes a sleeping consumer). A consumer that sleeps in
+ *               circ_buff_spsc_read_wait is only woken by writes made through
+ *               this function; plain circ_buff_spsc_write does not wake it.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_FULL: timeout_ms is 0 and the buffer is full.
+ *
+ *               CIRC_BUFF_TIMEOUT: The buffer stayed full for timeout_ms.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               successfully.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_spsc_write_wait(circ_buff_spsc_ptr circ_buff_pointer, uint32_t data, int32_t timeout_ms);
+
+/*
+ * Function:     circ_buff_spsc_read_wait(circ_buff_spsc_ptr circ_buff_pointer, uint32_t* data,
+ *                                        int32_t timeout_ms)
+ * -----------------------------------------------------------------------------
+ * Description:  Same as circ_buff_spsc_read, but if the buffer is empty the
+ *               consumer sleeps on a futex until the producer writes or
+ *               timeout_ms milliseconds pass. After a successful read a
+ *               producer sleeping in circ_buff_spsc_write_wait is woken up; the
+ *               wake system call is only made if the producer is asleep.
+ *
+ * Usage:        Call only from the consumer thread. A timeout_ms of -1 waits
+ *               forever and 0 does not wait at all. A producer that sleeps in
+ *               circ_buff_spsc_write_wait is only woken by reads made through
+ *               this function.
+ *
+ * Returns:      Error/Status codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_EMPTY: timeout_ms is 0 and the buffer is empty.
+ *
+ *               CIRC_BUFF_TIMEOUT: The buffer stayed empty for timeout_ms.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_spsc_read_wait(circ_buff_spsc_ptr circ_buff_pointer, uint32_t* data, int32_t timeout_ms);
+
+#endif
@@ -0,0 +1,391 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         circ_buff_stats.c
+ *
+ * Description:  Contains an implementation of the optional statistics of the
+ *               circular buffer: counters, the high water mark and a log
+ *               bucketed histogram of the time elements spend in the buffer.
+ *               It is compiled the same with and without -DCIRC_BUFF_STATS;
+ *               the define only decides whether circ_buff.c uses it.
+ *
+ * */
+
+
+/*clock_gettime is POSIX*/
+#define _GNU_SOURCE
+
+#include "circ_buff_stats.h"
+#include<stdint.h>
+#include<stdlib.h>
+#include<string.h>
+#include<stdatomic.h>
+#include<time.h>
+
+
+/*
+ * Function:     circ_buff_stats_now(void)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the monotonic clock in nanoseconds.
+ * ----------------------------------------------------------------------------
+ */
+static inline uint64_t circ_buff_stats_now(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec*1000000000u+(uint64_t)now.tv_nsec;
+}
+
+/*
+ * Function:     circ_buff_stats_add(_Atomic uint64_t* counter, uint64_t value)
+ * -----------------------------------------------------------------------------
+ * Description:  Adds value to a counter that only one thread writes at a
+ *               time; a relaxed load and store, no locked instruction.
+ * ----------------------------------------------------------------------------
+ */
+static inline void circ_buff_stats_add(_Atomic uint64_t* counter, uint64_t value)
+{
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed)+value,
+                          memory_order_relaxed);
+}
+
+/*
+ * Function:     circ_buff_stats_bucket(uint64_t ns)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the histogram bucket of a residence time. Times below
+ *               CIRC_BUFF_STATS_SUB_BUCKETS get a bucket each; above that the
+ *               bucket is picked by the position of the top bit and the
+ *               CIRC_BUFF_STATS_SUB_BITS bits below it.
+ * ----------------------------------------------------------------------------
+ */
+static inline uint32_t circ_buff_stats_bucket(uint64_t ns)
+{
+    uint32_t top;
+
+    if(ns<CIRC_BUFF_STATS_SUB_BUCKETS)
+         return (uint32_t)ns;
+
+    top=63-__builtin_clzll(ns);
+
+    return (top-CIRC_BUFF_STATS_SUB_BITS+1)*CIRC_BUFF_STATS_SUB_BUCKETS+
+           (uint32_t)((ns>>(top-CIRC_BUFF_STATS_SUB_BITS))&(CIRC_BUFF_STATS_SUB_BUCKETS-1));
+}
+
+
+/*
+ * Function:     circ_buff_stats_init(circ_buff_stats_ptr* stats, uint32_t total_size)
+ * -----------------------------------------------------------------------------
+ * Description:  Allocates zeroed statistics and one time stamp per slot for a
+ *               buffer of total_size elements. Called by circ_buff_init_mode
+ *               when circ_buff.c is compiled with -DCIRC_BUFF_STATS.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_MALLOC_FAIL: A call to malloc fails.
+ *
+ *               CIRC_BUFF_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_stats_init(circ_buff_stats_ptr* stats, uint32_t total_size)
+{
+    /*basic pointer check; error handling*/
+    if(stats==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    /*all counters start at zero; calloc's zero bytes are zero atomics here*/
+    *stats=calloc(1, sizeof(circ_buff_stats));
+    if(*stats==NULL)
+         return CIRC_BUFF_MALLOC_FAIL;
+
+    (*stats)->stamps=calloc(total_size, sizeof(uint64_t));
+    if((*stats)->stamps==NULL)
+    {
+         free(*stats);
+         *stats=NULL;
+         return CIRC_BUFF_MALLOC_FAIL;
+    }
+
+    (*stats)->total_size=total_size;
+
+    return CIRC_BUFF_SUCCESS;
+}
+
+/*
+ * Function:     circ_buff_stats_destroy(circ_buff_stats_ptr stats)
+ * -----------------------------------------------------------------------------
+ * Description:  De-allocates the statistics. Called by circ_buff_destroy.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_stats_destroy(circ_buff_stats_ptr stats)
+{
+    /*basic pointer check; error handling*/
+    if(stats==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    free(stats->stamps);
+    free(stats);
+
+    return CIRC_BUFF_SUCCESS;
+}
+
+/*
+ * Function:     circ_buff_stats_on_write(circ_buff_stats_ptr stats, uint32_t index,
+ *                                        uint32_t count, uint32_t occupied)
+ * -----------------------------------------------------------------------------
+ * Description:  Records count elements written to the slots from index on,
+ *               circularly, after which the buffer holds occupied elements.
+ *               The elements all get the same time stamp.
+ * ----------------------------------------------------------------------------
+ */
+void circ_buff_stats_on_write(circ_buff_stats_ptr stats, uint32_t index, uint32_t count, uint32_t occupied)
+{
+    uint64_t now=circ_buff_stats_now();
+    uint32_t i;
+
+    for(i=0; i<count; i++)
+    {
+         stats->stamps[index]=now;
+         if(++index==stats->total_size)
+              index=0;
+    }
+
+    circ_buff_stats_add(&stats->writes, count);
+
+    if(occupied>atomic_load_explicit(&stats->high_water, memory_order_relaxed))
+         atomic_store_explicit(&stats->high_water, occupied, memory_order_relaxed);
+}
+
+/*
+ * Function:     circ_buff_stats_on_read(circ_buff_stats_ptr stats, uint32_t index, uint32_t count)
+ * -----------------------------------------------------------------------------
+ * Description:  Records count elements read or released from the slots from
+ *               index on, circularly, and adds their residence times to the
+ *               histogram.
+ * ----------------------------------------------------------------------------
+ */
+void circ_buff_stats_on_read(circ_buff_stats_ptr stats, uint32_t index, uint32_t count)
+{
+    uint64_t now=circ_buff_stats_now(), total=0, max=0, residence;
+    uint32_t i;
+
+    for(i=0; i<count; i++)
+    {
+         residence=now-stats->stamps[index];
+         circ_buff_stats_add(&stats->histogram[circ_buff_stats_bucket(residence)], 1);
+
+         total+=residence;
+         if(residence>max)
+              max=residence;
+
+         if(++index==stats->total_size)
+              index=0;
+    }
+
+    circ_buff_stats_add(&stats->reads, count);
+    circ_buff_stats_add(&stats->residence_total_ns, total);
+
+    if(max>atomic_load_explicit(&stats->residence_max_ns, memory_order_relaxed))
+         atomic_store_explicit(&stats->residence_max_ns, max, memory_order_relaxed);
+}
+
+/*
+ * Function:     circ_buff_stats_on_reject(_Atomic uint64_t* counter)
+ * -----------------------------------------------------------------------------
+ * Description:  Counts a call rejected because the buffer was full or empty.
+ * ----------------------------------------------------------------------------
+ */
+void circ_buff_stats_on_reject(_Atomic uint64_t* counter)
+{
+    circ_buff_stats_add(counter, 1);
+}
+
+/*
+ * Function:     circ_buff_get_stats(circ_buff_ptr circ_buff_pointer,
+ *                                   circ_buff_stats_snapshot* snapshot)
+ * -----------------------------------------------------------------------------
+ * Description:  Copies the statistics of the buffer to *snapshot.
+ *
+ * Usage:        May be called from any thread while the buffer is in use. The
+ *               counters are then each exact but may be a few operations
+ *               apart from each other; capacity and occupied must only be
+ *               relied on from the thread that uses the buffer.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_BAD_DATA: The buffer has no statistics.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_get_stats(circ_buff_ptr circ_buff_pointer, circ_buff_stats_snapshot* snapshot)
+{
+    /*basic pointer check; error handling*/
+    if(circ_buff_pointer==NULL||snapshot==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    circ_buff_stats_ptr stats=circ_buff_pointer->stats;
+    uint32_t bucket;
+
+    if(stats==NULL)
+         return CIRC_BUFF_BAD_DATA;
+
+    snapshot->capacity=circ_buff_pointer->total_size;
+    if(circ_buff_pointer->mode&CIRC_BUFF_MODE_POW2)
+         snapshot->occupied=circ_buff_pointer->tail_count-circ_buff_pointer->head_count;
+    else
+         snapshot->occupied=circ_buff_pointer->size_occupied;
+    snapshot->dropped=circ_buff_pointer->dropped;
+
+    snapshot->high_water=atomic_load_explicit(&stats->high_water, memory_order_relaxed);
+    snapshot->writes=atomic_load_explicit(&stats->writes, memory_order_relaxed);
+    snapshot->reads=atomic_load_explicit(&stats->reads, memory_order_relaxed);
+    snapshot->full_rejects=atomic_load_explicit(&stats->full_rejects, memory_order_relaxed);
+    snapshot->empty_rejects=atomic_load_explicit(&stats->empty_rejects, memory_order_relaxed);
+    snapshot->residence_total_ns=atomic_load_explicit(&stats->residence_total_ns, memory_order_relaxed);
+    snapshot->residence_max_ns=atomic_load_explicit(&stats->residence_max_ns, memory_order_relaxed);
+
+    /*the count is summed from the copy so it always matches the histogram*/
+    snapshot->residence_count=0;
+    for(bucket=0; bucket<CIRC_BUFF_STATS_BUCKETS; bucket++)
+    {
+         snapshot->histogram[bucket]=atomic_load_explicit(&stats->histogram[bucket], memory_order_relaxed);
+         snapshot->residence_count+=snapshot->histogram[bucket];
+    }
+
+    return CIRC_BUFF_SUCCESS;
+}
+
+/*
+ * Function:     circ_buff_reset_stats(circ_buff_ptr circ_buff_pointer)
+ * -----------------------------------------------------------------------------
+ * Description:  Sets the counters and the histogram back to zero and the high
+ *               water mark to the current occupancy. Elements already in the
+ *               buffer keep their time stamps.
+ *
+ * Usage:        Call from the thread that uses the buffer.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_BAD_DATA: The buffer has no statistics.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_reset_stats(circ_buff_ptr circ_buff_pointer)
+{
+    /*basic pointer check; error handling*/
+    if(circ_buff_pointer==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    circ_buff_stats_ptr stats=circ_buff_pointer->stats;
+    uint32_t bucket, occupied;
+
+    if(stats==NULL)
+         return CIRC_BUFF_BAD_DATA;
+
+    if(circ_buff_pointer->mode&CIRC_BUFF_MODE_POW2)
+         occupied=circ_buff_pointer->tail_count-circ_buff_pointer->head_count;
+    else
+         occupied=circ_buff_pointer->size_occupied;
+
+    atomic_store_explicit(&stats->high_water, occupied, memory_order_relaxed);
+    atomic_store_explicit(&stats->writes, 0, memory_order_relaxed);
+    atomic_store_explicit(&stats->reads, 0, memory_order_relaxed);
+    atomic_store_explicit(&stats->full_rejects, 0, memory_order_relaxed);
+    atomic_store_explicit(&stats->empty_rejects, 0, memory_order_relaxed);
+    atomic_store_explicit(&stats->residence_total_ns, 0, memory_order_relaxed);
+    atomic_store_explicit(&stats->residence_max_ns, 0, memory_order_relaxed);
+
+    for(bucket=0; bucket<CIRC_BUFF_STATS_BUCKETS; bucket++)
+         atomic_store_explicit(&stats->histogram[bucket], 0, memory_order_relaxed);
+
+    return CIRC_BUFF_SUCCESS;
+}
+
+/*
+ * Function:     circ_buff_stats_bucket_floor(uint32_t bucket)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the smallest residence time in nanoseconds that falls
+ *               in histogram bucket 'bucket'.
+ * ----------------------------------------------------------------------------
+ */
+uint64_t circ_buff_stats_bucket_floor(uint32_t bucket)
+{
+    uint32_t top, sub;
+
+    if(bucket<CIRC_BUFF_STATS_SUB_BUCKETS)
+         return bucket;
+
+    if(bucket>=CIRC_BUFF_STATS_BUCKETS)
+         bucket=CIRC_BUFF_STATS_BUCKETS-1;
+
+    /*invert circ_buff_stats_bucket: the top bit and the bits below it*/
+    top=bucket/CIRC_BUFF_STATS_SUB_BUCKETS+CIRC_BUFF_STATS_SUB_BITS-1;
+    sub=bucket%CIRC_BUFF_STATS_SUB_BUCKETS;
+
+    return (uint64_t)(CIRC_BUFF_STATS_SUB_BUCKETS+sub)<<(top-CIRC_BUFF_STATS_SUB_BITS);
+}
+
+/*
+ * Function:     circ_buff_stats_percentile(const circ_buff_stats_snapshot* snapshot,
+ *                                          double percent, uint64_t* ns)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns in *ns the floor of the bucket that holds the given
+ *               percentile (0 to 100) of the residence times in snapshot.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_BAD_DATA: percent is not within 0 to 100.
+ *
+ *               CIRC_BUFF_EMPTY: No residence time was recorded.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_stats_percentile(const circ_buff_stats_snapshot* snapshot, double percent, uint64_t* ns)
+{
+    /*basic pointer check; error handling*/
+    if(snapshot==NULL||ns==NULL)
+         return CIRC_BUFF_NULL_PTR;
+
+    if(!(percent>=0.0&&percent<=100.0))
+         return CIRC_BUFF_BAD_DATA;
+
+    if(snapshot->residence_count==0)
+         return CIRC_BUFF_EMPTY;
+
+    /*rank of the wanted element, 1 based, counted from the smallest time*/
+    uint64_t rank=(uint64_t)(percent/100.0*(double)snapshot->residence_count+0.5), seen=0;
+    uint32_t bucket;
+
+    if(rank==0)
+         rank=1;
+    if(rank>snapshot->residence_count)
+         rank=snapshot->residence_count;
+
+    for(bucket=0; bucket<CIRC_BUFF_STATS_BUCKETS; bucket++)
+    {
+         seen+=snapshot->histogram[bucket];
+         if(seen>=rank)
+              break;
+    }
+
+    *ns=circ_buff_stats_bucket_floor(bucket);
+
+    return CIRC_BUFF_SUCCESS;
+}
@@ -0,0 +1,265 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         circ_buff_stats.h
+ *
+ * Description:  Contains the structures and function prototypes of the
+ *               optional statistics of the circular buffer in circ_buff.h,
+ *               defined in circ_buff_stats.c in the same directory. With
+ *               statistics on, every buffer counts its writes, reads and the
+ *               calls rejected because it was full or empty, tracks its high
+ *               water mark, and time stamps every element on write so that
+ *               the time it spent in the buffer is put in a log bucketed
+ *               histogram when it is read. Every call that writes or reads
+ *               reads the clock once, which costs more than a single element
+ *               write itself; the batch calls share that cost over the batch.
+ *
+ *               Statistics are collected only if circ_buff.c is compiled with
+ *               CIRC_BUFF_STATS defined (-DCIRC_BUFF_STATS). Without it the
+ *               hooks in circ_buff.c expand to nothing and the stats member
+ *               of every buffer stays NULL. The member and the functions below
+ *               exist either way, so the layout of struct circ_buff does not
+ *               depend on the define and files compiled with and without it
+ *               can be linked together. The hooks only run for buffers with
+ *               statistics, so moves that are not data, such as
+ *               circ_buff_commit_pad, are left out of the counts.
+ *
+ * */
+
+#ifndef _CIRC_BUFF_STATS_H
+#define _CIRC_BUFF_STATS_H
+
+#include<stdint.h>
+#include<stdatomic.h>
+#include "circ_buff.h"
+
+/*every power of two of the residence time is split into 2^SUB_BITS buckets,
+ *so a bucket is at most 12.5% wide*/
+#define CIRC_BUFF_STATS_SUB_BITS 3
+#define CIRC_BUFF_STATS_SUB_BUCKETS (1u<<CIRC_BUFF_STATS_SUB_BITS)
+
+/*buckets needed to cover every uint64_t number of nanoseconds*/
+#define CIRC_BUFF_STATS_BUCKETS ((64-CIRC_BUFF_STATS_SUB_BITS+1)*CIRC_BUFF_STATS_SUB_BUCKETS)
+
+
+#ifdef CIRC_BUFF_STATS
+
+/*hooks called by circ_buff.c; arguments are not evaluated without stats*/
+#define CIRC_BUFF_STATS_WRITE(cb, index, count, occupied)                       \
+    do{ if((cb)->stats!=NULL)                                                   \
+         circ_buff_stats_on_write((cb)->stats, (index), (count), (occupied)); }while(0)
+#define CIRC_BUFF_STATS_READ(cb, index, count)                                  \
+    do{ if((cb)->stats!=NULL)                                                   \
+         circ_buff_stats_on_read((cb)->stats, (index), (count)); }while(0)
+#define CIRC_BUFF_STATS_FULL(cb)                                                \
+    do{ if((cb)->stats!=NULL)                                                   \
+         circ_buff_stats_on_reject(&(cb)->stats->full_rejects); }while(0)
+#define CIRC_BUFF_STATS_EMPTY(cb)                                               \
+    do{ if((cb)->stats!=NULL)                                                   \
+         circ_buff_stats_on_reject(&(cb)->stats->empty_rejects); }while(0)
+
+#else
+
+#define CIRC_BUFF_STATS_WRITE(cb, index, count, occupied) ((void)0)
+#define CIRC_BUFF_STATS_READ(cb, index, count)            ((void)0)
+#define CIRC_BUFF_STATS_FULL(cb)                          ((void)0)
+#define CIRC_BUFF_STATS_EMPTY(cb)                         ((void)0)
+
+#endif
+
+
+/*
+ * Structure:    circ_buff_stats
+ * -----------------------------------------------------------------------------
+ * Description:  The statistics of one buffer. stamps[i] is the time the
+ *               element in slot i was written at; histogram[b] counts the
+ *               elements whose residence time fell in bucket b.
+ *
+ * Working:      The operations on one buffer are already serialised by its
+ *               user, so every counter has a single writer at a time and is
+ *               updated with a relaxed load and store instead of a locked
+ *               read-modify-write. The counters are atomic only so that
+ *               another thread may take a snapshot while the buffer is used.
+ *
+ * Usage:        Use circ_buff_get_stats; do not access the members directly.
+ * ----------------------------------------------------------------------------
+ */
+typedef struct circ_buff_stats
+{
+    _Atomic uint64_t writes;
+    _Atomic uint64_t reads;
+    _Atomic uint64_t full_rejects;
+    _Atomic uint64_t empty_rejects;
+    _Atomic uint64_t residence_total_ns;
+    _Atomic uint64_t residence_max_ns;
+    _Atomic uint32_t high_water;
+    uint32_t total_size;
+    uint64_t *stamps;
+    _Atomic uint64_t histogram[CIRC_BUFF_STATS_BUCKETS];
+}circ_buff_stats;
+
+
+/*
+ * Structure:    circ_buff_stats_snapshot
+ * -----------------------------------------------------------------------------
+ * Description:  A copy of the statistics of a buffer at one point in time.
+ *               capacity and occupied are the current total and used size,
+ *               dropped the elements dropped in CIRC_BUFF_MODE_OVERWRITE
+ *               (see circ_buff_dropped). residence_count is the number of
+ *               elements in the histogram; histogram[b] counts those whose
+ *               residence time was at least circ_buff_stats_bucket_floor(b)
+ *               and less than the floor of bucket b+1.
+ *
+ * Usage:        Use regular structure syntax to access any of the members of
+ *               this structure
+ * ----------------------------------------------------------------------------
+ */
+typedef struct circ_buff_stats_snapshot
+{
+    uint32_t capacity;
+    uint32_t occupied;
+    uint32_t high_water;
+    uint64_t writes;
+    uint64_t reads;
+    uint64_t full_rejects;
+    uint64_t empty_rejects;
+    uint64_t dropped;
+    uint64_t residence_count;
+    uint64_t residence_total_ns;
+    uint64_t residence_max_ns;
+    uint64_t histogram[CIRC_BUFF_STATS_BUCKETS];
+}circ_buff_stats_snapshot;
+
+
+/*
+ * Function:     circ_buff_stats_init(circ_buff_stats_ptr* stats, uint32_t total_size)
+ * -----------------------------------------------------------------------------
+ * Description:  Allocates zeroed statistics and one time stamp per slot for a
+ *               buffer of total_size elements. Called by circ_buff_init_mode
+ *               when circ_buff.c is compiled with -DCIRC_BUFF_STATS.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_MALLOC_FAIL: A call to malloc fails.
+ *
+ *               CIRC_BUFF_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_stats_init(circ_buff_stats_ptr* stats, uint32_t total_size);
+
+/*
+ * Function:     circ_buff_stats_destroy(circ_buff_stats_ptr stats)
+ * -----------------------------------------------------------------------------
+ * Description:  De-allocates the statistics. Called by circ_buff_destroy.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_stats_destroy(circ_buff_stats_ptr stats);
+
+/*
+ * Function:     circ_buff_stats_on_write(circ_buff_stats_ptr stats, uint32_t index,
+ *                                        uint32_t count, uint32_t occupied)
+ * -----------------------------------------------------------------------------
+ * Description:  Records count elements written to the slots from index on,
+ *               circularly, after which the buffer holds occupied elements.
+ *               The elements all get the same time stamp.
+ * ----------------------------------------------------------------------------
+ */
+void circ_buff_stats_on_write(circ_buff_stats_ptr stats, uint32_t index, uint32_t count, uint32_t occupied);
+
+/*
+ * Function:     circ_buff_stats_on_read(circ_buff_stats_ptr stats, uint32_t index, uint32_t count)
+ * -----------------------------------------------------------------------------
+ * Description:  Records count elements read or released from the slots from
+ *               index on, circularly, and adds their residence times to the
+ *               histogram.
+ * ----------------------------------------------------------------------------
+ */
+void circ_buff_stats_on_read(circ_buff_stats_ptr stats, uint32_t index, uint32_t count);
+
+/*
+ * Function:     circ_buff_stats_on_reject(_Atomic uint64_t* counter)
+ * -----------------------------------------------------------------------------
+ * Description:  Counts a call rejected because the buffer was full or empty.
+ * ----------------------------------------------------------------------------
+ */
+void circ_buff_stats_on_reject(_Atomic uint64_t* counter);
+
+/*
+ * Function:     circ_buff_get_stats(circ_buff_ptr circ_buff_pointer,
+ *                                   circ_buff_stats_snapshot* snapshot)
+ * -----------------------------------------------------------------------------
+ * Description:  Copies the statistics of the buffer to *snapshot.
+ *
+ * Usage:        May be called from any thread while the buffer is in use. The
+ *               counters are then each exact but may be a few operations
+ *               apart from each other; capacity and occupied must only be
+ *               relied on from the thread that uses the buffer.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_BAD_DATA: The buffer has no statistics.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_get_stats(circ_buff_ptr circ_buff_pointer, circ_buff_stats_snapshot* snapshot);
+
+/*
+ * Function:     circ_buff_reset_stats(circ_buff_ptr circ_buff_pointer)
+ * -----------------------------------------------------------------------------
+ * Description:  Sets the counters and the histogram back to zero and the high
+ *               water mark to the current occupancy. Elements already in the
+ *               buffer keep their time stamps.
+ *
+ * Usage:        Call from the thread that uses the buffer.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_BAD_DATA: The buffer has no statistics.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_reset_stats(circ_buff_ptr circ_buff_pointer);
+
+/*
+ * Function:     circ_buff_stats_bucket_floor(uint32_t bucket)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the smallest residence time in nanoseconds that falls
+ *               in histogram bucket 'bucket'.
+ * ----------------------------------------------------------------------------
+ */
+uint64_t circ_buff_stats_bucket_floor(uint32_t bucket);
+
+/*
+ * Function:     circ_buff_stats_percentile(const circ_buff_stats_snapshot* snapshot,
+ *                                          double percent, uint64_t* ns)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns in *ns the floor of the bucket that holds the given
+ *               percentile (0 to 100) of the residence times in snapshot.
+ *
+ * Returns:      Error codes:
+ *               CIRC_BUFF_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               CIRC_BUFF_BAD_DATA: percent is not within 0 to 100.
+ *
+ *               CIRC_BUFF_EMPTY: No residence time was recorded.
+ *
+ *               CIRC_BUFF_SUCCESS: The function completes execution
+ *               completely.
+ * ----------------------------------------------------------------------------
+ */
+circ_buff_code circ_buff_stats_percentile(const circ_buff_stats_snapshot* snapshot, double percent, uint64_t* ns);
+
+#endif
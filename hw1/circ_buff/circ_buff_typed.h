@@ -0,0 +1,230 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         circ_buff_typed.h
+ *
+ * Description:  Macros that generate circular buffers for any element type
+ *               with the same status codes as circ_buff.h. Everything is
+ *               static inline and lives in this header; there is no .c file.
+ *
+ *               CIRC_BUFF_DEFINE_STATIC(name, type, capacity) generates a
+ *               buffer whose capacity is a compile time power of two. The
+ *               elements are stored inside the structure, so the buffer can
+ *               live on the stack or in static storage without malloc, and
+ *               the compiler folds the wraparound into a constant mask.
+ *
+ *               CIRC_BUFF_DEFINE(name, type) generates a heap allocated
+ *               buffer whose capacity is chosen at init (rounded up to a
+ *               power of two).
+ *
+ *               Example:
+ *                    CIRC_BUFF_DEFINE_STATIC(ts_ring, uint64_t, 256)
+ *
+ *                    static ts_ring ring;
+ *                    ts_ring_init(&ring);
+ *                    ts_ring_write(&ring, now);
+ *
+ * */
+
+#ifndef _CIRC_BUFF_TYPED_H
+#define _CIRC_BUFF_TYPED_H
+
+#include<stdint.h>
+#include<stdlib.h>
+#include "circ_buff.h"
+
+
+/*
+ * Macro:        CIRC_BUFF_DEFINE_STATIC(name, type, capacity)
+ * -----------------------------------------------------------------------------
+ * Description:  Defines the structure 'name' holding 'capacity' elements of
+ *               'type' and the functions below. capacity must be a power of
+ *               two; this is checked at compile time.
+ *
+ *               circ_buff_code name_init(name* cb)
+ *               circ_buff_code if_name_full(const name* cb)
+ *               circ_buff_code if_name_empty(const name* cb)
+ *               uint32_t       name_size(const name* cb)
+ *               circ_buff_code name_write(name* cb, type data)
+ *               circ_buff_code name_read(name* cb, type* data)
+ *
+ *               The return codes mean the same as for the circ_buff function
+ *               of the same name.
+ * ----------------------------------------------------------------------------
+ */
+#define CIRC_BUFF_DEFINE_STATIC(name, type, capacity)                          \
+                                                                               \
+_Static_assert((capacity)>0&&((capacity)&((capacity)-1))==0,                   \
+               #name ": capacity must be a power of two");                     \
+_Static_assert((capacity)<=(UINT32_C(1)<<31),                                  \
+               #name ": capacity must fit the 32 bit counters");               \
+                                                                               \
+typedef struct name                                                            \
+{                                                                              \
+    uint32_t head;                                                             \
+    uint32_t tail;                                                             \
+    type     base[capacity];                                                   \
+}name;                                                                         \
+                                                                               \
+static inline circ_buff_code name##_init(name* cb)                             \
+{                                                                              \
+    if(cb==NULL)                                                               \
+         return CIRC_BUFF_NULL_PTR;                                            \
+    cb->head=0;                                                                \
+    cb->tail=0;                                                                \
+    return CIRC_BUFF_SUCCESS;                                                  \
+}                                                                              \
+                                                                               \
+static inline uint32_t name##_size(const name* cb)                             \
+{                                                                              \
+    return cb->tail-cb->head;                                                  \
+}                                                                              \
+                                                                               \
+static inline circ_buff_code if_##name##_full(const name* cb)                  \
+{                                                                              \
+    if(cb==NULL)                                                               \
+         return CIRC_BUFF_NULL_PTR;                                            \
+    return cb->tail-cb->head==(capacity)? CIRC_BUFF_FULL: CIRC_BUFF_CAN_WRITE; \
+}                                                                              \
+                                                                               \
+static inline circ_buff_code if_##name##_empty(const name* cb)                 \
+{                                                                              \
+    if(cb==NULL)                                                               \
+         return CIRC_BUFF_NULL_PTR;                                            \
+    return cb->tail==cb->head? CIRC_BUFF_EMPTY: CIRC_BUFF_CAN_READ;            \
+}                                                                              \
+                                                                               \
+static inline circ_buff_code name##_write(name* cb, type data)                 \
+{                                                                              \
+    if(cb==NULL)                                                               \
+         return CIRC_BUFF_NULL_PTR;                                            \
+    if(cb->tail-cb->head==(capacity))                                          \
+         return CIRC_BUFF_FULL;                                                \
+    cb->base[cb->tail&((capacity)-1)]=data;                                    \
+    cb->tail++;                                                                \
+    return CIRC_BUFF_SUCCESS;                                                  \
+}                                                                              \
+                                                                               \
+static inline circ_buff_code name##_read(name* cb, type* data)                 \
+{                                                                              \
+    if(cb==NULL||data==NULL)                                                   \
+         return CIRC_BUFF_NULL_PTR;                                            \
+    if(cb->tail==cb->head)                                                     \
+         return CIRC_BUFF_EMPTY;                                               \
+    *data=cb->base[cb->head&((capacity)-1)];                                   \
+    cb->head++;                                                                \
+    return CIRC_BUFF_SUCCESS;                                                  \
+}
+
+
+/*
+ * Macro:        CIRC_BUFF_DEFINE(name, type)
+ * -----------------------------------------------------------------------------
+ * Description:  Defines the structure 'name', the pointer type name_ptr and
+ *               the functions below for a heap allocated buffer of 'type'.
+ *
+ *               circ_buff_code name_init(name_ptr* cb, int32_t size)
+ *               circ_buff_code name_destroy(name_ptr cb)
+ *               circ_buff_code if_name_full(const name* cb)
+ *               circ_buff_code if_name_empty(const name* cb)
+ *               uint32_t       name_size(const name* cb)
+ *               circ_buff_code name_write(name_ptr cb, type data)
+ *               circ_buff_code name_read(name_ptr cb, type* data)
+ *
+ *               name_init rounds size up to a power of two and returns
+ *               CIRC_BUFF_BAD_DATA for a size less than or equal to zero and
+ *               CIRC_BUFF_MALLOC_FAIL if an allocation fails. The other
+ *               return codes mean the same as for the circ_buff function of
+ *               the same name.
+ * ----------------------------------------------------------------------------
+ */
+#define CIRC_BUFF_DEFINE(name, type)                                           \
+                                                                               \
+typedef struct name *name##_ptr;                                               \
+                                                                               \
+typedef struct name                                                            \
+{                                                                              \
+    type    *base;                                                             \
+    uint32_t head;                                                             \
+    uint32_t tail;                                                             \
+    uint32_t total_size;                                                       \
+    uint32_t mask;                                                             \
+}name;                                                                         \
+                                                                               \
+static inline circ_buff_code name##_init(name##_ptr* cb, int32_t size)         \
+{                                                                              \
+    uint32_t total_size=1;                                                     \
+    if(cb==NULL)                                                               \
+         return CIRC_BUFF_NULL_PTR;                                            \
+    if(size<=0)                                                                \
+         return CIRC_BUFF_BAD_DATA;                                            \
+    while(total_size<(uint32_t)size)                                           \
+         total_size<<=1;                                                       \
+    *cb=(name##_ptr)malloc(sizeof(name));                                      \
+    if(*cb==NULL)                                                              \
+         return CIRC_BUFF_MALLOC_FAIL;                                         \
+    (*cb)->base=(type*)malloc((size_t)total_size*sizeof(type));                \
+    if((*cb)->base==NULL)                                                      \
+    {                                                                          \
+         free(*cb);                                                            \
+         return CIRC_BUFF_MALLOC_FAIL;                                         \
+    }                                                                          \
+    (*cb)->head=0;                                                             \
+    (*cb)->tail=0;                                                             \
+    (*cb)->total_size=total_size;                                              \
+    (*cb)->mask=total_size-1;                                                  \
+    return CIRC_BUFF_SUCCESS;                                                  \
+}                                                                              \
+                                                                               \
+static inline circ_buff_code name##_destroy(name##_ptr cb)                     \
+{                                                                              \
+    if(cb==NULL)                                                               \
+         return CIRC_BUFF_NULL_PTR;                                            \
+    free(cb->base);                                                            \
+    free(cb);                                                                  \
+    return CIRC_BUFF_SUCCESS;                                                  \
+}                                                                              \
+                                                                               \
+static inline uint32_t name##_size(const name* cb)                             \
+{                                                                              \
+    return cb->tail-cb->head;                                                  \
+}                                                                              \
+                                                                               \
+static inline circ_buff_code if_##name##_full(const name* cb)                  \
+{                                                                              \
+    if(cb==NULL)                                                               \
+         return CIRC_BUFF_NULL_PTR;                                            \
+    return cb->tail-cb->head==cb->total_size? CIRC_BUFF_FULL:                  \
+                                              CIRC_BUFF_CAN_WRITE;             \
+}                                                                              \
+                                                                               \
+static inline circ_buff_code if_##name##_empty(const name* cb)                 \
+{                                                                              \
+    if(cb==NULL)                                                               \
+         return CIRC_BUFF_NULL_PTR;                                            \
+    return cb->tail==cb->head? CIRC_BUFF_EMPTY: CIRC_BUFF_CAN_READ;            \
+}                                                                              \
+                                                                               \
+static inline circ_buff_code name##_write(name##_ptr cb, type data)            \
+{                                                                              \
+    if(cb==NULL)                                                               \
+         return CIRC_BUFF_NULL_PTR;                                            \
+    if(cb->tail-cb->head==cb->total_size)                                      \
+         return CIRC_BUFF_FULL;                                                \
+    cb->base[cb->tail&cb->mask]=data;                                          \
+    cb->tail++;                                                                \
+    return CIRC_BUFF_SUCCESS;                                                  \
+}                                                                              \
+                                                                               \
+static inline circ_buff_code name##_read(name##_ptr cb, type* data)            \
+{                                                                              \
+    if(cb==NULL||data==NULL)                                                   \
+         return CIRC_BUFF_NULL_PTR;                                            \
+    if(cb->tail==cb->head)                                                     \
+         return CIRC_BUFF_EMPTY;                                               \
+    *data=cb->base[cb->head&cb->mask];                                         \
+    cb->head++;                                                                \
+    return CIRC_BUFF_SUCCESS;                                                  \
+}
+
+#endif
@@ -0,0 +1,425 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         dll_conc.c
+ *
+ * Description:  Contains an implementation of a thread safe doubly linked
+ *               list with a reader/writer lock per node and hand over hand
+ *               traversal.
+ *
+ * */
+
+#define _GNU_SOURCE
+
+#include "dll_conc.h"
+#include<stdint.h>
+#include<stdlib.h>
+#include<stdatomic.h>
+#include<pthread.h>
+
+
+/*
+ * Function:     dll_conc_lock_init(pthread_rwlock_t* lock)
+ * -----------------------------------------------------------------------------
+ * Description:  Initialises the lock of a node. On glibc the lock prefers
+ *               writers, so a stream of searches holding read locks can not
+ *               starve add and remove; elsewhere the platform default applies.
+ *               Returns 0 on success like pthread_rwlock_init.
+ * ----------------------------------------------------------------------------
+ */
+static int dll_conc_lock_init(pthread_rwlock_t* lock)
+{
+#ifdef __GLIBC__
+    pthread_rwlockattr_t attr;
+    int result;
+
+    if((result=pthread_rwlockattr_init(&attr))!=0)
+         return result;
+
+    /*glibc prefers readers by default, even with a writer waiting; the
+     *nonrecursive kind is enough as no thread read locks a node twice*/
+    pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+    result=pthread_rwlock_init(lock, &attr);
+    pthread_rwlockattr_destroy(&attr);
+
+    return result;
+#else
+    return pthread_rwlock_init(lock, NULL);
+#endif
+}
+
+/*
+ * Function:     dll_conc_walk(dll_conc_ptr list, uint32_t position)
+ * -----------------------------------------------------------------------------
+ * Description:  Write locks its way from the head to the node before
+ *               position (the head sentinel for position 0) and returns it
+ *               still locked. Returns NULL with nothing locked if the list
+ *               ends first.
+ * ----------------------------------------------------------------------------
+ */
+static dll_conc_node_ptr dll_conc_walk(dll_conc_ptr list, uint32_t position)
+{
+    dll_conc_node_ptr prev=&list->head, tmp;
+    uint32_t index;
+
+    pthread_rwlock_wrlock(&prev->lock);
+
+    for(index=0; index<position; index++)
+    {
+         tmp=prev->next_ptr;
+         if(tmp==NULL)
+         {
+              pthread_rwlock_unlock(&prev->lock);
+              return NULL;
+         }
+
+         /*take the next lock before letting go of the current one*/
+         pthread_rwlock_wrlock(&tmp->lock);
+         pthread_rwlock_unlock(&prev->lock);
+         prev=tmp;
+    }
+
+    return prev;
+}
+
+/*
+ * Function:     dll_conc_unlink(dll_conc_ptr list, dll_conc_node_ptr prev,
+ *                               dll_conc_node_ptr node)
+ * -----------------------------------------------------------------------------
+ * Description:  Unlinks node, which follows prev, and frees it. Both must be
+ *               write locked by the caller; prev is unlocked on return. No
+ *               other thread can be waiting for node's lock, as it would have
+ *               to hold prev's lock to get there.
+ * ----------------------------------------------------------------------------
+ */
+static void dll_conc_unlink(dll_conc_ptr list, dll_conc_node_ptr prev, dll_conc_node_ptr node)
+{
+    dll_conc_node_ptr next=node->next_ptr;
+
+    prev->next_ptr=next;
+
+    /*the next node's prev_ptr is protected by its own lock*/
+    if(next!=NULL)
+    {
+         pthread_rwlock_wrlock(&next->lock);
+         next->prev_ptr=(prev!=&list->head)? prev: NULL;
+         pthread_rwlock_unlock(&next->lock);
+    }
+
+    atomic_fetch_sub_explicit(&list->count, 1, memory_order_relaxed);
+
+    pthread_rwlock_unlock(&node->lock);
+    pthread_rwlock_unlock(&prev->lock);
+
+    pthread_rwlock_destroy(&node->lock);
+    free(node);
+}
+
+
+/*
+ * Function:     dll_conc_init(dll_conc_ptr* list)
+ * -----------------------------------------------------------------------------
+ * Description:  Allocates an empty concurrent list on the heap.
+ *
+ * Usage:        Pass a pointer to the dll_conc_ptr that should point to the new
+ *               list.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_MALLOC_FAIL: The call to malloc or to initialise the lock
+ *               fails.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_conc_init(dll_conc_ptr* list)
+{
+    //basic pointer check; error handling
+    if(list==NULL)
+         return DLL_NULL_PTR;
+
+    *list=(dll_conc_ptr)malloc(sizeof(dll_conc));
+    if(*list==NULL)
+         return DLL_MALLOC_FAIL;
+
+    if(dll_conc_lock_init(&(*list)->head.lock)!=0)
+    {
+         free(*list);
+         return DLL_MALLOC_FAIL;
+    }
+
+    (*list)->head.next_ptr=NULL;
+    (*list)->head.prev_ptr=NULL;
+    (*list)->head.data=0;
+    atomic_init(&(*list)->count, 0);
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_conc_destroy(dll_conc_ptr list)
+ * -----------------------------------------------------------------------------
+ * Description:  De-allocates all the nodes and the list.
+ *
+ * Usage:        Call once no other thread uses the list.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_conc_destroy(dll_conc_ptr list)
+{
+    //basic pointer check; error handling
+    if(list==NULL)
+         return DLL_NULL_PTR;
+
+    dll_conc_node_ptr tmp=list->head.next_ptr, next;
+
+    while(tmp!=NULL)
+    {
+         next=tmp->next_ptr;
+         pthread_rwlock_destroy(&tmp->lock);
+         free(tmp);
+         tmp=next;
+    }
+
+    pthread_rwlock_destroy(&list->head.lock);
+    free(list);
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_conc_add_node(dll_conc_ptr list, uint32_t position, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Adds a node holding data so that it ends up at 'position' in
+ *               the list, like dll_list_add_node. Only the nodes up to the
+ *               insertion point are locked, one pair at a time.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_BAD_POSITION: position is larger than the size of the
+ *               list when the walk gets there.
+ *
+ *               DLL_MALLOC_FAIL: The node can not be allocated.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_conc_add_node(dll_conc_ptr list, uint32_t position, uint32_t data)
+{
+    //basic pointer check; error handling
+    if(list==NULL)
+         return DLL_NULL_PTR;
+
+    /*allocate before any lock is held*/
+    dll_conc_node_ptr new_node=(dll_conc_node_ptr)malloc(sizeof(dll_conc_node)), prev, next;
+    if(new_node==NULL)
+         return DLL_MALLOC_FAIL;
+
+    if(dll_conc_lock_init(&new_node->lock)!=0)
+    {
+         free(new_node);
+         return DLL_MALLOC_FAIL;
+    }
+
+    new_node->data=data;
+
+    prev=dll_conc_walk(list, position);
+    if(prev==NULL)
+    {
+         pthread_rwlock_destroy(&new_node->lock);
+         free(new_node);
+         return DLL_BAD_POSITION;
+    }
+
+    next=prev->next_ptr;
+    new_node->prev_ptr=(prev!=&list->head)? prev: NULL;
+    new_node->next_ptr=next;
+
+    /*the new node is not reachable yet, so it needs no lock of its own*/
+    if(next!=NULL)
+    {
+         pthread_rwlock_wrlock(&next->lock);
+         next->prev_ptr=new_node;
+         pthread_rwlock_unlock(&next->lock);
+    }
+
+    prev->next_ptr=new_node;
+    atomic_fetch_add_explicit(&list->count, 1, memory_order_relaxed);
+
+    pthread_rwlock_unlock(&prev->lock);
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Name:         dll_conc_remove_node(dll_conc_ptr list, uint32_t position, uint32_t* data)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes the node at 'position' and returns its data in *data,
+ *               like dll_list_remove_node.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_BAD_POSITION: The list's size is not larger than the
+ *               position when the walk gets there.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_conc_remove_node(dll_conc_ptr list, uint32_t position, uint32_t* data)
+{
+    //basic pointer check; error handling
+    if(list==NULL||data==NULL)
+         return DLL_NULL_PTR;
+
+    dll_conc_node_ptr prev=dll_conc_walk(list, position), node;
+    if(prev==NULL)
+         return DLL_BAD_POSITION;
+
+    node=prev->next_ptr;
+    if(node==NULL)
+    {
+         pthread_rwlock_unlock(&prev->lock);
+         return DLL_BAD_POSITION;
+    }
+
+    pthread_rwlock_wrlock(&node->lock);
+    *data=node->data;
+    dll_conc_unlink(list, prev, node);
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_conc_remove_value(dll_conc_ptr list, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes the first node holding data.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_DATA_MISSING: No node holds data.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_conc_remove_value(dll_conc_ptr list, uint32_t data)
+{
+    //basic pointer check; error handling
+    if(list==NULL)
+         return DLL_NULL_PTR;
+
+    dll_conc_node_ptr prev=&list->head, tmp;
+
+    pthread_rwlock_wrlock(&prev->lock);
+
+    for(;;)
+    {
+         tmp=prev->next_ptr;
+         if(tmp==NULL)
+         {
+              pthread_rwlock_unlock(&prev->lock);
+              return DLL_DATA_MISSING;
+         }
+
+         pthread_rwlock_wrlock(&tmp->lock);
+
+         /*both locks are held- unlink right away*/
+         if(tmp->data==data)
+         {
+              dll_conc_unlink(list, prev, tmp);
+              return DLL_SUCCESS;
+         }
+
+         pthread_rwlock_unlock(&prev->lock);
+         prev=tmp;
+    }
+}
+
+
+/*
+ * Function:     dll_conc_search(dll_conc_ptr list, uint32_t data, uint32_t* position)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the position of the first node holding data in
+ *               *position, like dll_search. Takes only read locks, so any
+ *               number of searches run at the same time.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_DATA_MISSING: The data requested to be searched was not
+ *               found in the list.
+ *
+ *               DLL_SUCCESS: The function completes execution
+ *               successfully- the data is found.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_conc_search(dll_conc_ptr list, uint32_t data, uint32_t* position)
+{
+    //basic pointer check; error handling
+    if(list==NULL||position==NULL)
+         return DLL_NULL_PTR;
+
+    dll_conc_node_ptr prev=&list->head, tmp;
+    uint32_t count=0;
+
+    pthread_rwlock_rdlock(&prev->lock);
+
+    for(;;)
+    {
+         tmp=prev->next_ptr;
+         if(tmp==NULL)
+         {
+              pthread_rwlock_unlock(&prev->lock);
+              return DLL_DATA_MISSING;
+         }
+
+         /*read locks are shared, so searches never wait for each other*/
+         pthread_rwlock_rdlock(&tmp->lock);
+         pthread_rwlock_unlock(&prev->lock);
+
+         if(tmp->data==data)
+         {
+              pthread_rwlock_unlock(&tmp->lock);
+              *position=count;
+              return DLL_SUCCESS;
+         }
+
+         count++;
+         prev=tmp;
+    }
+}
+
+
+/*
+ * Function:     dll_conc_size(dll_conc_ptr list, uint32_t* size)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the number of nodes in the list in *size without
+ *               taking a lock.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_conc_size(dll_conc_ptr list, uint32_t* size)
+{
+    //basic pointer check; error handling
+    if(list==NULL||size==NULL)
+         return DLL_NULL_PTR;
+
+    *size=atomic_load_explicit(&list->count, memory_order_relaxed);
+
+    return DLL_SUCCESS;
+}
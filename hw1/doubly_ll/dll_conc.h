@@ -0,0 +1,198 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         dll_conc.h
+ *
+ * Description:  Contains the structures and function prototypes of a thread
+ *               safe doubly linked list defined in dll_conc.c in the same
+ *               directory. Every node has its own reader/writer lock and the
+ *               list is traversed hand over hand, so threads working on
+ *               different parts of the list do not wait for each other and
+ *               any number of searches run in parallel.
+ *
+ *               pthread_rwlock_t is POSIX, so a file including this header
+ *               must be compiled with _POSIX_C_SOURCE or _GNU_SOURCE defined
+ *               (or -std=gnu11).
+ *
+ * */
+
+#ifndef _DLL_CONC_H_
+#define _DLL_CONC_H_
+
+#include<stdint.h>
+#include<stdatomic.h>
+#include<pthread.h>
+#include "doubly_ll.h"
+
+
+/*
+ * Structure:    dll_conc_node
+ * -----------------------------------------------------------------------------
+ * Description:  One node of the concurrent list. lock protects next_ptr,
+ *               prev_ptr and data.
+ * ----------------------------------------------------------------------------
+ */
+typedef struct dll_conc_node *dll_conc_node_ptr;
+
+typedef struct dll_conc_node
+{
+    dll_conc_node_ptr next_ptr;
+    dll_conc_node_ptr prev_ptr;
+    uint32_t data;
+    pthread_rwlock_t lock;
+}dll_conc_node;
+
+
+/*
+ * Structure:    dll_conc
+ * -----------------------------------------------------------------------------
+ * Description:  A thread safe doubly linked list. head is a sentinel node
+ *               before position 0, so the first node is locked and changed
+ *               like any other. count is the number of nodes; it is exact
+ *               when no operation is in flight.
+ *
+ * Working:      Locks are always taken from the head towards the tail and a
+ *               node's lock is taken before the lock of the node before it
+ *               is released, so a thread can never overtake another one or
+ *               find a node freed under it. Searches take read locks; add and
+ *               remove take write locks on the nodes they pass and change.
+ *               On glibc the node locks prefer writers, so a waiting add or
+ *               remove is not starved by searches that keep arriving; on
+ *               other platforms the default rwlock policy applies and may
+ *               prefer readers.
+ *
+ * Usage:        Use the dll_conc_* functions; do not access the members
+ *               directly. A position is only meaningful at the moment the
+ *               function runs, as other threads may change the list right
+ *               after.
+ * ----------------------------------------------------------------------------
+ */
+typedef struct dll_conc *dll_conc_ptr;
+
+typedef struct dll_conc
+{
+    dll_conc_node head;
+    _Atomic uint32_t count;
+}dll_conc;
+
+
+/*
+ * Function:     dll_conc_init(dll_conc_ptr* list)
+ * -----------------------------------------------------------------------------
+ * Description:  Allocates an empty concurrent list on the heap.
+ *
+ * Usage:        Pass a pointer to the dll_conc_ptr that should point to the new
+ *               list.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_MALLOC_FAIL: The call to malloc or to initialise the lock
+ *               fails.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_conc_init(dll_conc_ptr* list);
+
+/*
+ * Function:     dll_conc_destroy(dll_conc_ptr list)
+ * -----------------------------------------------------------------------------
+ * Description:  De-allocates all the nodes and the list.
+ *
+ * Usage:        Call once no other thread uses the list.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_conc_destroy(dll_conc_ptr list);
+
+/*
+ * Function:     dll_conc_add_node(dll_conc_ptr list, uint32_t position, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Adds a node holding data so that it ends up at 'position' in
+ *               the list, like dll_list_add_node. Only the nodes up to the
+ *               insertion point are locked, one pair at a time.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_BAD_POSITION: position is larger than the size of the
+ *               list when the walk gets there.
+ *
+ *               DLL_MALLOC_FAIL: The node can not be allocated.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_conc_add_node(dll_conc_ptr list, uint32_t position, uint32_t data);
+
+/*
+ * Name:         dll_conc_remove_node(dll_conc_ptr list, uint32_t position, uint32_t* data)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes the node at 'position' and returns its data in *data,
+ *               like dll_list_remove_node.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_BAD_POSITION: The list's size is not larger than the
+ *               position when the walk gets there.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_conc_remove_node(dll_conc_ptr list, uint32_t position, uint32_t* data);
+
+/*
+ * Function:     dll_conc_remove_value(dll_conc_ptr list, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes the first node holding data.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_DATA_MISSING: No node holds data.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_conc_remove_value(dll_conc_ptr list, uint32_t data);
+
+/*
+ * Function:     dll_conc_search(dll_conc_ptr list, uint32_t data, uint32_t* position)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the position of the first node holding data in
+ *               *position, like dll_search. Takes only read locks, so any
+ *               number of searches run at the same time.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_DATA_MISSING: The data requested to be searched was not
+ *               found in the list.
+ *
+ *               DLL_SUCCESS: The function completes execution
+ *               successfully- the data is found.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_conc_search(dll_conc_ptr list, uint32_t data, uint32_t* position);
+
+/*
+ * Function:     dll_conc_size(dll_conc_ptr list, uint32_t* size)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the number of nodes in the list in *size without
+ *               taking a lock.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_conc_size(dll_conc_ptr list, uint32_t* size);
+
+#endif
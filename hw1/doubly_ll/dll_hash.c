@@ -0,0 +1,611 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         dll_hash.c
+ *
+ * Description:  Contains an implementation of an open addressing hash index
+ *               from node data to doubly linked list nodes.
+ *
+ * */
+
+#include "dll_hash.h"
+#include<stdint.h>
+#include<stdlib.h>
+#include<string.h>
+
+/*count bit of a slot whose data dll_hash_insert_range has placed already*/
+#define DLL_HASH_PLACED 0x80000000u
+
+/*
+ * Function:     dll_hash_slot(const dll_hash* hash, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the home slot of data: the top bits of a Fibonacci
+ *               (multiplicative) hash, which spreads sequential values well.
+ * ----------------------------------------------------------------------------
+ */
+static uint32_t dll_hash_slot(const dll_hash* hash, uint32_t data)
+{
+    return (uint32_t)(data*UINT32_C(0x9E3779B1))>>hash->shift;
+}
+
+/*
+ * Function:     dll_hash_lookup(dll_hash_ptr hash, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the slot of data, or NULL if no node holds it.
+ * ----------------------------------------------------------------------------
+ */
+static dll_hash_entry* dll_hash_lookup(dll_hash_ptr hash, uint32_t data)
+{
+    uint32_t mask=hash->capacity-1, slot=dll_hash_slot(hash, data);
+
+    /*probe the run until data or an empty slot shows up*/
+    while(hash->entries[slot].count!=0)
+    {
+         if(hash->entries[slot].data==data)
+              return &hash->entries[slot];
+         slot=(slot+1)&mask;
+    }
+
+    return NULL;
+}
+
+/*
+ * Function:     dll_hash_place(dll_hash_ptr hash, const dll_hash_entry* entry)
+ * -----------------------------------------------------------------------------
+ * Description:  Stores a copy of entry in the first empty slot from its home
+ *               slot on. The table must have an empty slot.
+ * ----------------------------------------------------------------------------
+ */
+static void dll_hash_place(dll_hash_ptr hash, const dll_hash_entry* entry)
+{
+    uint32_t mask=hash->capacity-1, slot=dll_hash_slot(hash, entry->data);
+
+    while(hash->entries[slot].count!=0)
+         slot=(slot+1)&mask;
+
+    hash->entries[slot]=*entry;
+    hash->count++;
+}
+
+/*
+ * Function:     dll_hash_delete(dll_hash_ptr hash, dll_hash_entry* entry)
+ * -----------------------------------------------------------------------------
+ * Description:  Empties the slot entry, shifting back every following entry of
+ *               the run that would no longer be reachable from its home slot
+ *               across the hole.
+ * ----------------------------------------------------------------------------
+ */
+static void dll_hash_delete(dll_hash_ptr hash, dll_hash_entry* entry)
+{
+    uint32_t mask=hash->capacity-1, slot=(uint32_t)(entry-hash->entries), next=slot, home;
+
+    for(;;)
+    {
+         next=(next+1)&mask;
+         if(hash->entries[next].count==0)
+              break;
+
+         home=dll_hash_slot(hash, hash->entries[next].data);
+
+         /*the entry stays if its home lies cyclically in (slot, next]*/
+         if(((next-home)&mask)<((next-slot)&mask))
+              continue;
+
+         hash->entries[slot]=hash->entries[next];
+         slot=next;
+    }
+
+    hash->entries[slot].count=0;
+    hash->entries[slot].node=NULL;
+    hash->count--;
+}
+
+/*
+ * Function:     dll_hash_resize(dll_hash_ptr hash, uint32_t capacity)
+ * -----------------------------------------------------------------------------
+ * Description:  Moves the entries to a new table of capacity slots; capacity
+ *               must be a power of two. On a malloc failure the old table is
+ *               kept.
+ * ----------------------------------------------------------------------------
+ */
+static dll_code dll_hash_resize(dll_hash_ptr hash, uint32_t capacity)
+{
+    dll_hash_entry *old=hash->entries;
+    uint32_t old_capacity=hash->capacity, index, shift=32;
+
+    dll_hash_entry *entries=(dll_hash_entry*)calloc(capacity, sizeof(dll_hash_entry));
+    if(entries==NULL)
+         return DLL_MALLOC_FAIL;
+
+    while((UINT32_C(1)<<(32-shift))<capacity)
+         shift--;
+
+    hash->entries=entries;
+    hash->capacity=capacity;
+    hash->shift=shift;
+    hash->count=0;
+
+    for(index=0; index<old_capacity; index++)
+    {
+         if(old[index].count!=0)
+              dll_hash_place(hash, &old[index]);
+    }
+
+    free(old);
+
+    return DLL_SUCCESS;
+}
+
+/*
+ * Function:     dll_hash_add(dll_hash_ptr hash, dll_node_ptr node, int front)
+ * -----------------------------------------------------------------------------
+ * Description:  Adds node under node->data; if other nodes hold the data,
+ *               node becomes the first of them when front is set.
+ * ----------------------------------------------------------------------------
+ */
+static dll_code dll_hash_add(dll_hash_ptr hash, dll_node_ptr node, int front)
+{
+    dll_hash_entry *entry=dll_hash_lookup(hash, node->data), added;
+
+    /*a duplicate only joins the slot of its data*/
+    if(entry!=NULL)
+    {
+         entry->count++;
+         if(front)
+              entry->node=node;
+         return DLL_SUCCESS;
+    }
+
+    /*grow before the table gets more than half full*/
+    if((hash->count+1)>hash->capacity/2)
+    {
+         if(dll_hash_resize(hash, hash->capacity*2)!=DLL_SUCCESS)
+              return DLL_MALLOC_FAIL;
+    }
+
+    added.data=node->data;
+    added.count=1;
+    added.node=node;
+    dll_hash_place(hash, &added);
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_hash_init(dll_hash_ptr* hash, uint32_t capacity)
+ * -----------------------------------------------------------------------------
+ * Description:  Allocates an empty index with room for at least capacity
+ *               keys before it has to grow.
+ *
+ * Usage:        Pass a pointer to the dll_hash_ptr that should point to the new
+ *               index and the expected number of keys; 0 is allowed.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_MALLOC_FAIL: A call to malloc fails.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_hash_init(dll_hash_ptr* hash, uint32_t capacity)
+{
+    //basic pointer check; error handling
+    if(hash==NULL)
+         return DLL_NULL_PTR;
+
+    /*keep the table at most half full*/
+    uint32_t slots=DLL_HASH_MIN_CAPACITY;
+    while(slots/2<capacity&&slots<(UINT32_C(1)<<31))
+         slots<<=1;
+
+    *hash=(dll_hash_ptr)malloc(sizeof(dll_hash));
+    if(*hash==NULL)
+         return DLL_MALLOC_FAIL;
+
+    (*hash)->entries=NULL;
+    (*hash)->capacity=0;
+
+    if(dll_hash_resize(*hash, slots)!=DLL_SUCCESS)
+    {
+         free(*hash);
+         return DLL_MALLOC_FAIL;
+    }
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_hash_destroy(dll_hash_ptr hash)
+ * -----------------------------------------------------------------------------
+ * Description:  De-allocates the index. The nodes it points to are untouched.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_hash_destroy(dll_hash_ptr hash)
+{
+    //basic pointer check; error handling
+    if(hash==NULL)
+         return DLL_NULL_PTR;
+
+    free(hash->entries);
+    free(hash);
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_hash_clear(dll_hash_ptr hash)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes all the entries of the index and keeps its slots.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_hash_clear(dll_hash_ptr hash)
+{
+    //basic pointer check; error handling
+    if(hash==NULL)
+         return DLL_NULL_PTR;
+
+    memset(hash->entries, 0, (size_t)hash->capacity*sizeof(dll_hash_entry));
+    hash->count=0;
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_hash_insert(dll_hash_ptr hash, dll_node_ptr node)
+ * -----------------------------------------------------------------------------
+ * Description:  Adds node to the index under node->data. The node must not be
+ *               in the index already.
+ *
+ * Working:      If other nodes hold the same data, the list is walked from
+ *               node in both directions at once until a node with the same
+ *               data or an end of the list shows whether node comes first,
+ *               so an insert at either end or next to a duplicate is O(1).
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_MALLOC_FAIL: The index has to grow and malloc fails; the
+ *               index is left as it was.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_hash_insert(dll_hash_ptr hash, dll_node_ptr node)
+{
+    //basic pointer check; error handling
+    if(hash==NULL||node==NULL)
+         return DLL_NULL_PTR;
+
+    return dll_hash_insert_range(hash, node, node);
+}
+
+
+/*
+ * Function:     dll_hash_append(dll_hash_ptr hash, dll_node_ptr node)
+ * -----------------------------------------------------------------------------
+ * Description:  Same as dll_hash_insert for a node that comes after every
+ *               node in the index holding the same data, e.g. while the index
+ *               is built from the head of the list. Does not walk the list.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_MALLOC_FAIL: The index has to grow and malloc fails; the
+ *               index is left as it was.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_hash_append(dll_hash_ptr hash, dll_node_ptr node)
+{
+    //basic pointer check; error handling
+    if(hash==NULL||node==NULL)
+         return DLL_NULL_PTR;
+
+    return dll_hash_add(hash, node, 0);
+}
+
+
+/*
+ * Function:     dll_hash_insert_range(dll_hash_ptr hash, dll_node_ptr first,
+ *                                     dll_node_ptr last)
+ * -----------------------------------------------------------------------------
+ * Description:  Adds the linked nodes first to last (inclusive, in list order)
+ *               to the index, e.g. after they were pasted into the list. None
+ *               of them may be in the index already.
+ *
+ * Working:      A node whose data is already in the index from outside the
+ *               range is placed by walking outwards from the ends of the
+ *               range, once per such data rather than once per node, so a
+ *               range pasted at either end of the list is O(k).
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_MALLOC_FAIL: The index has to grow and malloc fails; the
+ *               index is left as it was.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_hash_insert_range(dll_hash_ptr hash, dll_node_ptr first, dll_node_ptr last)
+{
+    //basic pointer check; error handling
+    if(hash==NULL||first==NULL||last==NULL)
+         return DLL_NULL_PTR;
+
+    dll_hash_entry *entry;
+    dll_node_ptr tmp, back, ahead;
+    uint32_t count=1;
+    int front;
+
+    for(tmp=first; tmp!=last; tmp=tmp->next_ptr)
+         count++;
+
+    /*nothing below can fail once there is room for every node*/
+    if(dll_hash_reserve(hash, count)!=DLL_SUCCESS)
+         return DLL_MALLOC_FAIL;
+
+    for(tmp=first; ; tmp=tmp->next_ptr)
+    {
+         entry=dll_hash_lookup(hash, tmp->data);
+
+         if(entry==NULL)
+         {
+              dll_hash_add(hash, tmp, 1);
+              dll_hash_lookup(hash, tmp->data)->count|=DLL_HASH_PLACED;
+         }
+         /*an earlier node of the range settled it: tmp comes after that one*/
+         else if(entry->count&DLL_HASH_PLACED)
+              entry->count++;
+         else
+         {
+              /*
+               * step outwards from the range one node per side until one
+               * side settles it: a duplicate or the head behind the range,
+               * or a duplicate or the tail ahead of it; a duplicate ahead
+               * only puts tmp first if it was the first
+               */
+              back=first->prev_ptr;
+              ahead=last->next_ptr;
+              for(;;)
+              {
+                   if(back==NULL)
+                   {
+                        front=1;
+                        break;
+                   }
+                   if(back->data==tmp->data||ahead==NULL)
+                   {
+                        front=0;
+                        break;
+                   }
+                   if(ahead->data==tmp->data)
+                   {
+                        front=(ahead==entry->node);
+                        break;
+                   }
+                   back=back->prev_ptr;
+                   ahead=ahead->next_ptr;
+              }
+
+              entry->count=(entry->count+1)|DLL_HASH_PLACED;
+              if(front)
+                   entry->node=tmp;
+         }
+
+         if(tmp==last)
+              break;
+    }
+
+    for(tmp=first; ; tmp=tmp->next_ptr)
+    {
+         dll_hash_lookup(hash, tmp->data)->count&=~DLL_HASH_PLACED;
+         if(tmp==last)
+              break;
+    }
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_hash_reserve(dll_hash_ptr hash, uint32_t count)
+ * -----------------------------------------------------------------------------
+ * Description:  Grows the index if needed so that count more nodes can be
+ *               inserted without it growing again, even if all of them hold
+ *               new data; those inserts can then not fail.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_MALLOC_FAIL: The index has to grow and malloc fails; the
+ *               index is left as it was.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_hash_reserve(dll_hash_ptr hash, uint32_t count)
+{
+    //basic pointer check; error handling
+    if(hash==NULL)
+         return DLL_NULL_PTR;
+
+    uint32_t capacity=hash->capacity;
+
+    /*same half full limit as dll_hash_insert*/
+    while(capacity/2<hash->count+count&&capacity<(UINT32_C(1)<<31))
+         capacity<<=1;
+
+    if(capacity==hash->capacity)
+         return DLL_SUCCESS;
+
+    return dll_hash_resize(hash, capacity);
+}
+
+
+/*
+ * Function:     dll_hash_remove(dll_hash_ptr hash, dll_node_ptr node)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes node from the index. node->data must still be the
+ *               value it was inserted with.
+ *
+ * Working:      If node is the first of several nodes holding its data, the
+ *               list is walked forward from node to the next one, which
+ *               takes its place.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_DATA_MISSING: No node in the index holds node->data, or
+ *               the only one is another node.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_hash_remove(dll_hash_ptr hash, dll_node_ptr node)
+{
+    //basic pointer check; error handling
+    if(hash==NULL||node==NULL)
+         return DLL_NULL_PTR;
+
+    dll_hash_entry *entry=dll_hash_lookup(hash, node->data);
+    dll_node_ptr tmp;
+
+    if(entry==NULL||(entry->count==1&&entry->node!=node))
+         return DLL_DATA_MISSING;
+
+    if(entry->count==1)
+    {
+         dll_hash_delete(hash, entry);
+         return DLL_SUCCESS;
+    }
+
+    entry->count--;
+
+    /*the next duplicate in list order becomes the first*/
+    if(entry->node==node)
+    {
+         for(tmp=node->next_ptr; tmp!=NULL&&tmp->data!=node->data; tmp=tmp->next_ptr)
+              ;
+         entry->node=tmp;
+    }
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_hash_remove_range(dll_hash_ptr hash, dll_node_ptr first,
+ *                                     dll_node_ptr last)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes the linked nodes first to last (inclusive, in list
+ *               order) from the index, e.g. before they are cut out of the
+ *               list.
+ *
+ * Working:      Keys whose first node is in the range are marked and then
+ *               given their new first node by a single walk from the node
+ *               after last, which stops as soon as every marked key has one,
+ *               instead of one walk per key.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_hash_remove_range(dll_hash_ptr hash, dll_node_ptr first, dll_node_ptr last)
+{
+    //basic pointer check; error handling
+    if(hash==NULL||first==NULL||last==NULL)
+         return DLL_NULL_PTR;
+
+    dll_hash_entry *entry;
+    dll_node_ptr tmp;
+    uint32_t marked=0;
+
+    /*a NULL node marks a key that lost its first node to the range*/
+    for(tmp=first; ; tmp=tmp->next_ptr)
+    {
+         entry=dll_hash_lookup(hash, tmp->data);
+         if(entry!=NULL)
+         {
+              if(entry->count==1)
+              {
+                   if(entry->node==NULL)
+                        marked--;
+                   dll_hash_delete(hash, entry);
+              }
+              else
+              {
+                   entry->count--;
+                   if(entry->node==tmp)
+                   {
+                        entry->node=NULL;
+                        marked++;
+                   }
+              }
+         }
+         if(tmp==last)
+              break;
+    }
+
+    /*the rest of a marked key's nodes all come after the range*/
+    for(tmp=last->next_ptr; tmp!=NULL&&marked!=0; tmp=tmp->next_ptr)
+    {
+         entry=dll_hash_lookup(hash, tmp->data);
+         if(entry!=NULL&&entry->node==NULL)
+         {
+              entry->node=tmp;
+              marked--;
+         }
+    }
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_hash_find(dll_hash_ptr hash, uint32_t data, dll_node_ptr* node)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the first node of the list holding data in *node,
+ *               in O(1) average time however many nodes hold it.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_DATA_MISSING: No node in the index holds data.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_hash_find(dll_hash_ptr hash, uint32_t data, dll_node_ptr* node)
+{
+    //basic pointer check; error handling
+    if(hash==NULL||node==NULL)
+         return DLL_NULL_PTR;
+
+    dll_hash_entry *entry=dll_hash_lookup(hash, data);
+
+    if(entry==NULL)
+         return DLL_DATA_MISSING;
+
+    *node=entry->node;
+
+    return DLL_SUCCESS;
+}
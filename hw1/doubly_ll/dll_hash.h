@@ -0,0 +1,255 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         dll_hash.h
+ *
+ * Description:  Contains the structures and function prototypes of a hash
+ *               index from node data to list nodes defined in dll_hash.c in
+ *               the same directory. A dll_list with an index attached (see
+ *               dll_list_attach_index) finds the first node holding some data
+ *               in O(1) average time instead of scanning the list.
+ *
+ * */
+
+#ifndef _DLL_HASH_H_
+#define _DLL_HASH_H_
+
+#include<stdint.h>
+#include "doubly_ll.h"
+
+/*smallest number of slots of an index*/
+#define DLL_HASH_MIN_CAPACITY 16
+
+
+/*
+ * Structure:    dll_hash_entry
+ * -----------------------------------------------------------------------------
+ * Description:  One slot of the index, for one key. node is the first node of
+ *               the list holding data and count the number of nodes holding
+ *               it; the others follow node in the list, so the list itself is
+ *               the ordered chain of duplicates. data is a copy of the key so
+ *               that a probe compares keys without touching the node; a count
+ *               of zero marks an empty slot.
+ * ----------------------------------------------------------------------------
+ */
+typedef struct dll_hash_entry
+{
+    uint32_t data;
+    uint32_t count;
+    dll_node_ptr node;
+}dll_hash_entry;
+
+
+/*
+ * Structure:    dll_hash
+ * -----------------------------------------------------------------------------
+ * Description:  An open addressing hash table with linear probing that maps
+ *               data to the first of the nodes holding it. Several nodes may
+ *               hold the same data; they share one slot, so duplicates never
+ *               lengthen a probe run and a lookup is O(1) however many there
+ *               are. count is the number of keys. The table doubles when it
+ *               is more than half full and deletes by shifting the following
+ *               slots back, so it never keeps tombstones.
+ *
+ * Usage:        Use the dll_hash_* functions; do not access the members
+ *               directly. The index keeps a node's place among the nodes
+ *               with the same data by following the list links, so a node
+ *               must be linked into its list while it is inserted or removed
+ *               if other nodes hold its data.
+ * ----------------------------------------------------------------------------
+ */
+typedef struct dll_hash
+{
+    dll_hash_entry *entries;
+    uint32_t capacity;
+    uint32_t shift;
+    uint32_t count;
+}dll_hash;
+
+
+/*
+ * Function:     dll_hash_init(dll_hash_ptr* hash, uint32_t capacity)
+ * -----------------------------------------------------------------------------
+ * Description:  Allocates an empty index with room for at least capacity
+ *               keys before it has to grow.
+ *
+ * Usage:        Pass a pointer to the dll_hash_ptr that should point to the new
+ *               index and the expected number of keys; 0 is allowed.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_MALLOC_FAIL: A call to malloc fails.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_hash_init(dll_hash_ptr* hash, uint32_t capacity);
+
+/*
+ * Function:     dll_hash_destroy(dll_hash_ptr hash)
+ * -----------------------------------------------------------------------------
+ * Description:  De-allocates the index. The nodes it points to are untouched.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_hash_destroy(dll_hash_ptr hash);
+
+/*
+ * Function:     dll_hash_clear(dll_hash_ptr hash)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes all the entries of the index and keeps its slots.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_hash_clear(dll_hash_ptr hash);
+
+/*
+ * Function:     dll_hash_insert(dll_hash_ptr hash, dll_node_ptr node)
+ * -----------------------------------------------------------------------------
+ * Description:  Adds node to the index under node->data. The node must not be
+ *               in the index already.
+ *
+ * Working:      If other nodes hold the same data, the list is walked from
+ *               node in both directions at once until a node with the same
+ *               data or an end of the list shows whether node comes first,
+ *               so an insert at either end or next to a duplicate is O(1).
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_MALLOC_FAIL: The index has to grow and malloc fails; the
+ *               index is left as it was.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_hash_insert(dll_hash_ptr hash, dll_node_ptr node);
+
+/*
+ * Function:     dll_hash_append(dll_hash_ptr hash, dll_node_ptr node)
+ * -----------------------------------------------------------------------------
+ * Description:  Same as dll_hash_insert for a node that comes after every
+ *               node in the index holding the same data, e.g. while the index
+ *               is built from the head of the list. Does not walk the list.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_MALLOC_FAIL: The index has to grow and malloc fails; the
+ *               index is left as it was.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_hash_append(dll_hash_ptr hash, dll_node_ptr node);
+
+/*
+ * Function:     dll_hash_insert_range(dll_hash_ptr hash, dll_node_ptr first,
+ *                                     dll_node_ptr last)
+ * -----------------------------------------------------------------------------
+ * Description:  Adds the linked nodes first to last (inclusive, in list order)
+ *               to the index, e.g. after they were pasted into the list. None
+ *               of them may be in the index already.
+ *
+ * Working:      A node whose data is already in the index from outside the
+ *               range is placed by walking outwards from the ends of the
+ *               range, once per such data rather than once per node, so a
+ *               range pasted at either end of the list is O(k).
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_MALLOC_FAIL: The index has to grow and malloc fails; the
+ *               index is left as it was.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_hash_insert_range(dll_hash_ptr hash, dll_node_ptr first, dll_node_ptr last);
+
+/*
+ * Function:     dll_hash_reserve(dll_hash_ptr hash, uint32_t count)
+ * -----------------------------------------------------------------------------
+ * Description:  Grows the index if needed so that count more nodes can be
+ *               inserted without it growing again, even if all of them hold
+ *               new data; those inserts can then not fail.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_MALLOC_FAIL: The index has to grow and malloc fails; the
+ *               index is left as it was.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_hash_reserve(dll_hash_ptr hash, uint32_t count);
+
+/*
+ * Function:     dll_hash_remove(dll_hash_ptr hash, dll_node_ptr node)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes node from the index. node->data must still be the
+ *               value it was inserted with.
+ *
+ * Working:      If node is the first of several nodes holding its data, the
+ *               list is walked forward from node to the next one, which
+ *               takes its place.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_DATA_MISSING: No node in the index holds node->data, or
+ *               the only one is another node.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_hash_remove(dll_hash_ptr hash, dll_node_ptr node);
+
+/*
+ * Function:     dll_hash_remove_range(dll_hash_ptr hash, dll_node_ptr first,
+ *                                     dll_node_ptr last)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes the linked nodes first to last (inclusive, in list
+ *               order) from the index, e.g. before they are cut out of the
+ *               list.
+ *
+ * Working:      Keys whose first node is in the range are marked and then
+ *               given their new first node by a single walk from the node
+ *               after last, which stops as soon as every marked key has one,
+ *               instead of one walk per key.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_hash_remove_range(dll_hash_ptr hash, dll_node_ptr first, dll_node_ptr last);
+
+/*
+ * Function:     dll_hash_find(dll_hash_ptr hash, uint32_t data, dll_node_ptr* node)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the first node of the list holding data in *node,
+ *               in O(1) average time however many nodes hold it.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_DATA_MISSING: No node in the index holds data.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_hash_find(dll_hash_ptr hash, uint32_t data, dll_node_ptr* node);
+
+#endif
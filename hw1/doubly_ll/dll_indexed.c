@@ -0,0 +1,425 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         dll_indexed.c
+ *
+ * Description:  Contains an implementation of an indexed doubly linked list
+ *               (an indexable skip list) with O(log n) positional access.
+ *
+ *               The rank of a node is its position plus one; the head sentinel
+ *               has rank 0 and one past the last node has rank count+1. The
+ *               width of a link is the rank of its next node (or of one past
+ *               the end for a NULL next) minus the rank of its own node.
+ *
+ * */
+
+#include "dll_indexed.h"
+#include<stdint.h>
+#include<stdlib.h>
+
+
+/*
+ * Function:     dll_indexed_alloc_node(uint32_t levels)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns memory for a node with 'levels' links or NULL.
+ * ----------------------------------------------------------------------------
+ */
+static dll_indexed_node_ptr dll_indexed_alloc_node(uint32_t levels)
+{
+    dll_indexed_node_ptr node=(dll_indexed_node_ptr)malloc(sizeof(dll_indexed_node)+levels*sizeof(dll_indexed_link));
+
+    if(node!=NULL)
+         node->levels=levels;
+
+    return node;
+}
+
+/*
+ * Function:     dll_indexed_random_level(dll_indexed_ptr list)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the number of levels of a new node: 1, plus one more
+ *               with probability 1/4 each time, up to DLL_INDEXED_MAX_LEVEL.
+ *               Uses a xorshift generator kept in the handle.
+ * ----------------------------------------------------------------------------
+ */
+static uint32_t dll_indexed_random_level(dll_indexed_ptr list)
+{
+    uint32_t x=list->seed, levels=1;
+
+    x^=x<<13;
+    x^=x>>17;
+    x^=x<<5;
+    list->seed=x;
+
+    /*every pair of zero bits from the bottom is one more level*/
+    while((x&3)==0&&levels<DLL_INDEXED_MAX_LEVEL)
+    {
+         levels++;
+         x>>=2;
+    }
+
+    return levels;
+}
+
+/*
+ * Function:     dll_indexed_find(dll_indexed_ptr list, uint32_t rank,
+ *                                dll_indexed_node_ptr* update, uint32_t* ranks)
+ * -----------------------------------------------------------------------------
+ * Description:  For every level in use, stores in update[level] the last node
+ *               whose rank is not larger than 'rank', and its rank in
+ *               ranks[level]. ranks may be NULL.
+ * ----------------------------------------------------------------------------
+ */
+static void dll_indexed_find(dll_indexed_ptr list, uint32_t rank,
+                             dll_indexed_node_ptr* update, uint32_t* ranks)
+{
+    dll_indexed_node_ptr tmp=list->head;
+    uint32_t traversed=0, level=list->level;
+
+    /*go right as far as possible on each level, then one level down. A
+     *list always uses at least one level, so the body runs at least once
+     *and every slot down to update[0] is written*/
+    do
+    {
+         level--;
+
+         while(tmp->links[level].next!=NULL&&traversed+tmp->links[level].width<=rank)
+         {
+              traversed+=tmp->links[level].width;
+              tmp=tmp->links[level].next;
+         }
+
+         update[level]=tmp;
+         if(ranks!=NULL)
+              ranks[level]=traversed;
+    }while(level>0);
+}
+
+
+/*
+ * Function:     dll_indexed_init(dll_indexed_ptr* list)
+ * -----------------------------------------------------------------------------
+ * Description:  Allocates an empty indexed list handle and its head sentinel
+ *               on the heap.
+ *
+ * Usage:        Pass a pointer to the dll_indexed_ptr that should point to the
+ *               new list.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_MALLOC_FAIL: The call to malloc fails.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_indexed_init(dll_indexed_ptr* list)
+{
+    //basic pointer check; error handling
+    if(list==NULL)
+         return DLL_NULL_PTR;
+
+    *list=(dll_indexed_ptr)malloc(sizeof(dll_indexed));
+    if(*list==NULL)
+         return DLL_MALLOC_FAIL;
+
+    (*list)->head=dll_indexed_alloc_node(DLL_INDEXED_MAX_LEVEL);
+    if((*list)->head==NULL)
+    {
+         free(*list);
+         return DLL_MALLOC_FAIL;
+    }
+
+    /*an empty list has one level whose link spans to one past the end*/
+    (*list)->head->prev_ptr=NULL;
+    (*list)->head->links[0].next=NULL;
+    (*list)->head->links[0].width=1;
+    (*list)->tail=NULL;
+    (*list)->count=0;
+    (*list)->level=1;
+    (*list)->seed=0x9e3779b9u;
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_indexed_destroy(dll_indexed_ptr list)
+ * -----------------------------------------------------------------------------
+ * Description:  De-allocates all the nodes of the list, the head sentinel and
+ *               the list handle.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_indexed_destroy(dll_indexed_ptr list)
+{
+    //basic pointer check; error handling
+    if(list==NULL)
+         return DLL_NULL_PTR;
+
+    dll_indexed_node_ptr tmp=list->head, next;
+
+    /*the sentinel is freed along with the nodes*/
+    while(tmp!=NULL)
+    {
+         next=tmp->links[0].next;
+         free(tmp);
+         tmp=next;
+    }
+
+    free(list);
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_indexed_add_node(dll_indexed_ptr list, uint32_t position, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Adds a node holding data so that it ends up at 'position' in
+ *               the list, like dll_list_add_node, in O(log n) expected time.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_BAD_POSITION: position is larger than the size of the
+ *               list.
+ *
+ *               DLL_MALLOC_FAIL: The node can not be allocated.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_indexed_add_node(dll_indexed_ptr list, uint32_t position, uint32_t data)
+{
+    //basic pointer check; error handling
+    if(list==NULL)
+         return DLL_NULL_PTR;
+
+    if(position>list->count)
+         return DLL_BAD_POSITION;
+
+    dll_indexed_node_ptr update[DLL_INDEXED_MAX_LEVEL], new_node;
+    uint32_t ranks[DLL_INDEXED_MAX_LEVEL], levels, level, rank=position+1;
+
+    levels=dll_indexed_random_level(list);
+    new_node=dll_indexed_alloc_node(levels);
+
+    /*malloc check*/
+    if(new_node==NULL)
+         return DLL_MALLOC_FAIL;
+
+    dll_indexed_find(list, position, update, ranks);
+
+    /*new levels start out as one head link spanning the whole list*/
+    for(level=list->level; level<levels; level++)
+    {
+         list->head->links[level].next=NULL;
+         list->head->links[level].width=list->count+1;
+         update[level]=list->head;
+         ranks[level]=0;
+    }
+    if(levels>list->level)
+         list->level=levels;
+
+    /*split the links that pass over the new node's rank*/
+    for(level=0; level<levels; level++)
+    {
+         new_node->links[level].next=update[level]->links[level].next;
+         new_node->links[level].width=ranks[level]+update[level]->links[level].width+1-rank;
+         update[level]->links[level].next=new_node;
+         update[level]->links[level].width=rank-ranks[level];
+    }
+
+    /*the links above it now pass over one more node*/
+    for(; level<list->level; level++)
+         update[level]->links[level].width++;
+
+    /*level 0 is the doubly linked list*/
+    new_node->data=data;
+    new_node->prev_ptr=(update[0]!=list->head)? update[0]: NULL;
+    if(new_node->links[0].next!=NULL)
+         new_node->links[0].next->prev_ptr=new_node;
+    else
+         list->tail=new_node;
+
+    list->count++;
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Name:         dll_indexed_remove_node(dll_indexed_ptr list, uint32_t position, uint32_t* data)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes the node at 'position' and returns its data in *data,
+ *               like dll_list_remove_node, in O(log n) expected time.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_BAD_POSITION: The list's size is not larger than the
+ *               position specified.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_indexed_remove_node(dll_indexed_ptr list, uint32_t position, uint32_t* data)
+{
+    //basic pointer check; error handling
+    if(list==NULL||data==NULL)
+         return DLL_NULL_PTR;
+
+    if(position>=list->count)
+         return DLL_BAD_POSITION;
+
+    dll_indexed_node_ptr update[DLL_INDEXED_MAX_LEVEL], delete_node;
+    uint32_t level;
+
+    dll_indexed_find(list, position, update, NULL);
+    delete_node=update[0]->links[0].next;
+
+    /*join the links around the node; the others pass over one node less*/
+    for(level=0; level<list->level; level++)
+    {
+         if(update[level]->links[level].next==delete_node)
+         {
+              update[level]->links[level].width+=delete_node->links[level].width-1;
+              update[level]->links[level].next=delete_node->links[level].next;
+         }
+         else
+              update[level]->links[level].width--;
+    }
+
+    if(delete_node->links[0].next!=NULL)
+         delete_node->links[0].next->prev_ptr=delete_node->prev_ptr;
+    else
+         list->tail=delete_node->prev_ptr;
+
+    /*drop the levels that no node uses any more*/
+    while(list->level>1&&list->head->links[list->level-1].next==NULL)
+         list->level--;
+
+    list->count--;
+
+    *data=delete_node->data;
+    free(delete_node);
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_indexed_get(dll_indexed_ptr list, uint32_t position, uint32_t* data)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the data of the node at 'position' in *data in
+ *               O(log n) expected time.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_BAD_POSITION: The list's size is not larger than the
+ *               position specified.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_indexed_get(dll_indexed_ptr list, uint32_t position, uint32_t* data)
+{
+    //basic pointer check; error handling
+    if(list==NULL||data==NULL)
+         return DLL_NULL_PTR;
+
+    if(position>=list->count)
+         return DLL_BAD_POSITION;
+
+    dll_indexed_node_ptr tmp=list->head;
+    uint32_t traversed=0, level=list->level, rank=position+1;
+
+    /*same walk as dll_indexed_find, stopping on the node itself*/
+    while(level-->0)
+    {
+         while(tmp->links[level].next!=NULL&&traversed+tmp->links[level].width<=rank)
+         {
+              traversed+=tmp->links[level].width;
+              tmp=tmp->links[level].next;
+         }
+
+         if(traversed==rank)
+              break;
+    }
+
+    *data=tmp->data;
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_indexed_size(dll_indexed_ptr list, uint32_t* size)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the number of nodes in the list in *size. The count is
+ *               kept in the handle, so this does not walk the list.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_indexed_size(dll_indexed_ptr list, uint32_t* size)
+{
+    //basic pointer check; error handling
+    if(list==NULL||size==NULL)
+         return DLL_NULL_PTR;
+
+    *size=list->count;
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_indexed_search(dll_indexed_ptr list, uint32_t data, uint32_t* position)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the position of the first node holding data in
+ *               *position, like dll_search. The list is not ordered by value,
+ *               so this is a walk along level 0.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_DATA_MISSING: The data requested to be searched was not
+ *               found in the list.
+ *
+ *               DLL_SUCCESS: The function completes execution
+ *               successfully- the data is found.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_indexed_search(dll_indexed_ptr list, uint32_t data, uint32_t* position)
+{
+    //basic pointer check; error handling
+    if(list==NULL||position==NULL)
+         return DLL_NULL_PTR;
+
+    dll_indexed_node_ptr tmp=list->head->links[0].next;
+    uint32_t count=0;
+
+    /*check the entire list to see if data is found*/
+    while(tmp!=NULL)
+    {
+         if(tmp->data==data)
+         {
+              *position=count;
+              return DLL_SUCCESS;
+         }
+         count++;
+         tmp=tmp->links[0].next;
+    }
+
+    return DLL_DATA_MISSING;
+}
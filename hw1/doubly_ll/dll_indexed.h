@@ -0,0 +1,207 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         dll_indexed.h
+ *
+ * Description:  Contains the structures and function prototypes of an indexed
+ *               doubly linked list defined in dll_indexed.c in the same
+ *               directory. The list is an indexable skip list: the nodes form
+ *               an ordinary doubly linked list on level 0 and carry extra
+ *               forward links that skip over a counted number of nodes, so a
+ *               position is reached in O(log n) instead of O(n).
+ *
+ * */
+
+#ifndef _DLL_INDEXED_H_
+#define _DLL_INDEXED_H_
+
+#include<stdint.h>
+#include "doubly_ll.h"
+
+/*maximum number of levels; with a 1 in 4 promotion this covers 2^32 nodes*/
+#define DLL_INDEXED_MAX_LEVEL 16
+
+
+/*
+ * Structure:    dll_indexed_link
+ * -----------------------------------------------------------------------------
+ * Description:  One forward link of a node. width is the number of positions
+ *               the link moves forward; a link with a NULL next counts up to
+ *               one past the end of the list.
+ * ----------------------------------------------------------------------------
+ */
+typedef struct dll_indexed_node *dll_indexed_node_ptr;
+
+typedef struct dll_indexed_link
+{
+    dll_indexed_node_ptr next;
+    uint32_t width;
+}dll_indexed_link;
+
+
+/*
+ * Structure:    dll_indexed_node
+ * -----------------------------------------------------------------------------
+ * Description:  One node of the indexed list. links[0].next and prev_ptr are
+ *               the usual doubly linked list pointers; links[1..levels-1] are
+ *               the skip links. The node is allocated with room for exactly
+ *               'levels' links.
+ *
+ * Usage:        Use regular structure syntax to read the members; change the
+ *               list only through the dll_indexed_* functions.
+ * ----------------------------------------------------------------------------
+ */
+typedef struct dll_indexed_node
+{
+    dll_indexed_node_ptr prev_ptr;
+    uint32_t data;
+    uint32_t levels;
+    dll_indexed_link links[];
+}dll_indexed_node;
+
+
+/*
+ * Structure:    dll_indexed
+ * -----------------------------------------------------------------------------
+ * Description:  A handle for an indexed list. head is a sentinel node with
+ *               DLL_INDEXED_MAX_LEVEL links that sits before position 0;
+ *               level is the number of levels currently in use and seed the
+ *               state of the generator that picks the level of a new node.
+ *
+ * Usage:        Create it with dll_indexed_init and change the list only
+ *               through the dll_indexed_* functions so that the members stay
+ *               in sync.
+ * ----------------------------------------------------------------------------
+ */
+typedef struct dll_indexed *dll_indexed_ptr;
+
+typedef struct dll_indexed
+{
+    dll_indexed_node_ptr head;
+    dll_indexed_node_ptr tail;
+    uint32_t count;
+    uint32_t level;
+    uint32_t seed;
+}dll_indexed;
+
+
+/*
+ * Function:     dll_indexed_init(dll_indexed_ptr* list)
+ * -----------------------------------------------------------------------------
+ * Description:  Allocates an empty indexed list handle and its head sentinel
+ *               on the heap.
+ *
+ * Usage:        Pass a pointer to the dll_indexed_ptr that should point to the
+ *               new list.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_MALLOC_FAIL: The call to malloc fails.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_indexed_init(dll_indexed_ptr* list);
+
+/*
+ * Function:     dll_indexed_destroy(dll_indexed_ptr list)
+ * -----------------------------------------------------------------------------
+ * Description:  De-allocates all the nodes of the list, the head sentinel and
+ *               the list handle.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_indexed_destroy(dll_indexed_ptr list);
+
+/*
+ * Function:     dll_indexed_add_node(dll_indexed_ptr list, uint32_t position, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Adds a node holding data so that it ends up at 'position' in
+ *               the list, like dll_list_add_node, in O(log n) expected time.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_BAD_POSITION: position is larger than the size of the
+ *               list.
+ *
+ *               DLL_MALLOC_FAIL: The node can not be allocated.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_indexed_add_node(dll_indexed_ptr list, uint32_t position, uint32_t data);
+
+/*
+ * Name:         dll_indexed_remove_node(dll_indexed_ptr list, uint32_t position, uint32_t* data)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes the node at 'position' and returns its data in *data,
+ *               like dll_list_remove_node, in O(log n) expected time.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_BAD_POSITION: The list's size is not larger than the
+ *               position specified.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_indexed_remove_node(dll_indexed_ptr list, uint32_t position, uint32_t* data);
+
+/*
+ * Function:     dll_indexed_get(dll_indexed_ptr list, uint32_t position, uint32_t* data)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the data of the node at 'position' in *data in
+ *               O(log n) expected time.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_BAD_POSITION: The list's size is not larger than the
+ *               position specified.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_indexed_get(dll_indexed_ptr list, uint32_t position, uint32_t* data);
+
+/*
+ * Function:     dll_indexed_size(dll_indexed_ptr list, uint32_t* size)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the number of nodes in the list in *size. The count is
+ *               kept in the handle, so this does not walk the list.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_indexed_size(dll_indexed_ptr list, uint32_t* size);
+
+/*
+ * Function:     dll_indexed_search(dll_indexed_ptr list, uint32_t data, uint32_t* position)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the position of the first node holding data in
+ *               *position, like dll_search. The list is not ordered by value,
+ *               so this is a walk along level 0.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_DATA_MISSING: The data requested to be searched was not
+ *               found in the list.
+ *
+ *               DLL_SUCCESS: The function completes execution
+ *               successfully- the data is found.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_indexed_search(dll_indexed_ptr list, uint32_t data, uint32_t* position);
+
+#endif
@@ -0,0 +1,279 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         dll_intrusive.h
+ *
+ * Description:  An intrusive doubly linked list. The links live inside the
+ *               caller's own structure, so putting a record on a list needs
+ *               no allocation and the record's payload shares a cache line
+ *               with its links. Everything is static inline and lives in
+ *               this header; there is no .c file.
+ *
+ *               A list is a dll_link used as a sentinel: an empty list points
+ *               to itself, so inserting and unlinking never special-case the
+ *               ends of the list.
+ *
+ *               Example:
+ *                    typedef struct job
+ *                    {
+ *                         uint32_t id;
+ *                         dll_link link;
+ *                    }job;
+ *
+ *                    dll_link queue;
+ *                    dll_link *pos;
+ *
+ *                    dll_link_init(&queue);
+ *                    dll_link_push_back(&queue, &some_job->link);
+ *
+ *                    DLL_LINK_FOR_EACH(pos, &queue)
+ *                         handle(DLL_CONTAINER_OF(pos, job, link));
+ *
+ *                    dll_link_unlink(&some_job->link);
+ *
+ * */
+
+#ifndef _DLL_INTRUSIVE_H_
+#define _DLL_INTRUSIVE_H_
+
+#include<stddef.h>
+#include "doubly_ll.h"
+
+
+/*
+ * Macro:        DLL_CONTAINER_OF(ptr, type, member)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns a pointer to the 'type' structure whose dll_link
+ *               member 'member' is at ptr.
+ * ----------------------------------------------------------------------------
+ */
+#define DLL_CONTAINER_OF(ptr, type, member)                                    \
+    ((type*)((char*)(ptr)-offsetof(type, member)))
+
+/*
+ * Macro:        DLL_LINK_FOR_EACH(pos, head)
+ * -----------------------------------------------------------------------------
+ * Description:  Loops pos over the links of the list head from front to back.
+ *               pos must not be unlinked inside the loop; use
+ *               DLL_LINK_FOR_EACH_SAFE for that.
+ * ----------------------------------------------------------------------------
+ */
+#define DLL_LINK_FOR_EACH(pos, head)                                           \
+    for((pos)=(head)->next_ptr; (pos)!=(head); (pos)=(pos)->next_ptr)
+
+/*
+ * Macro:        DLL_LINK_FOR_EACH_SAFE(pos, tmp, head)
+ * -----------------------------------------------------------------------------
+ * Description:  Same as DLL_LINK_FOR_EACH, but the next link is saved in tmp
+ *               first, so pos may be unlinked inside the loop.
+ * ----------------------------------------------------------------------------
+ */
+#define DLL_LINK_FOR_EACH_SAFE(pos, tmp, head)                                 \
+    for((pos)=(head)->next_ptr, (tmp)=(pos)->next_ptr; (pos)!=(head);          \
+        (pos)=(tmp), (tmp)=(pos)->next_ptr)
+
+
+/*
+ * Structure:    dll_link
+ * -----------------------------------------------------------------------------
+ * Description:  The links of one element, embedded in the caller's structure,
+ *               or the sentinel of a list. A link that is on no list points
+ *               to itself after dll_link_init or dll_link_unlink.
+ *
+ * Usage:        Use the dll_link_* functions to change the links.
+ * ----------------------------------------------------------------------------
+ */
+typedef struct dll_link
+{
+    struct dll_link *next_ptr;
+    struct dll_link *prev_ptr;
+}dll_link;
+
+
+/*
+ * Function:     dll_link_init(dll_link* link)
+ * -----------------------------------------------------------------------------
+ * Description:  Makes link an empty list, or marks an element's link as not
+ *               on any list.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+static inline dll_code dll_link_init(dll_link* link)
+{
+    if(link==NULL)
+         return DLL_NULL_PTR;
+
+    link->next_ptr=link;
+    link->prev_ptr=link;
+
+    return DLL_SUCCESS;
+}
+
+/*
+ * Function:     dll_link_empty(const dll_link* head)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns non-zero if the list head has no elements, or if the
+ *               element link head is not on a list.
+ * ----------------------------------------------------------------------------
+ */
+static inline int dll_link_empty(const dll_link* head)
+{
+    return head->next_ptr==head;
+}
+
+/*
+ * Function:     dll_link_insert_after(dll_link* pos, dll_link* link)
+ * -----------------------------------------------------------------------------
+ * Description:  Links link in right after pos, which is an element or the
+ *               sentinel of a list. link must not be on a list.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+static inline dll_code dll_link_insert_after(dll_link* pos, dll_link* link)
+{
+    if(pos==NULL||link==NULL)
+         return DLL_NULL_PTR;
+
+    link->prev_ptr=pos;
+    link->next_ptr=pos->next_ptr;
+    pos->next_ptr->prev_ptr=link;
+    pos->next_ptr=link;
+
+    return DLL_SUCCESS;
+}
+
+/*
+ * Function:     dll_link_insert_before(dll_link* pos, dll_link* link)
+ * -----------------------------------------------------------------------------
+ * Description:  Links link in right before pos, which is an element or the
+ *               sentinel of a list. link must not be on a list.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+static inline dll_code dll_link_insert_before(dll_link* pos, dll_link* link)
+{
+    if(pos==NULL)
+         return DLL_NULL_PTR;
+
+    return dll_link_insert_after(pos->prev_ptr, link);
+}
+
+/*
+ * Function:     dll_link_push_front(dll_link* head, dll_link* link)
+ * -----------------------------------------------------------------------------
+ * Description:  Makes link the first element of the list head.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+static inline dll_code dll_link_push_front(dll_link* head, dll_link* link)
+{
+    return dll_link_insert_after(head, link);
+}
+
+/*
+ * Function:     dll_link_push_back(dll_link* head, dll_link* link)
+ * -----------------------------------------------------------------------------
+ * Description:  Makes link the last element of the list head.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+static inline dll_code dll_link_push_back(dll_link* head, dll_link* link)
+{
+    return dll_link_insert_before(head, link);
+}
+
+/*
+ * Function:     dll_link_unlink(dll_link* link)
+ * -----------------------------------------------------------------------------
+ * Description:  Takes link off its list in O(1), without knowing the list,
+ *               and leaves it pointing to itself. Unlinking a link that is on
+ *               no list does nothing.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+static inline dll_code dll_link_unlink(dll_link* link)
+{
+    if(link==NULL)
+         return DLL_NULL_PTR;
+
+    link->prev_ptr->next_ptr=link->next_ptr;
+    link->next_ptr->prev_ptr=link->prev_ptr;
+    link->next_ptr=link;
+    link->prev_ptr=link;
+
+    return DLL_SUCCESS;
+}
+
+/*
+ * Function:     dll_link_first(const dll_link* head)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the first element of the list head, or NULL if the
+ *               list is empty.
+ * ----------------------------------------------------------------------------
+ */
+static inline dll_link* dll_link_first(const dll_link* head)
+{
+    return (head->next_ptr!=head)? head->next_ptr: NULL;
+}
+
+/*
+ * Function:     dll_link_last(const dll_link* head)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the last element of the list head, or NULL if the
+ *               list is empty.
+ * ----------------------------------------------------------------------------
+ */
+static inline dll_link* dll_link_last(const dll_link* head)
+{
+    return (head->prev_ptr!=head)? head->prev_ptr: NULL;
+}
+
+/*
+ * Function:     dll_link_next(const dll_link* head, const dll_link* link)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the element after link on the list head, or NULL if
+ *               link is the last one.
+ * ----------------------------------------------------------------------------
+ */
+static inline dll_link* dll_link_next(const dll_link* head, const dll_link* link)
+{
+    return (link->next_ptr!=head)? link->next_ptr: NULL;
+}
+
+/*
+ * Function:     dll_link_prev(const dll_link* head, const dll_link* link)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the element before link on the list head, or NULL if
+ *               link is the first one.
+ * ----------------------------------------------------------------------------
+ */
+static inline dll_link* dll_link_prev(const dll_link* head, const dll_link* link)
+{
+    return (link->prev_ptr!=head)? link->prev_ptr: NULL;
+}
+
+#endif
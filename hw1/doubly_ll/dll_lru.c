@@ -0,0 +1,352 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         dll_lru.c
+ *
+ * Description:  Contains an implementation of a fixed capacity LRU cache on a
+ *               doubly linked recency list with a hash index.
+ *
+ * */
+
+#include "dll_lru.h"
+#include "dll_hash.h"
+#include<stdint.h>
+#include<stdlib.h>
+
+
+/*
+ * Function:     dll_lru_unlink(dll_lru_ptr lru, dll_node_ptr node)
+ * -----------------------------------------------------------------------------
+ * Description:  Takes node out of the recency list. The node is not freed.
+ * ----------------------------------------------------------------------------
+ */
+static void dll_lru_unlink(dll_lru_ptr lru, dll_node_ptr node)
+{
+    if(node->prev_ptr!=NULL)
+         node->prev_ptr->next_ptr=node->next_ptr;
+    else
+         lru->head=node->next_ptr;
+
+    if(node->next_ptr!=NULL)
+         node->next_ptr->prev_ptr=node->prev_ptr;
+    else
+         lru->tail=node->prev_ptr;
+}
+
+/*
+ * Function:     dll_lru_link_front(dll_lru_ptr lru, dll_node_ptr node)
+ * -----------------------------------------------------------------------------
+ * Description:  Links node in as the most recently used entry.
+ * ----------------------------------------------------------------------------
+ */
+static void dll_lru_link_front(dll_lru_ptr lru, dll_node_ptr node)
+{
+    node->prev_ptr=NULL;
+    node->next_ptr=lru->head;
+
+    if(lru->head!=NULL)
+         lru->head->prev_ptr=node;
+    else
+         lru->tail=node;
+
+    lru->head=node;
+}
+
+/*
+ * Function:     dll_lru_move_front(dll_lru_ptr lru, dll_node_ptr node)
+ * -----------------------------------------------------------------------------
+ * Description:  Makes node the most recently used entry by relinking it.
+ * ----------------------------------------------------------------------------
+ */
+static void dll_lru_move_front(dll_lru_ptr lru, dll_node_ptr node)
+{
+    if(lru->head==node)
+         return;
+
+    dll_lru_unlink(lru, node);
+    dll_lru_link_front(lru, node);
+}
+
+
+/*
+ * Function:     dll_lru_init(dll_lru_ptr* lru, uint32_t capacity,
+ *                            dll_lru_evict_fn evict, void* context)
+ * -----------------------------------------------------------------------------
+ * Description:  Allocates an empty cache holding up to capacity entries.
+ *
+ * Usage:        Pass a pointer to the dll_lru_ptr that should point to the new
+ *               cache, its capacity, and the eviction callback with its
+ *               context; evict may be NULL.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_BAD_DATA: capacity is zero.
+ *
+ *               DLL_MALLOC_FAIL: A call to malloc fails.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_lru_init(dll_lru_ptr* lru, uint32_t capacity, dll_lru_evict_fn evict, void* context)
+{
+    //basic pointer check; error handling
+    if(lru==NULL)
+         return DLL_NULL_PTR;
+
+    if(capacity==0)
+         return DLL_BAD_DATA;
+
+    uint32_t index;
+    dll_lru_ptr cache=(dll_lru_ptr)malloc(sizeof(dll_lru));
+    if(cache==NULL)
+         return DLL_MALLOC_FAIL;
+
+    cache->nodes=(dll_node*)malloc((size_t)capacity*sizeof(dll_node));
+    cache->values=(uint32_t*)malloc((size_t)capacity*sizeof(uint32_t));
+
+    /*the index is sized for the capacity so that it never has to grow*/
+    if(cache->nodes==NULL||cache->values==NULL||dll_hash_init(&cache->index, capacity)!=DLL_SUCCESS)
+    {
+         free(cache->nodes);
+         free(cache->values);
+         free(cache);
+         return DLL_MALLOC_FAIL;
+    }
+
+    /*all the nodes start out on the free list*/
+    for(index=0; index+1<capacity; index++)
+         cache->nodes[index].next_ptr=&cache->nodes[index+1];
+    cache->nodes[capacity-1].next_ptr=NULL;
+    cache->free_list=&cache->nodes[0];
+
+    cache->head=NULL;
+    cache->tail=NULL;
+    cache->count=0;
+    cache->capacity=capacity;
+    cache->hits=0;
+    cache->misses=0;
+    cache->evictions=0;
+    cache->evict=evict;
+    cache->context=context;
+
+    *lru=cache;
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_lru_destroy(dll_lru_ptr lru)
+ * -----------------------------------------------------------------------------
+ * Description:  De-allocates the cache. The eviction callback is not called
+ *               for the entries still in it.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_lru_destroy(dll_lru_ptr lru)
+{
+    //basic pointer check; error handling
+    if(lru==NULL)
+         return DLL_NULL_PTR;
+
+    dll_hash_destroy(lru->index);
+    free(lru->values);
+    free(lru->nodes);
+    free(lru);
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_lru_get(dll_lru_ptr lru, uint32_t key, uint32_t* value)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the value of key in *value and makes it the most
+ *               recently used entry. Counts a hit or a miss.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_DATA_MISSING: key is not in the cache.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_lru_get(dll_lru_ptr lru, uint32_t key, uint32_t* value)
+{
+    //basic pointer check; error handling
+    if(lru==NULL||value==NULL)
+         return DLL_NULL_PTR;
+
+    dll_node_ptr node;
+
+    if(dll_hash_find(lru->index, key, &node)!=DLL_SUCCESS)
+    {
+         lru->misses++;
+         return DLL_DATA_MISSING;
+    }
+
+    lru->hits++;
+    dll_lru_move_front(lru, node);
+    *value=lru->values[node-lru->nodes];
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_lru_put(dll_lru_ptr lru, uint32_t key, uint32_t value)
+ * -----------------------------------------------------------------------------
+ * Description:  Sets the value of key and makes it the most recently used
+ *               entry. If key is new and the cache is full, the least
+ *               recently used entry is evicted first and its node reused.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_lru_put(dll_lru_ptr lru, uint32_t key, uint32_t value)
+{
+    //basic pointer check; error handling
+    if(lru==NULL)
+         return DLL_NULL_PTR;
+
+    dll_node_ptr node;
+
+    /*existing key- update in place*/
+    if(dll_hash_find(lru->index, key, &node)==DLL_SUCCESS)
+    {
+         lru->values[node-lru->nodes]=value;
+         dll_lru_move_front(lru, node);
+         return DLL_SUCCESS;
+    }
+
+    if(lru->free_list!=NULL)
+    {
+         node=lru->free_list;
+         lru->free_list=node->next_ptr;
+         lru->count++;
+    }
+    /*full- reuse the node of the least recently used entry*/
+    else
+    {
+         node=lru->tail;
+         dll_lru_unlink(lru, node);
+         dll_hash_remove(lru->index, node);
+         lru->evictions++;
+
+         if(lru->evict!=NULL)
+              lru->evict(node->data, lru->values[node-lru->nodes], lru->context);
+    }
+
+    node->data=key;
+    lru->values[node-lru->nodes]=value;
+
+    /*cannot fail: the index was sized for capacity entries*/
+    dll_hash_insert(lru->index, node);
+    dll_lru_link_front(lru, node);
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_lru_touch(dll_lru_ptr lru, uint32_t key)
+ * -----------------------------------------------------------------------------
+ * Description:  Makes key the most recently used entry without reading it.
+ *               Does not count a hit or a miss.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_DATA_MISSING: key is not in the cache.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_lru_touch(dll_lru_ptr lru, uint32_t key)
+{
+    //basic pointer check; error handling
+    if(lru==NULL)
+         return DLL_NULL_PTR;
+
+    dll_node_ptr node;
+
+    if(dll_hash_find(lru->index, key, &node)!=DLL_SUCCESS)
+         return DLL_DATA_MISSING;
+
+    dll_lru_move_front(lru, node);
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_lru_remove(dll_lru_ptr lru, uint32_t key)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes key from the cache without calling the eviction
+ *               callback.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_DATA_MISSING: key is not in the cache.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_lru_remove(dll_lru_ptr lru, uint32_t key)
+{
+    //basic pointer check; error handling
+    if(lru==NULL)
+         return DLL_NULL_PTR;
+
+    dll_node_ptr node;
+
+    if(dll_hash_find(lru->index, key, &node)!=DLL_SUCCESS)
+         return DLL_DATA_MISSING;
+
+    dll_lru_unlink(lru, node);
+    dll_hash_remove(lru->index, node);
+
+    /*give the node back to the free list*/
+    node->next_ptr=lru->free_list;
+    lru->free_list=node;
+    lru->count--;
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_lru_stats(dll_lru_ptr lru, uint64_t* hits, uint64_t* misses,
+ *                             uint64_t* evictions)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the number of hits and misses of dll_lru_get and the
+ *               number of evictions since init.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_lru_stats(dll_lru_ptr lru, uint64_t* hits, uint64_t* misses, uint64_t* evictions)
+{
+    //basic pointer check; error handling
+    if(lru==NULL||hits==NULL||misses==NULL||evictions==NULL)
+         return DLL_NULL_PTR;
+
+    *hits=lru->hits;
+    *misses=lru->misses;
+    *evictions=lru->evictions;
+
+    return DLL_SUCCESS;
+}
@@ -0,0 +1,181 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         dll_lru.h
+ *
+ * Description:  Contains the structures and function prototypes of a fixed
+ *               capacity LRU cache defined in dll_lru.c in the same directory.
+ *               The cache keeps its entries on a doubly linked recency list
+ *               and finds them through a dll_hash index, so a hit moves the
+ *               entry to the front by relinking its node in place.
+ *
+ * */
+
+#ifndef _DLL_LRU_H_
+#define _DLL_LRU_H_
+
+#include<stdint.h>
+#include "doubly_ll.h"
+
+
+/*
+ * Type:         dll_lru_evict_fn
+ * -----------------------------------------------------------------------------
+ * Description:  Called with the key and value of an entry that is evicted to
+ *               make room for a new one, and the context passed to
+ *               dll_lru_init. It must not call back into the cache.
+ * ----------------------------------------------------------------------------
+ */
+typedef void (*dll_lru_evict_fn)(uint32_t key, uint32_t value, void* context);
+
+
+/*
+ * Structure:    dll_lru
+ * -----------------------------------------------------------------------------
+ * Description:  An LRU cache of uint32_t keys and values. All 'capacity'
+ *               nodes are allocated by dll_lru_init: node i holds the key of
+ *               an entry in its data and values[i] holds its value. head is
+ *               the most and tail the least recently used entry; nodes not in
+ *               use are chained from free_list through next_ptr. The index
+ *               is sized for capacity entries, so it never grows, and no
+ *               operation allocates after init.
+ *
+ * Usage:        Use the dll_lru_* functions; do not access the members
+ *               directly. A cache is not thread safe.
+ * ----------------------------------------------------------------------------
+ */
+typedef struct dll_lru *dll_lru_ptr;
+
+typedef struct dll_lru
+{
+    dll_node *nodes;
+    uint32_t *values;
+    dll_hash_ptr index;
+    dll_node_ptr head;
+    dll_node_ptr tail;
+    dll_node_ptr free_list;
+    uint32_t count;
+    uint32_t capacity;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    dll_lru_evict_fn evict;
+    void *context;
+}dll_lru;
+
+
+/*
+ * Function:     dll_lru_init(dll_lru_ptr* lru, uint32_t capacity,
+ *                            dll_lru_evict_fn evict, void* context)
+ * -----------------------------------------------------------------------------
+ * Description:  Allocates an empty cache holding up to capacity entries.
+ *
+ * Usage:        Pass a pointer to the dll_lru_ptr that should point to the new
+ *               cache, its capacity, and the eviction callback with its
+ *               context; evict may be NULL.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_BAD_DATA: capacity is zero.
+ *
+ *               DLL_MALLOC_FAIL: A call to malloc fails.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_lru_init(dll_lru_ptr* lru, uint32_t capacity, dll_lru_evict_fn evict, void* context);
+
+/*
+ * Function:     dll_lru_destroy(dll_lru_ptr lru)
+ * -----------------------------------------------------------------------------
+ * Description:  De-allocates the cache. The eviction callback is not called
+ *               for the entries still in it.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_lru_destroy(dll_lru_ptr lru);
+
+/*
+ * Function:     dll_lru_get(dll_lru_ptr lru, uint32_t key, uint32_t* value)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the value of key in *value and makes it the most
+ *               recently used entry. Counts a hit or a miss.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_DATA_MISSING: key is not in the cache.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_lru_get(dll_lru_ptr lru, uint32_t key, uint32_t* value);
+
+/*
+ * Function:     dll_lru_put(dll_lru_ptr lru, uint32_t key, uint32_t value)
+ * -----------------------------------------------------------------------------
+ * Description:  Sets the value of key and makes it the most recently used
+ *               entry. If key is new and the cache is full, the least
+ *               recently used entry is evicted first and its node reused.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_lru_put(dll_lru_ptr lru, uint32_t key, uint32_t value);
+
+/*
+ * Function:     dll_lru_touch(dll_lru_ptr lru, uint32_t key)
+ * -----------------------------------------------------------------------------
+ * Description:  Makes key the most recently used entry without reading it.
+ *               Does not count a hit or a miss.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_DATA_MISSING: key is not in the cache.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_lru_touch(dll_lru_ptr lru, uint32_t key);
+
+/*
+ * Function:     dll_lru_remove(dll_lru_ptr lru, uint32_t key)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes key from the cache without calling the eviction
+ *               callback.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_DATA_MISSING: key is not in the cache.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_lru_remove(dll_lru_ptr lru, uint32_t key);
+
+/*
+ * Function:     dll_lru_stats(dll_lru_ptr lru, uint64_t* hits, uint64_t* misses,
+ *                             uint64_t* evictions)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the number of hits and misses of dll_lru_get and the
+ *               number of evictions since init.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_lru_stats(dll_lru_ptr lru, uint64_t* hits, uint64_t* misses, uint64_t* evictions);
+
+#endif
@@ -0,0 +1,345 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         dll_pool.c
+ *
+ * Description:  Contains an implementation of a chunked pool allocator with an
+ *               intrusive free list for doubly linked list nodes.
+ *
+ * */
+
+#include "dll_pool.h"
+#include<stdint.h>
+#include<stdlib.h>
+#include<stdatomic.h>
+#include<pthread.h>
+
+
+/*key of the per thread pool; the destructor drops the thread's reference
+ *when it exits*/
+static pthread_key_t dll_pool_key;
+static pthread_once_t dll_pool_key_once=PTHREAD_ONCE_INIT;
+static int dll_pool_key_ok;
+
+
+/*
+ * Function:     dll_pool_key_destructor(void* pool)
+ * -----------------------------------------------------------------------------
+ * Description:  Drops the reference of a thread that exits to its pool.
+ * ----------------------------------------------------------------------------
+ */
+static void dll_pool_key_destructor(void* pool)
+{
+    dll_pool_destroy((dll_pool_ptr)pool);
+}
+
+/*
+ * Function:     dll_pool_make_key(void)
+ * -----------------------------------------------------------------------------
+ * Description:  Creates the key of the per thread pool; run once.
+ * ----------------------------------------------------------------------------
+ */
+static void dll_pool_make_key(void)
+{
+    dll_pool_key_ok=(pthread_key_create(&dll_pool_key, dll_pool_key_destructor)==0);
+}
+
+/*
+ * Function:     dll_pool_grow(dll_pool_ptr pool, uint32_t count)
+ * -----------------------------------------------------------------------------
+ * Description:  Allocates a chunk of count nodes and puts them on the free
+ *               list in address order.
+ * ----------------------------------------------------------------------------
+ */
+static dll_code dll_pool_grow(dll_pool_ptr pool, uint32_t count)
+{
+    dll_pool_chunk *chunk;
+    uint32_t index;
+
+    chunk=(dll_pool_chunk*)malloc(sizeof(dll_pool_chunk)+(size_t)count*sizeof(dll_node));
+    if(chunk==NULL)
+         return DLL_MALLOC_FAIL;
+
+    chunk->capacity=count;
+    chunk->next=pool->chunks;
+    pool->chunks=chunk;
+
+    /*thread the new nodes in front of whatever is still free*/
+    for(index=0; index+1<count; index++)
+         chunk->nodes[index].next_ptr=&chunk->nodes[index+1];
+    chunk->nodes[count-1].next_ptr=pool->free_list;
+    pool->free_list=&chunk->nodes[0];
+
+    pool->free_count+=count;
+    pool->total_count+=count;
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_pool_init(dll_pool_ptr* pool, uint32_t chunk_nodes)
+ * -----------------------------------------------------------------------------
+ * Description:  Allocates an empty pool on the heap that grows by chunk_nodes
+ *               nodes at a time. The caller holds the one reference to it.
+ *
+ * Usage:        Pass a pointer to the dll_pool_ptr that should point to the new
+ *               pool and the chunk size; 0 selects DLL_POOL_DEFAULT_CHUNK.
+ *               Drop the reference with dll_pool_destroy.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_MALLOC_FAIL: The call to malloc fails.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_pool_init(dll_pool_ptr* pool, uint32_t chunk_nodes)
+{
+    //basic pointer check; error handling
+    if(pool==NULL)
+         return DLL_NULL_PTR;
+
+    *pool=(dll_pool_ptr)malloc(sizeof(dll_pool));
+    if(*pool==NULL)
+         return DLL_MALLOC_FAIL;
+
+    (*pool)->free_list=NULL;
+    (*pool)->chunks=NULL;
+    (*pool)->chunk_nodes=(chunk_nodes!=0)? chunk_nodes: DLL_POOL_DEFAULT_CHUNK;
+    (*pool)->free_count=0;
+    (*pool)->total_count=0;
+    atomic_init(&(*pool)->refs, 1);
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_pool_destroy(dll_pool_ptr pool)
+ * -----------------------------------------------------------------------------
+ * Description:  Drops one reference to the pool. The last one frees all the
+ *               chunks of the pool, one free per chunk, and the pool itself.
+ *
+ * Usage:        Call it once for the reference from dll_pool_init. The lists
+ *               that use the pool hold their own references and drop them in
+ *               dll_list_destroy, so the pool may be destroyed before them.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_pool_destroy(dll_pool_ptr pool)
+{
+    //basic pointer check; error handling
+    if(pool==NULL)
+         return DLL_NULL_PTR;
+
+    dll_pool_chunk *chunk=pool->chunks, *next;
+
+    /*lists still take nodes from it*/
+    if(atomic_fetch_sub_explicit(&pool->refs, 1, memory_order_acq_rel)!=1)
+         return DLL_SUCCESS;
+
+    /*one free per chunk, not per node*/
+    while(chunk!=NULL)
+    {
+         next=chunk->next;
+         free(chunk);
+         chunk=next;
+    }
+
+    free(pool);
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_pool_retain(dll_pool_ptr pool)
+ * -----------------------------------------------------------------------------
+ * Description:  Takes another reference to the pool, to be dropped with
+ *               dll_pool_destroy. dll_list_init_pool does this for the list.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_pool_retain(dll_pool_ptr pool)
+{
+    //basic pointer check; error handling
+    if(pool==NULL)
+         return DLL_NULL_PTR;
+
+    atomic_fetch_add_explicit(&pool->refs, 1, memory_order_relaxed);
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_pool_reserve(dll_pool_ptr pool, uint32_t count)
+ * -----------------------------------------------------------------------------
+ * Description:  Makes sure at least count nodes are free, allocating the
+ *               missing ones as a single chunk.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_MALLOC_FAIL: The chunk can not be allocated.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_pool_reserve(dll_pool_ptr pool, uint32_t count)
+{
+    //basic pointer check; error handling
+    if(pool==NULL)
+         return DLL_NULL_PTR;
+
+    if(pool->free_count>=count)
+         return DLL_SUCCESS;
+
+    return dll_pool_grow(pool, count-pool->free_count);
+}
+
+
+/*
+ * Function:     dll_pool_alloc(dll_pool_ptr pool, dll_node_ptr* node)
+ * -----------------------------------------------------------------------------
+ * Description:  Takes a node off the free list, adding a chunk first if the
+ *               free list is empty. The node's members are not initialised.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_MALLOC_FAIL: The pool is empty and a chunk can not be
+ *               allocated.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_pool_alloc(dll_pool_ptr pool, dll_node_ptr* node)
+{
+    //basic pointer check; error handling
+    if(pool==NULL||node==NULL)
+         return DLL_NULL_PTR;
+
+    /*refill with a whole chunk when the free list runs dry*/
+    if(pool->free_list==NULL)
+    {
+         dll_code rc=dll_pool_grow(pool, pool->chunk_nodes);
+         if(rc!=DLL_SUCCESS)
+              return rc;
+    }
+
+    *node=pool->free_list;
+    pool->free_list=(*node)->next_ptr;
+    pool->free_count--;
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_pool_free(dll_pool_ptr pool, dll_node_ptr node)
+ * -----------------------------------------------------------------------------
+ * Description:  Gives a node allocated from the pool back to it.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_pool_free(dll_pool_ptr pool, dll_node_ptr node)
+{
+    //basic pointer check; error handling
+    if(pool==NULL||node==NULL)
+         return DLL_NULL_PTR;
+
+    node->next_ptr=pool->free_list;
+    pool->free_list=node;
+    pool->free_count++;
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_pool_free_chain(dll_pool_ptr pool, dll_node_ptr first,
+ *                                   dll_node_ptr last, uint32_t count)
+ * -----------------------------------------------------------------------------
+ * Description:  Gives back count nodes linked from first to last through their
+ *               next_ptr in O(1), by putting the whole chain on the front of
+ *               the free list. This is how a list that uses the pool is
+ *               destroyed without visiting its nodes.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_pool_free_chain(dll_pool_ptr pool, dll_node_ptr first, dll_node_ptr last, uint32_t count)
+{
+    //basic pointer check; error handling
+    if(pool==NULL||first==NULL||last==NULL)
+         return DLL_NULL_PTR;
+
+    /*the chain is already linked through next_ptr; hook it onto the free list*/
+    last->next_ptr=pool->free_list;
+    pool->free_list=first;
+    pool->free_count+=count;
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_pool_thread_local(dll_pool_ptr* pool)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the calling thread's own pool in *pool, creating it
+ *               on first use. The thread's reference is dropped when it
+ *               exits; lists still using the pool keep it alive until they
+ *               are destroyed, which may then happen on another thread.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_MALLOC_FAIL: The pool can not be created.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_pool_thread_local(dll_pool_ptr* pool)
+{
+    //basic pointer check; error handling
+    if(pool==NULL)
+         return DLL_NULL_PTR;
+
+    if(pthread_once(&dll_pool_key_once, dll_pool_make_key)!=0||!dll_pool_key_ok)
+         return DLL_MALLOC_FAIL;
+
+    *pool=(dll_pool_ptr)pthread_getspecific(dll_pool_key);
+    if(*pool!=NULL)
+         return DLL_SUCCESS;
+
+    /*first use on this thread*/
+    dll_code rc=dll_pool_init(pool, 0);
+    if(rc!=DLL_SUCCESS)
+         return rc;
+
+    if(pthread_setspecific(dll_pool_key, *pool)!=0)
+    {
+         dll_pool_destroy(*pool);
+         return DLL_MALLOC_FAIL;
+    }
+
+    return DLL_SUCCESS;
+}
@@ -0,0 +1,202 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         dll_pool.h
+ *
+ * Description:  Contains the structures and function prototypes of a pool
+ *               allocator for doubly linked list nodes defined in dll_pool.c
+ *               in the same directory. Nodes are carved out of large chunks
+ *               and recycled through a free list, so a list that uses a pool
+ *               does not call malloc/free per node once the pool has grown to
+ *               its working size.
+ *
+ * */
+
+#ifndef _DLL_POOL_H_
+#define _DLL_POOL_H_
+
+#include<stdint.h>
+#include<stdatomic.h>
+#include "doubly_ll.h"
+
+/*nodes per chunk when 0 is passed to dll_pool_init*/
+#define DLL_POOL_DEFAULT_CHUNK 1024
+
+
+/*
+ * Structure:    dll_pool_chunk
+ * -----------------------------------------------------------------------------
+ * Description:  One block of nodes allocated with a single malloc. The chunks
+ *               of a pool are chained so that they can be freed together.
+ * ----------------------------------------------------------------------------
+ */
+typedef struct dll_pool_chunk
+{
+    struct dll_pool_chunk *next;
+    uint32_t capacity;
+    dll_node nodes[];
+}dll_pool_chunk;
+
+
+/*
+ * Structure:    dll_pool
+ * -----------------------------------------------------------------------------
+ * Description:  A node pool. free_list holds the nodes that are not in use,
+ *               linked through their next_ptr, so taking and giving back a
+ *               node is a pointer swap. Nodes of a new chunk are put on the
+ *               free list in address order, so nodes allocated one after the
+ *               other are neighbours in memory.
+ *               refs counts the creator of the pool plus every list that
+ *               takes its nodes from it; the chunks are freed when it drops
+ *               to zero, so a list never outlives its nodes.
+ *
+ * Usage:        A pool is not thread safe. Use one pool per thread, e.g. the
+ *               one returned by dll_pool_thread_local. Use the dll_pool_*
+ *               functions; do not access the members directly.
+ * ----------------------------------------------------------------------------
+ */
+typedef struct dll_pool
+{
+    dll_node_ptr free_list;
+    dll_pool_chunk *chunks;
+    uint32_t chunk_nodes;
+    uint32_t free_count;
+    uint32_t total_count;
+    _Atomic uint32_t refs;
+}dll_pool;
+
+
+/*
+ * Function:     dll_pool_init(dll_pool_ptr* pool, uint32_t chunk_nodes)
+ * -----------------------------------------------------------------------------
+ * Description:  Allocates an empty pool on the heap that grows by chunk_nodes
+ *               nodes at a time. The caller holds the one reference to it.
+ *
+ * Usage:        Pass a pointer to the dll_pool_ptr that should point to the new
+ *               pool and the chunk size; 0 selects DLL_POOL_DEFAULT_CHUNK.
+ *               Drop the reference with dll_pool_destroy.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_MALLOC_FAIL: The call to malloc fails.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_pool_init(dll_pool_ptr* pool, uint32_t chunk_nodes);
+
+/*
+ * Function:     dll_pool_destroy(dll_pool_ptr pool)
+ * -----------------------------------------------------------------------------
+ * Description:  Drops one reference to the pool. The last one frees all the
+ *               chunks of the pool, one free per chunk, and the pool itself.
+ *
+ * Usage:        Call it once for the reference from dll_pool_init. The lists
+ *               that use the pool hold their own references and drop them in
+ *               dll_list_destroy, so the pool may be destroyed before them.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_pool_destroy(dll_pool_ptr pool);
+
+/*
+ * Function:     dll_pool_retain(dll_pool_ptr pool)
+ * -----------------------------------------------------------------------------
+ * Description:  Takes another reference to the pool, to be dropped with
+ *               dll_pool_destroy. dll_list_init_pool does this for the list.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_pool_retain(dll_pool_ptr pool);
+
+/*
+ * Function:     dll_pool_reserve(dll_pool_ptr pool, uint32_t count)
+ * -----------------------------------------------------------------------------
+ * Description:  Makes sure at least count nodes are free, allocating the
+ *               missing ones as a single chunk.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_MALLOC_FAIL: The chunk can not be allocated.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_pool_reserve(dll_pool_ptr pool, uint32_t count);
+
+/*
+ * Function:     dll_pool_alloc(dll_pool_ptr pool, dll_node_ptr* node)
+ * -----------------------------------------------------------------------------
+ * Description:  Takes a node off the free list, adding a chunk first if the
+ *               free list is empty. The node's members are not initialised.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_MALLOC_FAIL: The pool is empty and a chunk can not be
+ *               allocated.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_pool_alloc(dll_pool_ptr pool, dll_node_ptr* node);
+
+/*
+ * Function:     dll_pool_free(dll_pool_ptr pool, dll_node_ptr node)
+ * -----------------------------------------------------------------------------
+ * Description:  Gives a node allocated from the pool back to it.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_pool_free(dll_pool_ptr pool, dll_node_ptr node);
+
+/*
+ * Function:     dll_pool_free_chain(dll_pool_ptr pool, dll_node_ptr first,
+ *                                   dll_node_ptr last, uint32_t count)
+ * -----------------------------------------------------------------------------
+ * Description:  Gives back count nodes linked from first to last through their
+ *               next_ptr in O(1), by putting the whole chain on the front of
+ *               the free list. This is how a list that uses the pool is
+ *               destroyed without visiting its nodes.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_pool_free_chain(dll_pool_ptr pool, dll_node_ptr first, dll_node_ptr last, uint32_t count);
+
+/*
+ * Function:     dll_pool_thread_local(dll_pool_ptr* pool)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the calling thread's own pool in *pool, creating it
+ *               on first use. The thread's reference is dropped when it
+ *               exits; lists still using the pool keep it alive until they
+ *               are destroyed, which may then happen on another thread.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_MALLOC_FAIL: The pool can not be created.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_pool_thread_local(dll_pool_ptr* pool);
+
+#endif
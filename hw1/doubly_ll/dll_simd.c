@@ -0,0 +1,454 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         dll_simd.c
+ *
+ * Description:  Contains scalar, SSE2 and AVX2 implementations of the value
+ *               searches of dll_simd.h and the run time choice between them.
+ *               The vector versions are compiled with target attributes, so
+ *               the file builds without -mavx2 and still runs on CPUs
+ *               without AVX2.
+ *
+ * */
+
+#include "dll_simd.h"
+#include<stdint.h>
+#include<stddef.h>
+#include<pthread.h>
+
+#if (defined(__x86_64__)||defined(__i386__))&&defined(__GNUC__)
+#define DLL_SIMD_X86
+#include<immintrin.h>
+#endif
+
+
+/*one implementation of the three searches; all return counts, not codes*/
+typedef struct dll_simd_ops
+{
+    uint32_t (*find)(const uint32_t*, uint32_t, uint32_t);
+    uint32_t (*count)(const uint32_t*, uint32_t, uint32_t);
+    uint32_t (*find_all)(const uint32_t*, uint32_t, uint32_t, uint32_t*, uint32_t);
+    dll_simd_level level;
+}dll_simd_ops;
+
+static dll_simd_ops dll_simd_impl;
+static pthread_once_t dll_simd_once=PTHREAD_ONCE_INIT;
+
+
+/*
+ * Function:     dll_simd_find_scalar(const uint32_t* values, uint32_t count, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the index of the first value equal to data, or count.
+ * ----------------------------------------------------------------------------
+ */
+static uint32_t dll_simd_find_scalar(const uint32_t* values, uint32_t count, uint32_t data)
+{
+    uint32_t index;
+
+    for(index=0; index<count; index++)
+    {
+         if(values[index]==data)
+              break;
+    }
+
+    return index;
+}
+
+/*
+ * Function:     dll_simd_count_scalar(const uint32_t* values, uint32_t count, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the number of values equal to data.
+ * ----------------------------------------------------------------------------
+ */
+static uint32_t dll_simd_count_scalar(const uint32_t* values, uint32_t count, uint32_t data)
+{
+    uint32_t index, matches=0;
+
+    for(index=0; index<count; index++)
+         matches+=(values[index]==data);
+
+    return matches;
+}
+
+/*
+ * Function:     dll_simd_find_all_scalar(const uint32_t* values, uint32_t count,
+ *                                        uint32_t data, uint32_t* indices, uint32_t max)
+ * -----------------------------------------------------------------------------
+ * Description:  Stores up to max indices of values equal to data and returns
+ *               the number of matches.
+ * ----------------------------------------------------------------------------
+ */
+static uint32_t dll_simd_find_all_scalar(const uint32_t* values, uint32_t count, uint32_t data,
+                                         uint32_t* indices, uint32_t max)
+{
+    uint32_t index, matches=0;
+
+    for(index=0; index<count; index++)
+    {
+         if(values[index]==data)
+         {
+              if(matches<max)
+                   indices[matches]=index;
+              matches++;
+         }
+    }
+
+    return matches;
+}
+
+
+#ifdef DLL_SIMD_X86
+
+/*
+ * Function:     dll_simd_find_sse2(const uint32_t* values, uint32_t count, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  SSE2 version of dll_simd_find_scalar. The main loop compares
+ *               16 values per iteration and only looks for the exact lane
+ *               once one of the four compares hits.
+ * ----------------------------------------------------------------------------
+ */
+__attribute__((target("sse2")))
+static uint32_t dll_simd_find_sse2(const uint32_t* values, uint32_t count, uint32_t data)
+{
+    const __m128i key=_mm_set1_epi32((int32_t)data);
+    uint32_t index=0;
+    int mask;
+
+    for(; index+16<=count; index+=16)
+    {
+         __m128i c0=_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(values+index)), key);
+         __m128i c1=_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(values+index+4)), key);
+         __m128i c2=_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(values+index+8)), key);
+         __m128i c3=_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(values+index+12)), key);
+         __m128i any=_mm_or_si128(_mm_or_si128(c0, c1), _mm_or_si128(c2, c3));
+
+         if(_mm_movemask_epi8(any)!=0)
+              break;
+    }
+
+    for(; index+4<=count; index+=4)
+    {
+         mask=_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(values+index)), key)));
+         if(mask!=0)
+              return index+(uint32_t)__builtin_ctz((unsigned)mask);
+    }
+
+    return index+dll_simd_find_scalar(values+index, count-index, data);
+}
+
+/*
+ * Function:     dll_simd_count_sse2(const uint32_t* values, uint32_t count, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  SSE2 version of dll_simd_count_scalar. A matching lane
+ *               compares to -1, so subtracting the compare result counts it.
+ * ----------------------------------------------------------------------------
+ */
+__attribute__((target("sse2")))
+static uint32_t dll_simd_count_sse2(const uint32_t* values, uint32_t count, uint32_t data)
+{
+    const __m128i key=_mm_set1_epi32((int32_t)data);
+    __m128i acc0=_mm_setzero_si128(), acc1=_mm_setzero_si128();
+    uint32_t index=0, lanes[4];
+
+    for(; index+8<=count; index+=8)
+    {
+         acc0=_mm_sub_epi32(acc0, _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(values+index)), key));
+         acc1=_mm_sub_epi32(acc1, _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(values+index+4)), key));
+    }
+
+    _mm_storeu_si128((__m128i*)lanes, _mm_add_epi32(acc0, acc1));
+
+    return lanes[0]+lanes[1]+lanes[2]+lanes[3]+dll_simd_count_scalar(values+index, count-index, data);
+}
+
+/*
+ * Function:     dll_simd_find_all_sse2(const uint32_t* values, uint32_t count,
+ *                                      uint32_t data, uint32_t* indices, uint32_t max)
+ * -----------------------------------------------------------------------------
+ * Description:  SSE2 version of dll_simd_find_all_scalar.
+ * ----------------------------------------------------------------------------
+ */
+__attribute__((target("sse2")))
+static uint32_t dll_simd_find_all_sse2(const uint32_t* values, uint32_t count, uint32_t data,
+                                       uint32_t* indices, uint32_t max)
+{
+    const __m128i key=_mm_set1_epi32((int32_t)data);
+    uint32_t index=0, matches=0, bit, tail;
+    unsigned mask;
+
+    for(; index+4<=count; index+=4)
+    {
+         mask=(unsigned)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(values+index)), key)));
+
+         /*one bit per matching lane, lowest index first*/
+         while(mask!=0)
+         {
+              bit=(uint32_t)__builtin_ctz(mask);
+              if(matches<max)
+                   indices[matches]=index+bit;
+              matches++;
+              mask&=mask-1;
+         }
+    }
+
+    for(tail=index; tail<count; tail++)
+    {
+         if(values[tail]==data)
+         {
+              if(matches<max)
+                   indices[matches]=tail;
+              matches++;
+         }
+    }
+
+    return matches;
+}
+
+/*
+ * Function:     dll_simd_find_avx2(const uint32_t* values, uint32_t count, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  AVX2 version of dll_simd_find_scalar; 32 values per iteration
+ *               of the main loop.
+ * ----------------------------------------------------------------------------
+ */
+__attribute__((target("avx2")))
+static uint32_t dll_simd_find_avx2(const uint32_t* values, uint32_t count, uint32_t data)
+{
+    const __m256i key=_mm256_set1_epi32((int32_t)data);
+    uint32_t index=0;
+    int mask;
+
+    for(; index+32<=count; index+=32)
+    {
+         __m256i c0=_mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(values+index)), key);
+         __m256i c1=_mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(values+index+8)), key);
+         __m256i c2=_mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(values+index+16)), key);
+         __m256i c3=_mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(values+index+24)), key);
+         __m256i any=_mm256_or_si256(_mm256_or_si256(c0, c1), _mm256_or_si256(c2, c3));
+
+         if(!_mm256_testz_si256(any, any))
+              break;
+    }
+
+    for(; index+8<=count; index+=8)
+    {
+         mask=_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(values+index)), key)));
+         if(mask!=0)
+              return index+(uint32_t)__builtin_ctz((unsigned)mask);
+    }
+
+    return index+dll_simd_find_scalar(values+index, count-index, data);
+}
+
+/*
+ * Function:     dll_simd_count_avx2(const uint32_t* values, uint32_t count, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  AVX2 version of dll_simd_count_scalar.
+ * ----------------------------------------------------------------------------
+ */
+__attribute__((target("avx2")))
+static uint32_t dll_simd_count_avx2(const uint32_t* values, uint32_t count, uint32_t data)
+{
+    const __m256i key=_mm256_set1_epi32((int32_t)data);
+    __m256i acc0=_mm256_setzero_si256(), acc1=_mm256_setzero_si256();
+    uint32_t index=0, lanes[8], lane, matches=0;
+
+    for(; index+16<=count; index+=16)
+    {
+         acc0=_mm256_sub_epi32(acc0, _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(values+index)), key));
+         acc1=_mm256_sub_epi32(acc1, _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(values+index+8)), key));
+    }
+
+    _mm256_storeu_si256((__m256i*)lanes, _mm256_add_epi32(acc0, acc1));
+    for(lane=0; lane<8; lane++)
+         matches+=lanes[lane];
+
+    return matches+dll_simd_count_scalar(values+index, count-index, data);
+}
+
+/*
+ * Function:     dll_simd_find_all_avx2(const uint32_t* values, uint32_t count,
+ *                                      uint32_t data, uint32_t* indices, uint32_t max)
+ * -----------------------------------------------------------------------------
+ * Description:  AVX2 version of dll_simd_find_all_scalar.
+ * ----------------------------------------------------------------------------
+ */
+__attribute__((target("avx2")))
+static uint32_t dll_simd_find_all_avx2(const uint32_t* values, uint32_t count, uint32_t data,
+                                       uint32_t* indices, uint32_t max)
+{
+    const __m256i key=_mm256_set1_epi32((int32_t)data);
+    uint32_t index=0, matches=0, bit, tail;
+    unsigned mask;
+
+    for(; index+8<=count; index+=8)
+    {
+         mask=(unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(values+index)), key)));
+
+         while(mask!=0)
+         {
+              bit=(uint32_t)__builtin_ctz(mask);
+              if(matches<max)
+                   indices[matches]=index+bit;
+              matches++;
+              mask&=mask-1;
+         }
+    }
+
+    for(tail=index; tail<count; tail++)
+    {
+         if(values[tail]==data)
+         {
+              if(matches<max)
+                   indices[matches]=tail;
+              matches++;
+         }
+    }
+
+    return matches;
+}
+
+#endif
+
+
+/*
+ * Function:     dll_simd_select(void)
+ * -----------------------------------------------------------------------------
+ * Description:  Picks the widest implementation the CPU supports; run once.
+ * ----------------------------------------------------------------------------
+ */
+static void dll_simd_select(void)
+{
+    dll_simd_impl.find=dll_simd_find_scalar;
+    dll_simd_impl.count=dll_simd_count_scalar;
+    dll_simd_impl.find_all=dll_simd_find_all_scalar;
+    dll_simd_impl.level=DLL_SIMD_SCALAR;
+
+#ifdef DLL_SIMD_X86
+    __builtin_cpu_init();
+
+    if(__builtin_cpu_supports("avx2"))
+    {
+         dll_simd_impl.find=dll_simd_find_avx2;
+         dll_simd_impl.count=dll_simd_count_avx2;
+         dll_simd_impl.find_all=dll_simd_find_all_avx2;
+         dll_simd_impl.level=DLL_SIMD_AVX2;
+    }
+    else if(__builtin_cpu_supports("sse2"))
+    {
+         dll_simd_impl.find=dll_simd_find_sse2;
+         dll_simd_impl.count=dll_simd_count_sse2;
+         dll_simd_impl.find_all=dll_simd_find_all_sse2;
+         dll_simd_impl.level=DLL_SIMD_SSE2;
+    }
+#endif
+}
+
+
+/*
+ * Function:     dll_simd_active(void)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the code path the dll_simd_* functions use on this
+ *               CPU. The choice is made once, on the first call to any of
+ *               them.
+ * ----------------------------------------------------------------------------
+ */
+dll_simd_level dll_simd_active(void)
+{
+    pthread_once(&dll_simd_once, dll_simd_select);
+
+    return dll_simd_impl.level;
+}
+
+
+/*
+ * Function:     dll_simd_find(const uint32_t* values, uint32_t count,
+ *                             uint32_t data, uint32_t* index)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the index of the first of values[0..count-1] equal to
+ *               data in *index.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_DATA_MISSING: No value is equal to data.
+ *
+ *               DLL_SUCCESS: The function completes execution
+ *               successfully- the data is found.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_simd_find(const uint32_t* values, uint32_t count, uint32_t data, uint32_t* index)
+{
+    //basic pointer check; error handling
+    if((values==NULL&&count!=0)||index==NULL)
+         return DLL_NULL_PTR;
+
+    pthread_once(&dll_simd_once, dll_simd_select);
+
+    uint32_t found=dll_simd_impl.find(values, count, data);
+    if(found==count)
+         return DLL_DATA_MISSING;
+
+    *index=found;
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_simd_count(const uint32_t* values, uint32_t count,
+ *                              uint32_t data, uint32_t* matches)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the number of values[0..count-1] equal to data in
+ *               *matches.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_simd_count(const uint32_t* values, uint32_t count, uint32_t data, uint32_t* matches)
+{
+    //basic pointer check; error handling
+    if((values==NULL&&count!=0)||matches==NULL)
+         return DLL_NULL_PTR;
+
+    pthread_once(&dll_simd_once, dll_simd_select);
+
+    *matches=dll_simd_impl.count(values, count, data);
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_simd_find_all(const uint32_t* values, uint32_t count, uint32_t data,
+ *                                 uint32_t* indices, uint32_t max, uint32_t* matches)
+ * -----------------------------------------------------------------------------
+ * Description:  Stores the indices of the values[0..count-1] equal to data in
+ *               ascending order in indices[], at most max of them, and returns
+ *               the total number of matches in *matches, which may be larger
+ *               than max.
+ *
+ * Usage:        indices may be NULL if max is zero.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_simd_find_all(const uint32_t* values, uint32_t count, uint32_t data,
+                           uint32_t* indices, uint32_t max, uint32_t* matches)
+{
+    //basic pointer check; error handling
+    if((values==NULL&&count!=0)||(indices==NULL&&max!=0)||matches==NULL)
+         return DLL_NULL_PTR;
+
+    pthread_once(&dll_simd_once, dll_simd_select);
+
+    *matches=dll_simd_impl.find_all(values, count, data, indices, max);
+
+    return DLL_SUCCESS;
+}
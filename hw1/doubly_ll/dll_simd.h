@@ -0,0 +1,88 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         dll_simd.h
+ *
+ * Description:  Contains the function prototypes of the vectorised value
+ *               searches defined in dll_simd.c in the same directory. They
+ *               work on a plain array of uint32_t, such as the values of a
+ *               dll_unrolled node, and compare 4 (SSE2) or 8 (AVX2) values
+ *               per instruction. The instruction set is picked at run time
+ *               from what the CPU supports; other targets use a scalar loop.
+ *
+ * */
+
+#ifndef _DLL_SIMD_H_
+#define _DLL_SIMD_H_
+
+#include<stdint.h>
+#include "doubly_ll.h"
+
+/*the code paths dll_simd_active can report*/
+typedef enum {DLL_SIMD_SCALAR, DLL_SIMD_SSE2, DLL_SIMD_AVX2} dll_simd_level;
+
+
+/*
+ * Function:     dll_simd_active(void)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the code path the dll_simd_* functions use on this
+ *               CPU. The choice is made once, on the first call to any of
+ *               them.
+ * ----------------------------------------------------------------------------
+ */
+dll_simd_level dll_simd_active(void);
+
+/*
+ * Function:     dll_simd_find(const uint32_t* values, uint32_t count,
+ *                             uint32_t data, uint32_t* index)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the index of the first of values[0..count-1] equal to
+ *               data in *index.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_DATA_MISSING: No value is equal to data.
+ *
+ *               DLL_SUCCESS: The function completes execution
+ *               successfully- the data is found.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_simd_find(const uint32_t* values, uint32_t count, uint32_t data, uint32_t* index);
+
+/*
+ * Function:     dll_simd_count(const uint32_t* values, uint32_t count,
+ *                              uint32_t data, uint32_t* matches)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the number of values[0..count-1] equal to data in
+ *               *matches.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_simd_count(const uint32_t* values, uint32_t count, uint32_t data, uint32_t* matches);
+
+/*
+ * Function:     dll_simd_find_all(const uint32_t* values, uint32_t count, uint32_t data,
+ *                                 uint32_t* indices, uint32_t max, uint32_t* matches)
+ * -----------------------------------------------------------------------------
+ * Description:  Stores the indices of the values[0..count-1] equal to data in
+ *               ascending order in indices[], at most max of them, and returns
+ *               the total number of matches in *matches, which may be larger
+ *               than max.
+ *
+ * Usage:        indices may be NULL if max is zero.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_simd_find_all(const uint32_t* values, uint32_t count, uint32_t data,
+                           uint32_t* indices, uint32_t max, uint32_t* matches);
+
+#endif
@@ -0,0 +1,501 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         dll_unrolled.c
+ *
+ * Description:  Contains an implementation of an unrolled doubly linked list
+ *               that keeps an array of values in every node.
+ *
+ * */
+
+#include "dll_unrolled.h"
+#include "dll_simd.h"
+#include<stdint.h>
+#include<stdlib.h>
+#include<string.h>
+
+
+/*
+ * Function:     dll_unrolled_locate(dll_unrolled_ptr list, uint32_t position, uint32_t* offset)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the node holding position and the index of the value
+ *               inside it in *offset, walking from whichever end of the list
+ *               is closer. position==count returns the last node with *offset
+ *               equal to its fill (one past its last value), or NULL for an
+ *               empty list.
+ * ----------------------------------------------------------------------------
+ */
+static dll_unrolled_node_ptr dll_unrolled_locate(dll_unrolled_ptr list, uint32_t position, uint32_t* offset)
+{
+    dll_unrolled_node_ptr tmp;
+    uint32_t start;
+
+    if(position<=list->count/2)
+    {
+         /*skip whole nodes from the front*/
+         tmp=list->head;
+         while(tmp!=NULL&&position>=tmp->fill&&tmp->next_ptr!=NULL)
+         {
+              position-=tmp->fill;
+              tmp=tmp->next_ptr;
+         }
+         *offset=position;
+    }
+    else
+    {
+         /*skip whole nodes from the back; start is the position of tmp's first value*/
+         tmp=list->tail;
+         start=list->count-tmp->fill;
+         while(position<start)
+         {
+              tmp=tmp->prev_ptr;
+              start-=tmp->fill;
+         }
+         *offset=position-start;
+    }
+
+    return tmp;
+}
+
+/*
+ * Function:     dll_unrolled_new_node(dll_unrolled_ptr list, dll_unrolled_node_ptr prev)
+ * -----------------------------------------------------------------------------
+ * Description:  Allocates an empty node and links it in after prev; a NULL
+ *               prev makes it the first node. Returns NULL if malloc fails.
+ * ----------------------------------------------------------------------------
+ */
+static dll_unrolled_node_ptr dll_unrolled_new_node(dll_unrolled_ptr list, dll_unrolled_node_ptr prev)
+{
+    dll_unrolled_node_ptr node=(dll_unrolled_node_ptr)aligned_alloc(DLL_UNROLLED_NODE_ALIGN, sizeof(dll_unrolled_node));
+
+    if(node==NULL)
+         return NULL;
+
+    node->fill=0;
+    node->prev_ptr=prev;
+    node->next_ptr=(prev!=NULL)? prev->next_ptr: list->head;
+
+    if(prev!=NULL)
+         prev->next_ptr=node;
+    else
+         list->head=node;
+
+    if(node->next_ptr!=NULL)
+         node->next_ptr->prev_ptr=node;
+    else
+         list->tail=node;
+
+    list->nodes++;
+
+    return node;
+}
+
+/*
+ * Function:     dll_unrolled_free_node(dll_unrolled_ptr list, dll_unrolled_node_ptr node)
+ * -----------------------------------------------------------------------------
+ * Description:  Unlinks node from the list and frees it. The values of the
+ *               node are not counted here; the caller updates list->count.
+ * ----------------------------------------------------------------------------
+ */
+static void dll_unrolled_free_node(dll_unrolled_ptr list, dll_unrolled_node_ptr node)
+{
+    if(node->prev_ptr!=NULL)
+         node->prev_ptr->next_ptr=node->next_ptr;
+    else
+         list->head=node->next_ptr;
+
+    if(node->next_ptr!=NULL)
+         node->next_ptr->prev_ptr=node->prev_ptr;
+    else
+         list->tail=node->prev_ptr;
+
+    list->nodes--;
+
+    free(node);
+}
+
+
+/*
+ * Function:     dll_unrolled_init(dll_unrolled_ptr* list)
+ * -----------------------------------------------------------------------------
+ * Description:  Allocates an empty unrolled list handle on the heap.
+ *
+ * Usage:        Pass a pointer to the dll_unrolled_ptr that should point to the
+ *               new list.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_MALLOC_FAIL: The call to malloc fails.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_unrolled_init(dll_unrolled_ptr* list)
+{
+    //basic pointer check; error handling
+    if(list==NULL)
+         return DLL_NULL_PTR;
+
+    *list=(dll_unrolled_ptr)malloc(sizeof(dll_unrolled));
+    if(*list==NULL)
+         return DLL_MALLOC_FAIL;
+
+    /*an empty list has no nodes*/
+    (*list)->head=NULL;
+    (*list)->tail=NULL;
+    (*list)->count=0;
+    (*list)->nodes=0;
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_unrolled_destroy(dll_unrolled_ptr list)
+ * -----------------------------------------------------------------------------
+ * Description:  De-allocates all the nodes of the list and the list handle.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_unrolled_destroy(dll_unrolled_ptr list)
+{
+    //basic pointer check; error handling
+    if(list==NULL)
+         return DLL_NULL_PTR;
+
+    dll_unrolled_node_ptr tmp=list->head, next;
+
+    /*one free per node, not per value*/
+    while(tmp!=NULL)
+    {
+         next=tmp->next_ptr;
+         free(tmp);
+         tmp=next;
+    }
+
+    free(list);
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_unrolled_add_node(dll_unrolled_ptr list, uint32_t position, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Inserts data so that it ends up at 'position' in the list.
+ *
+ * Working:      The node holding position is found by walking from whichever
+ *               end is closer, skipping a whole node per step. If that node is
+ *               full it is split in two halves first; appending to a full node
+ *               at the end of the list starts a new node instead, so a list
+ *               built by appending keeps its nodes full.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_BAD_POSITION: position is larger than the size of the
+ *               list.
+ *
+ *               DLL_MALLOC_FAIL: A new node can not be allocated.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_unrolled_add_node(dll_unrolled_ptr list, uint32_t position, uint32_t data)
+{
+    //basic pointer check; error handling
+    if(list==NULL)
+         return DLL_NULL_PTR;
+
+    if(position>list->count)
+         return DLL_BAD_POSITION;
+
+    uint32_t offset, half;
+    dll_unrolled_node_ptr node=dll_unrolled_locate(list, position, &offset), next;
+
+    /*first value of the list*/
+    if(node==NULL)
+    {
+         node=dll_unrolled_new_node(list, NULL);
+         if(node==NULL)
+              return DLL_MALLOC_FAIL;
+         offset=0;
+    }
+    else if(node->fill==DLL_UNROLLED_NODE_VALUES)
+    {
+         /*appending past a full node- start a new one*/
+         if(offset==DLL_UNROLLED_NODE_VALUES)
+         {
+              node=dll_unrolled_new_node(list, node);
+              if(node==NULL)
+                   return DLL_MALLOC_FAIL;
+              offset=0;
+         }
+         /*split the full node and insert into the half that holds offset*/
+         else
+         {
+              next=dll_unrolled_new_node(list, node);
+              if(next==NULL)
+                   return DLL_MALLOC_FAIL;
+
+              half=DLL_UNROLLED_NODE_VALUES/2;
+              memcpy(next->values, node->values+half, (DLL_UNROLLED_NODE_VALUES-half)*sizeof(uint32_t));
+              next->fill=DLL_UNROLLED_NODE_VALUES-half;
+              node->fill=half;
+
+              if(offset>half)
+              {
+                   node=next;
+                   offset-=half;
+              }
+         }
+    }
+
+    /*open a gap at offset*/
+    memmove(node->values+offset+1, node->values+offset, (node->fill-offset)*sizeof(uint32_t));
+    node->values[offset]=data;
+    node->fill++;
+    list->count++;
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Name:         dll_unrolled_remove_node(dll_unrolled_ptr list, uint32_t position, uint32_t* data)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes the value at 'position' and returns it in *data.
+ *
+ * Working:      An emptied node is freed. A node that drops below a quarter
+ *               full is merged with its successor when both fit in one node,
+ *               so the list does not degrade into nearly empty nodes.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_BAD_POSITION: The list's size is not larger than the
+ *               position specified.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_unrolled_remove_node(dll_unrolled_ptr list, uint32_t position, uint32_t* data)
+{
+    //basic pointer check; error handling
+    if(list==NULL||data==NULL)
+         return DLL_NULL_PTR;
+
+    if(position>=list->count)
+         return DLL_BAD_POSITION;
+
+    uint32_t offset;
+    dll_unrolled_node_ptr node=dll_unrolled_locate(list, position, &offset), next;
+
+    *data=node->values[offset];
+
+    /*close the gap at offset*/
+    memmove(node->values+offset, node->values+offset+1, (node->fill-offset-1)*sizeof(uint32_t));
+    node->fill--;
+    list->count--;
+
+    if(node->fill==0)
+         dll_unrolled_free_node(list, node);
+    else if(node->fill<DLL_UNROLLED_NODE_VALUES/4)
+    {
+         /*pull the successor in if both fit in one node*/
+         next=node->next_ptr;
+         if(next!=NULL&&node->fill+next->fill<=DLL_UNROLLED_NODE_VALUES)
+         {
+              memcpy(node->values+node->fill, next->values, next->fill*sizeof(uint32_t));
+              node->fill+=next->fill;
+              dll_unrolled_free_node(list, next);
+         }
+    }
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_unrolled_get(dll_unrolled_ptr list, uint32_t position, uint32_t* data)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the value at 'position' in *data without removing it.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_BAD_POSITION: The list's size is not larger than the
+ *               position specified.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_unrolled_get(dll_unrolled_ptr list, uint32_t position, uint32_t* data)
+{
+    //basic pointer check; error handling
+    if(list==NULL||data==NULL)
+         return DLL_NULL_PTR;
+
+    if(position>=list->count)
+         return DLL_BAD_POSITION;
+
+    uint32_t offset;
+    dll_unrolled_node_ptr node=dll_unrolled_locate(list, position, &offset);
+
+    *data=node->values[offset];
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_unrolled_size(dll_unrolled_ptr list, uint32_t* size)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the number of values in the list in *size. The count
+ *               is kept in the handle, so this does not walk the list.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_unrolled_size(dll_unrolled_ptr list, uint32_t* size)
+{
+    //basic pointer check; error handling
+    if(list==NULL||size==NULL)
+         return DLL_NULL_PTR;
+
+    *size=list->count;
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_unrolled_search(dll_unrolled_ptr list, uint32_t data, uint32_t* position)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the position of the first value equal to data in
+ *               *position, like dll_search. The values of each node are
+ *               compared with dll_simd_find.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_DATA_MISSING: The data requested to be searched was not
+ *               found in the list.
+ *
+ *               DLL_SUCCESS: The function completes execution
+ *               successfully- the data is found.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_unrolled_search(dll_unrolled_ptr list, uint32_t data, uint32_t* position)
+{
+    //basic pointer check; error handling
+    if(list==NULL||position==NULL)
+         return DLL_NULL_PTR;
+
+    dll_unrolled_node_ptr tmp=list->head;
+    uint32_t start=0, index;
+
+    /*scan the values of each node as a plain array*/
+    while(tmp!=NULL)
+    {
+         if(dll_simd_find(tmp->values, tmp->fill, data, &index)==DLL_SUCCESS)
+         {
+              *position=start+index;
+              return DLL_SUCCESS;
+         }
+         start+=tmp->fill;
+         tmp=tmp->next_ptr;
+    }
+
+    return DLL_DATA_MISSING;
+}
+
+
+/*
+ * Function:     dll_unrolled_count(dll_unrolled_ptr list, uint32_t data, uint32_t* matches)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the number of values equal to data in *matches,
+ *               counting each node with dll_simd_count.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_unrolled_count(dll_unrolled_ptr list, uint32_t data, uint32_t* matches)
+{
+    //basic pointer check; error handling
+    if(list==NULL||matches==NULL)
+         return DLL_NULL_PTR;
+
+    dll_unrolled_node_ptr tmp;
+    uint32_t node_matches;
+
+    *matches=0;
+
+    for(tmp=list->head; tmp!=NULL; tmp=tmp->next_ptr)
+    {
+         dll_simd_count(tmp->values, tmp->fill, data, &node_matches);
+         *matches+=node_matches;
+    }
+
+    return DLL_SUCCESS;
+}
+
+
+/*
+ * Function:     dll_unrolled_find_all(dll_unrolled_ptr list, uint32_t data,
+ *                                     uint32_t* positions, uint32_t max, uint32_t* matches)
+ * -----------------------------------------------------------------------------
+ * Description:  Stores the positions of the values equal to data in ascending
+ *               order in positions[], at most max of them, and returns the
+ *               total number of matches in *matches, which may be larger than
+ *               max.
+ *
+ * Usage:        positions may be NULL if max is zero.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_unrolled_find_all(dll_unrolled_ptr list, uint32_t data,
+                               uint32_t* positions, uint32_t max, uint32_t* matches)
+{
+    //basic pointer check; error handling
+    if(list==NULL||(positions==NULL&&max!=0)||matches==NULL)
+         return DLL_NULL_PTR;
+
+    dll_unrolled_node_ptr tmp;
+    uint32_t start=0, found=0, node_matches, stored, index;
+
+    for(tmp=list->head; tmp!=NULL; tmp=tmp->next_ptr)
+    {
+         /*indices of this node go straight into the free part of positions*/
+         stored=(found<max)? max-found: 0;
+         dll_simd_find_all(tmp->values, tmp->fill, data, (stored!=0)? positions+found: NULL, stored, &node_matches);
+
+         /*turn them into list positions*/
+         if(stored>node_matches)
+              stored=node_matches;
+         for(index=0; index<stored; index++)
+              positions[found+index]+=start;
+
+         found+=node_matches;
+         start+=tmp->fill;
+    }
+
+    *matches=found;
+
+    return DLL_SUCCESS;
+}
@@ -0,0 +1,235 @@
+/*
+ * Author:       Ashwath Gundepally, CU ECEE
+ *
+ * File:         dll_unrolled.h
+ *
+ * Description:  Contains the structures and function prototypes of an unrolled
+ *               doubly linked list defined in dll_unrolled.c in the same
+ *               directory. Every node holds up to DLL_UNROLLED_NODE_VALUES
+ *               values in an array, so a scan follows one pointer per two
+ *               cache lines of data instead of one pointer per value.
+ *
+ * */
+
+#ifndef _DLL_UNROLLED_H_
+#define _DLL_UNROLLED_H_
+
+#include<stdint.h>
+#include "doubly_ll.h"
+
+/*a node is exactly two 64 byte cache lines and starts on a line boundary;
+ *the values take whatever the links and the fill count leave (27 with 64 bit
+ *pointers)*/
+#define DLL_UNROLLED_NODE_ALIGN  64
+#define DLL_UNROLLED_NODE_SIZE   128
+#define DLL_UNROLLED_NODE_VALUES ((uint32_t)((DLL_UNROLLED_NODE_SIZE-2*sizeof(void*)-sizeof(uint32_t))/sizeof(uint32_t)))
+
+
+/*
+ * Structure:    dll_unrolled_node
+ * -----------------------------------------------------------------------------
+ * Description:  One node of the unrolled list. values[0..fill-1] hold the
+ *               node's part of the list in order; the rest is unused. The
+ *               links and fill come first, so a walk that only follows the
+ *               links touches one cache line per node.
+ *
+ * Usage:        Use regular structure syntax to access any of the members of
+ *               this structure. Nodes are allocated with aligned_alloc.
+ * ----------------------------------------------------------------------------
+ */
+typedef struct dll_unrolled_node *dll_unrolled_node_ptr;
+
+typedef struct dll_unrolled_node
+{
+    _Alignas(DLL_UNROLLED_NODE_ALIGN) dll_unrolled_node_ptr next_ptr;
+    dll_unrolled_node_ptr prev_ptr;
+    uint32_t fill;
+    uint32_t values[DLL_UNROLLED_NODE_VALUES];
+}dll_unrolled_node;
+
+_Static_assert(sizeof(dll_unrolled_node)==DLL_UNROLLED_NODE_SIZE, "dll_unrolled_node must be exactly DLL_UNROLLED_NODE_SIZE bytes");
+
+
+/*
+ * Structure:    dll_unrolled
+ * -----------------------------------------------------------------------------
+ * Description:  A handle for an unrolled list that tracks the first and last
+ *               node, the number of values and the number of nodes. Positions
+ *               count values, not nodes, so they mean the same as for the
+ *               dll_list functions.
+ *
+ * Usage:        Create it with dll_unrolled_init and change the list only
+ *               through the dll_unrolled_* functions so that the members stay
+ *               in sync.
+ * ----------------------------------------------------------------------------
+ */
+typedef struct dll_unrolled *dll_unrolled_ptr;
+
+typedef struct dll_unrolled
+{
+    dll_unrolled_node_ptr head;
+    dll_unrolled_node_ptr tail;
+    uint32_t count;
+    uint32_t nodes;
+}dll_unrolled;
+
+
+/*
+ * Function:     dll_unrolled_init(dll_unrolled_ptr* list)
+ * -----------------------------------------------------------------------------
+ * Description:  Allocates an empty unrolled list handle on the heap.
+ *
+ * Usage:        Pass a pointer to the dll_unrolled_ptr that should point to the
+ *               new list.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_MALLOC_FAIL: The call to malloc fails.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_unrolled_init(dll_unrolled_ptr* list);
+
+/*
+ * Function:     dll_unrolled_destroy(dll_unrolled_ptr list)
+ * -----------------------------------------------------------------------------
+ * Description:  De-allocates all the nodes of the list and the list handle.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_unrolled_destroy(dll_unrolled_ptr list);
+
+/*
+ * Function:     dll_unrolled_add_node(dll_unrolled_ptr list, uint32_t position, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Inserts data so that it ends up at 'position' in the list.
+ *
+ * Working:      The node holding position is found by walking from whichever
+ *               end is closer, skipping a whole node per step. If that node is
+ *               full it is split in two halves first; appending to a full node
+ *               at the end of the list starts a new node instead, so a list
+ *               built by appending keeps its nodes full.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_BAD_POSITION: position is larger than the size of the
+ *               list.
+ *
+ *               DLL_MALLOC_FAIL: A new node can not be allocated.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_unrolled_add_node(dll_unrolled_ptr list, uint32_t position, uint32_t data);
+
+/*
+ * Name:         dll_unrolled_remove_node(dll_unrolled_ptr list, uint32_t position, uint32_t* data)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes the value at 'position' and returns it in *data.
+ *
+ * Working:      An emptied node is freed. A node that drops below a quarter
+ *               full is merged with its successor when both fit in one node,
+ *               so the list does not degrade into nearly empty nodes.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_BAD_POSITION: The list's size is not larger than the
+ *               position specified.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_unrolled_remove_node(dll_unrolled_ptr list, uint32_t position, uint32_t* data);
+
+/*
+ * Function:     dll_unrolled_get(dll_unrolled_ptr list, uint32_t position, uint32_t* data)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the value at 'position' in *data without removing it.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_BAD_POSITION: The list's size is not larger than the
+ *               position specified.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_unrolled_get(dll_unrolled_ptr list, uint32_t position, uint32_t* data);
+
+/*
+ * Function:     dll_unrolled_size(dll_unrolled_ptr list, uint32_t* size)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the number of values in the list in *size. The count
+ *               is kept in the handle, so this does not walk the list.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_unrolled_size(dll_unrolled_ptr list, uint32_t* size);
+
+/*
+ * Function:     dll_unrolled_search(dll_unrolled_ptr list, uint32_t data, uint32_t* position)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the position of the first value equal to data in
+ *               *position, like dll_search. The values of each node are
+ *               compared with dll_simd_find.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_DATA_MISSING: The data requested to be searched was not
+ *               found in the list.
+ *
+ *               DLL_SUCCESS: The function completes execution
+ *               successfully- the data is found.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_unrolled_search(dll_unrolled_ptr list, uint32_t data, uint32_t* position);
+
+/*
+ * Function:     dll_unrolled_count(dll_unrolled_ptr list, uint32_t data, uint32_t* matches)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the number of values equal to data in *matches,
+ *               counting each node with dll_simd_count.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_unrolled_count(dll_unrolled_ptr list, uint32_t data, uint32_t* matches);
+
+/*
+ * Function:     dll_unrolled_find_all(dll_unrolled_ptr list, uint32_t data,
+ *                                     uint32_t* positions, uint32_t max, uint32_t* matches)
+ * -----------------------------------------------------------------------------
+ * Description:  Stores the positions of the values equal to data in ascending
+ *               order in positions[], at most max of them, and returns the
+ *               total number of matches in *matches, which may be larger than
+ *               max.
+ *
+ * Usage:        positions may be NULL if max is zero.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_unrolled_find_all(dll_unrolled_ptr list, uint32_t data,
+                               uint32_t* positions, uint32_t max, uint32_t* matches);
+
+#endif
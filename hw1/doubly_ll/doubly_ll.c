@@ -10,10 +10,225 @@
  * */
 
 #include "doubly_ll.h"
+#include "dll_pool.h"
+#include "dll_hash.h"
 #include<stdint.h>
 #include<stdlib.h>
 
 
+/*
+ * Function:     dll_list_alloc_node(dll_list_ptr list)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns memory for one node of the list or NULL.
+ * ----------------------------------------------------------------------------
+ */
+static dll_node_ptr dll_list_alloc_node(dll_list_ptr list)
+{
+    dll_node_ptr node;
+
+    if(list->pool==NULL)
+         return (dll_node_ptr)malloc(sizeof(dll_node));
+
+    if(dll_pool_alloc(list->pool, &node)!=DLL_SUCCESS)
+         return NULL;
+
+    return node;
+}
+
+/*
+ * Function:     dll_list_free_node(dll_list_ptr list, dll_node_ptr node)
+ * -----------------------------------------------------------------------------
+ * Description:  Gives back the memory of a node allocated by
+ *               dll_list_alloc_node.
+ * ----------------------------------------------------------------------------
+ */
+static void dll_list_free_node(dll_list_ptr list, dll_node_ptr node)
+{
+    if(list->pool==NULL)
+         free(node);
+    else
+         dll_pool_free(list->pool, node);
+}
+
+/*
+ * Function:     dll_list_node_at(dll_list_ptr list, uint32_t position)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the node at position, walking from whichever end of the
+ *               list is closer. position must not be larger than the count;
+ *               position==count returns NULL (one past the tail).
+ * ----------------------------------------------------------------------------
+ */
+static dll_node_ptr dll_list_node_at(dll_list_ptr list, uint32_t position)
+{
+    dll_node_ptr tmp;
+    uint32_t index;
+
+    if(position==list->count)
+         return NULL;
+
+    if(position<=list->count/2)
+    {
+         tmp=list->head;
+         for(index=0; index<position; index++)
+              tmp=tmp->next_ptr;
+    }
+    else
+    {
+         tmp=list->tail;
+         for(index=list->count-1; index>position; index--)
+              tmp=tmp->prev_ptr;
+    }
+
+    return tmp;
+}
+
+/*
+ * Function:     dll_list_insert_before(dll_list_ptr list, dll_node_ptr next, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Allocates a node holding data and links it in before next; a
+ *               NULL next appends it after the tail. Keeps head, tail, count
+ *               and the index up to date.
+ * ----------------------------------------------------------------------------
+ */
+static dll_code dll_list_insert_before(dll_list_ptr list, dll_node_ptr next, uint32_t data)
+{
+    dll_node_ptr new_node=dll_list_alloc_node(list);
+
+    /*malloc check*/
+    if(new_node==NULL)
+         return DLL_MALLOC_FAIL;
+
+    new_node->data=data;
+
+    /*the index may have to grow- do it before the node is linked in*/
+    if(list->index!=NULL&&dll_hash_reserve(list->index, 1)!=DLL_SUCCESS)
+    {
+         dll_list_free_node(list, new_node);
+         return DLL_MALLOC_FAIL;
+    }
+
+    new_node->next_ptr=next;
+    new_node->prev_ptr=(next!=NULL)? next->prev_ptr: list->tail;
+
+    /*link the nodes surrounding the new node to the new node*/
+    if(new_node->prev_ptr!=NULL)
+         new_node->prev_ptr->next_ptr=new_node;
+    else
+         list->head=new_node;
+
+    if(next!=NULL)
+         next->prev_ptr=new_node;
+    else
+         list->tail=new_node;
+
+    list->count++;
+
+    /*cannot fail after the reserve; needs the node linked to place it
+     *among its duplicates*/
+    if(list->index!=NULL)
+         dll_hash_insert(list->index, new_node);
+
+    return DLL_SUCCESS;
+}
+
+/*
+ * Function:     dll_list_unlink(dll_list_ptr list, dll_node_ptr node)
+ * -----------------------------------------------------------------------------
+ * Description:  Unlinks node from the list and frees it. Keeps head, tail,
+ *               count and the index up to date.
+ * ----------------------------------------------------------------------------
+ */
+static void dll_list_unlink(dll_list_ptr list, dll_node_ptr node)
+{
+    if(list->index!=NULL)
+         dll_hash_remove(list->index, node);
+
+    if(node->prev_ptr!=NULL)
+         node->prev_ptr->next_ptr=node->next_ptr;
+    else
+         list->head=node->next_ptr;
+
+    if(node->next_ptr!=NULL)
+         node->next_ptr->prev_ptr=node->prev_ptr;
+    else
+         list->tail=node->prev_ptr;
+
+    list->count--;
+
+    dll_list_free_node(list, node);
+}
+
+
+/*
+ * Function:     dll_list_cut(dll_list_ptr list, dll_node_ptr first, dll_node_ptr last, uint32_t count)
+ * -----------------------------------------------------------------------------
+ * Description:  Unlinks the count nodes first to last from list without
+ *               freeing them or touching the index. The chain keeps its own
+ *               links, with the outer ones left dangling.
+ * ----------------------------------------------------------------------------
+ */
+static void dll_list_cut(dll_list_ptr list, dll_node_ptr first, dll_node_ptr last, uint32_t count)
+{
+    if(first->prev_ptr!=NULL)
+         first->prev_ptr->next_ptr=last->next_ptr;
+    else
+         list->head=last->next_ptr;
+
+    if(last->next_ptr!=NULL)
+         last->next_ptr->prev_ptr=first->prev_ptr;
+    else
+         list->tail=first->prev_ptr;
+
+    list->count-=count;
+}
+
+/*
+ * Function:     dll_list_paste(dll_list_ptr list, dll_node_ptr next, dll_node_ptr first,
+ *                              dll_node_ptr last, uint32_t count)
+ * -----------------------------------------------------------------------------
+ * Description:  Links the chain of count nodes first to last into list before
+ *               next; a NULL next appends it. Does not touch the index.
+ * ----------------------------------------------------------------------------
+ */
+static void dll_list_paste(dll_list_ptr list, dll_node_ptr next, dll_node_ptr first,
+                           dll_node_ptr last, uint32_t count)
+{
+    first->prev_ptr=(next!=NULL)? next->prev_ptr: list->tail;
+    last->next_ptr=next;
+
+    if(first->prev_ptr!=NULL)
+         first->prev_ptr->next_ptr=first;
+    else
+         list->head=first;
+
+    if(next!=NULL)
+         next->prev_ptr=last;
+    else
+         list->tail=last;
+
+    list->count+=count;
+}
+
+/*
+ * Function:     dll_list_unindex(dll_list_ptr list, dll_node_ptr first, dll_node_ptr last)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes the chain first to last, still linked into list, from
+ *               the index of list (if any), before the chain is cut out.
+ * ----------------------------------------------------------------------------
+ */
+static void dll_list_unindex(dll_list_ptr list, dll_node_ptr first, dll_node_ptr last)
+{
+    if(list->index==NULL)
+         return;
+
+    /*list is emptied- drop its entries in one go instead of one by one*/
+    if(first==list->head&&last==list->tail)
+         dll_hash_clear(list->index);
+    else
+         dll_hash_remove_range(list->index, first, last);
+}
+
+
 /*								                
  * Function:     dll_add_node(dll_node_ptr* head, uint32_t data, uint32_t position)
  * -----------------------------------------------------------------------------
@@ -311,3 +526,859 @@ dll_code dll_search(dll_node_ptr head, uint32_t data, uint32_t* position)
     }
 }
 
+
+/*								                
+ * Function:     dll_list_init(dll_list_ptr* list)
+ * -----------------------------------------------------------------------------
+ * Description:  Allocates an empty list handle on the heap. The handle tracks
+ *               the head, the tail and the number of nodes of the list.
+ *           
+ * Usage:        Pass a pointer to the dll_list_ptr that should point to the new
+ *               list.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *               
+ *               DLL_MALLOC_FAIL: The call to malloc fails.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_init(dll_list_ptr* list)
+{
+    //basic pointer check; error handling	
+    if(list==NULL)
+         return DLL_NULL_PTR;
+
+    *list=(dll_list_ptr)malloc(sizeof(dll_list));
+    if(*list==NULL)
+         return DLL_MALLOC_FAIL;
+
+    /*an empty list has no head or tail*/
+    (*list)->head=NULL;
+    (*list)->tail=NULL;
+    (*list)->count=0;
+    (*list)->pool=NULL;
+    (*list)->index=NULL;
+
+    return DLL_SUCCESS;
+}
+
+/*								                
+ * Function:     dll_list_init_pool(dll_list_ptr* list, dll_pool_ptr pool)
+ * -----------------------------------------------------------------------------
+ * Description:  Same as dll_list_init, but the nodes of the list are taken from
+ *               and given back to pool. Destroying such a list gives all its
+ *               nodes back to the pool in O(1).
+ *           
+ * Usage:        The list holds a reference to pool, so the pool may be
+ *               destroyed before the list. A pool is not thread safe, so all
+ *               the lists sharing a pool must be used from one thread.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *               
+ *               DLL_MALLOC_FAIL: The call to malloc fails.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_init_pool(dll_list_ptr* list, dll_pool_ptr pool)
+{
+    //basic pointer check; error handling	
+    if(list==NULL||pool==NULL)
+         return DLL_NULL_PTR;
+
+    dll_code rc=dll_list_init(list);
+    if(rc!=DLL_SUCCESS)
+         return rc;
+
+    (*list)->pool=pool;
+    dll_pool_retain(pool);
+
+    return DLL_SUCCESS;
+}
+
+
+/*								                
+ * Function:     dll_list_destroy(dll_list_ptr list)
+ * -----------------------------------------------------------------------------
+ * Description:  De-allocates all the nodes of the list and the list handle.
+ *               A pooled list gives its nodes back and drops its reference
+ *               to the pool, which frees the pool if it was the last one.
+ *               
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.   
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_destroy(dll_list_ptr list)
+{
+    //basic pointer check; error handling	
+    if(list==NULL)
+         return DLL_NULL_PTR;
+
+    dll_node_ptr tmp=list->head, next;
+
+    dll_hash_destroy(list->index);
+
+    /*the nodes are still chained- hand them to the pool in one go*/
+    if(list->pool!=NULL)
+    {
+         if(tmp!=NULL)
+              dll_pool_free_chain(list->pool, list->head, list->tail, list->count);
+         dll_pool_destroy(list->pool);
+         free(list);
+         return DLL_SUCCESS;
+    }
+
+    /*free the memory of all the nodes on the heap*/
+    while(tmp!=NULL)
+    {
+         next=tmp->next_ptr;
+         dll_list_free_node(list, tmp);
+         tmp=next;
+    }
+
+    free(list);
+
+    return DLL_SUCCESS;
+}
+
+
+/*								                
+ * Function:     dll_list_size(dll_list_ptr list, uint32_t* size)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the number of nodes in the list in *size. The count is
+ *               kept in the handle, so this does not walk the list.
+ *                
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully.   
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_size(dll_list_ptr list, uint32_t* size)
+{
+    //basic pointer check; error handling	
+    if(list==NULL||size==NULL)
+         return DLL_NULL_PTR;
+
+    *size=list->count;
+
+    return DLL_SUCCESS;
+}
+
+
+/*								                
+ * Function:     dll_list_push_front(dll_list_ptr list, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Adds a node holding data before the head of the list.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *               
+ *               DLL_MALLOC_FAIL: The node can not be allocated.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_push_front(dll_list_ptr list, uint32_t data)
+{
+    //basic pointer check; error handling	
+    if(list==NULL)
+         return DLL_NULL_PTR;
+
+    return dll_list_insert_before(list, list->head, data);
+}
+
+
+/*								                
+ * Function:     dll_list_push_back(dll_list_ptr list, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Adds a node holding data after the tail of the list.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *               
+ *               DLL_MALLOC_FAIL: The node can not be allocated.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_push_back(dll_list_ptr list, uint32_t data)
+{
+    //basic pointer check; error handling	
+    if(list==NULL)
+         return DLL_NULL_PTR;
+
+    /*inserting before NULL appends*/
+    return dll_list_insert_before(list, NULL, data);
+}
+
+
+/*								                
+ * Function:     dll_list_pop_front(dll_list_ptr list, uint32_t* data)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes the head node of the list and returns its data in 
+ *               *data.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *               
+ *               DLL_EMPTY: The list has no nodes.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_pop_front(dll_list_ptr list, uint32_t* data)
+{
+    //basic pointer check; error handling	
+    if(list==NULL||data==NULL)
+         return DLL_NULL_PTR;
+
+    if(list->head==NULL)
+         return DLL_EMPTY;
+
+    *data=list->head->data;
+    dll_list_unlink(list, list->head);
+
+    return DLL_SUCCESS;
+}
+
+
+/*								                
+ * Function:     dll_list_pop_back(dll_list_ptr list, uint32_t* data)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes the tail node of the list and returns its data in 
+ *               *data.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *               
+ *               DLL_EMPTY: The list has no nodes.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_pop_back(dll_list_ptr list, uint32_t* data)
+{
+    //basic pointer check; error handling	
+    if(list==NULL||data==NULL)
+         return DLL_NULL_PTR;
+
+    if(list->tail==NULL)
+         return DLL_EMPTY;
+
+    *data=list->tail->data;
+    dll_list_unlink(list, list->tail);
+
+    return DLL_SUCCESS;
+}
+
+
+/*								                
+ * Function:     dll_list_add_node(dll_list_ptr list, uint32_t position, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Adds a node holding data so that it ends up at 'position' in
+ *               the list, like dll_add_node.
+ *              
+ * Working:      Positions 0 and size are handled through the head and tail 
+ *               pointers without a walk. Any other position is reached by 
+ *               walking from the head or from the tail, whichever is closer.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_BAD_POSITION: position is larger than the size of the
+ *               list.
+ *               
+ *               DLL_MALLOC_FAIL: The node can not be allocated.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_add_node(dll_list_ptr list, uint32_t position, uint32_t data)
+{
+    //basic pointer check; error handling	
+    if(list==NULL)
+         return DLL_NULL_PTR;
+
+    if(position>list->count)
+         return DLL_BAD_POSITION;
+
+    /*the new node goes before the node currently at position; NULL appends*/
+    return dll_list_insert_before(list, dll_list_node_at(list, position), data);
+}
+
+
+/*								                
+ * Name:         dll_list_remove_node(dll_list_ptr list, uint32_t position, uint32_t* data)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes the node at 'position' from the list and returns its
+ *               data in *data, like dll_remove_node.
+ *               
+ * Working:      The size check is a compare against the count in the handle,
+ *               and the node is reached by walking from the head or from the
+ *               tail, whichever is closer. The head and the tail are removed
+ *               without a walk.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_BAD_POSITION: The list's size is not larger than the 
+ *               position specified.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully   
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_remove_node(dll_list_ptr list, uint32_t position, uint32_t* data)
+{
+    //basic pointer check; error handling	
+    if(list==NULL||data==NULL)
+         return DLL_NULL_PTR;
+
+    if(position>=list->count)
+         return DLL_BAD_POSITION;
+
+    dll_node_ptr node=dll_list_node_at(list, position);
+
+    *data=node->data;
+    dll_list_unlink(list, node);
+
+    return DLL_SUCCESS;
+}
+
+
+/*								                
+ * Function:     dll_list_attach_index(dll_list_ptr list)
+ * -----------------------------------------------------------------------------
+ * Description:  Builds a hash index over the data of the nodes of the list.
+ *               From then on the add and remove functions keep it up to date
+ *               and value lookups no longer scan the list. The index is freed
+ *               with the list or by dll_list_detach_index.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *               
+ *               DLL_MALLOC_FAIL: The index can not be allocated; the list is
+ *               left without one.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully; also if the
+ *               list already has an index.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_attach_index(dll_list_ptr list)
+{
+    //basic pointer check; error handling	
+    if(list==NULL)
+         return DLL_NULL_PTR;
+
+    if(list->index!=NULL)
+         return DLL_SUCCESS;
+
+    dll_node_ptr tmp;
+    dll_hash_ptr index;
+
+    /*sized for the current nodes so that building it does not rehash*/
+    if(dll_hash_init(&index, list->count)!=DLL_SUCCESS)
+         return DLL_MALLOC_FAIL;
+
+    /*in list order, so every node comes after its indexed duplicates*/
+    for(tmp=list->head; tmp!=NULL; tmp=tmp->next_ptr)
+    {
+         if(dll_hash_append(index, tmp)!=DLL_SUCCESS)
+         {
+              dll_hash_destroy(index);
+              return DLL_MALLOC_FAIL;
+         }
+    }
+
+    list->index=index;
+
+    return DLL_SUCCESS;
+}
+
+
+/*								                
+ * Function:     dll_list_detach_index(dll_list_ptr list)
+ * -----------------------------------------------------------------------------
+ * Description:  Frees the hash index of the list, if it has one.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_detach_index(dll_list_ptr list)
+{
+    //basic pointer check; error handling	
+    if(list==NULL)
+         return DLL_NULL_PTR;
+
+    dll_hash_destroy(list->index);
+    list->index=NULL;
+
+    return DLL_SUCCESS;
+}
+
+
+/*								                
+ * Function:     dll_list_find(dll_list_ptr list, uint32_t data, dll_node_ptr* node)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the first node holding data in *node, in list
+ *               order. With an index this is O(1) on average however many
+ *               nodes hold data; without one it is a scan from the head.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_DATA_MISSING: No node of the list holds data.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_find(dll_list_ptr list, uint32_t data, dll_node_ptr* node)
+{
+    //basic pointer check; error handling	
+    if(list==NULL||node==NULL)
+         return DLL_NULL_PTR;
+
+    if(list->index!=NULL)
+         return dll_hash_find(list->index, data, node);
+
+    dll_node_ptr tmp;
+
+    for(tmp=list->head; tmp!=NULL; tmp=tmp->next_ptr)
+    {
+         if(tmp->data==data)
+         {
+              *node=tmp;
+              return DLL_SUCCESS;
+         }
+    }
+
+    return DLL_DATA_MISSING;
+}
+
+
+/*								                
+ * Function:     dll_list_search(dll_list_ptr list, uint32_t data, uint32_t* position)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the position of the first node holding data in 
+ *               *position, like dll_search.
+ *
+ * Working:      A position can only be counted by walking the list, so a hit
+ *               still scans from the head up to the first match. With an 
+ *               index, data that is not in the list is reported in O(1)
+ *               without a scan.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_DATA_MISSING: No node of the list holds data.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_search(dll_list_ptr list, uint32_t data, uint32_t* position)
+{
+    //basic pointer check; error handling	
+    if(list==NULL||position==NULL)
+         return DLL_NULL_PTR;
+
+    dll_node_ptr tmp;
+    uint32_t count=0;
+
+    /*a miss is answered by the index without a walk*/
+    if(list->index!=NULL&&dll_hash_find(list->index, data, &tmp)!=DLL_SUCCESS)
+         return DLL_DATA_MISSING;
+
+    for(tmp=list->head; tmp!=NULL; tmp=tmp->next_ptr, count++)
+    {
+         if(tmp->data==data)
+         {
+              *position=count;
+              return DLL_SUCCESS;
+         }
+    }
+
+    return DLL_DATA_MISSING;
+}
+
+
+/*								                
+ * Function:     dll_list_remove_value(dll_list_ptr list, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes the first node holding data from the list, found as
+ *               by dll_list_find. With an index this is O(1) on average plus,
+ *               if other nodes hold data, a walk to the next one of them,
+ *               which the index keeps as the new first.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_DATA_MISSING: No node of the list holds data.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_remove_value(dll_list_ptr list, uint32_t data)
+{
+    //basic pointer check; error handling	
+    if(list==NULL)
+         return DLL_NULL_PTR;
+
+    dll_node_ptr node;
+
+    if(dll_list_find(list, data, &node)!=DLL_SUCCESS)
+         return DLL_DATA_MISSING;
+
+    dll_list_unlink(list, node);
+
+    return DLL_SUCCESS;
+}
+
+
+/*								                
+ * Function:     dll_list_from_array(dll_list_ptr list, const uint32_t* values, uint32_t count)
+ * -----------------------------------------------------------------------------
+ * Description:  Appends values[0..count-1] to the list in one pass. The new
+ *               nodes come from one allocation and lie next to each other in
+ *               memory: a pooled list first grows its pool by the missing
+ *               nodes as a single chunk, and an empty list without a pool
+ *               takes a reference on the calling thread's pool (see
+ *               dll_pool_thread_local), grown the same way. An index is
+ *               grown once up front as well.
+ *
+ * Usage:        All the empty lists filled on one thread share that
+ *               thread's pool, so they can be spliced and merged with each
+ *               other and with the lists created on it by
+ *               dll_list_init_pool. Like them, such a list must only be used
+ *               from that thread. A non-empty list without a pool can not
+ *               mix its malloc nodes with pool nodes, so it still allocates
+ *               the new nodes one by one.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *               
+ *               DLL_MALLOC_FAIL: The nodes or the index can not be
+ *               allocated; the list is left as it was.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_from_array(dll_list_ptr list, const uint32_t* values, uint32_t count)
+{
+    //basic pointer check; error handling	
+    if(list==NULL||(values==NULL&&count!=0))
+         return DLL_NULL_PTR;
+
+    if(count==0)
+         return DLL_SUCCESS;
+
+    dll_node_ptr first=NULL, last=NULL, node;
+    dll_pool_ptr shared_pool=NULL;
+    uint32_t index;
+
+    /*an empty list can switch to a pool without mixing allocators; the
+     *thread's pool keeps it compatible with the other lists built here*/
+    if(list->pool==NULL&&list->head==NULL)
+    {
+         if(dll_pool_thread_local(&shared_pool)!=DLL_SUCCESS)
+              return DLL_MALLOC_FAIL;
+         dll_pool_retain(shared_pool);
+         list->pool=shared_pool;
+    }
+
+    /*one chunk for all the new nodes, one resize for the index*/
+    if((list->pool!=NULL&&dll_pool_reserve(list->pool, count)!=DLL_SUCCESS)||
+       (list->index!=NULL&&dll_hash_reserve(list->index, count)!=DLL_SUCCESS))
+    {
+         if(shared_pool!=NULL)
+         {
+              list->pool=NULL;
+              dll_pool_destroy(shared_pool);
+         }
+         return DLL_MALLOC_FAIL;
+    }
+
+    /*build a detached chain, so that a failed malloc leaves the list alone*/
+    for(index=0; index<count; index++)
+    {
+         node=dll_list_alloc_node(list);
+         if(node==NULL)
+         {
+              while(first!=NULL)
+              {
+                   node=first->next_ptr;
+                   dll_list_free_node(list, first);
+                   first=node;
+              }
+              return DLL_MALLOC_FAIL;
+         }
+
+         node->data=values[index];
+         node->prev_ptr=last;
+         node->next_ptr=NULL;
+         if(last!=NULL)
+              last->next_ptr=node;
+         else
+              first=node;
+         last=node;
+    }
+
+    dll_list_paste(list, NULL, first, last, count);
+
+    /*cannot fail after the reserve*/
+    if(list->index!=NULL)
+         dll_hash_insert_range(list->index, first, last);
+
+    return DLL_SUCCESS;
+}
+
+
+/*								                
+ * Function:     dll_list_splice(dll_list_ptr list, dll_node_ptr position, dll_list_ptr other)
+ * -----------------------------------------------------------------------------
+ * Description:  Moves all the nodes of other into list, before the node 
+ *               'position' of list (NULL appends them), and leaves other
+ *               empty. The nodes are relinked, not copied, so this is O(1)
+ *               unless list has an index, which then gets one entry per
+ *               moved node.
+ * 
+ * Usage:        Both lists must take their nodes from the same place: the
+ *               same pool, or both from malloc.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A list pointer passed is a NULL.
+ *               
+ *               DLL_INCOMPATIBLE: The lists use different pools, or are the
+ *               same list.
+ *
+ *               DLL_MALLOC_FAIL: The index of list can not grow; nothing is
+ *               moved.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_splice(dll_list_ptr list, dll_node_ptr position, dll_list_ptr other)
+{
+    //basic pointer check; error handling	
+    if(list==NULL||other==NULL)
+         return DLL_NULL_PTR;
+
+    if(list==other||list->pool!=other->pool)
+         return DLL_INCOMPATIBLE;
+
+    if(other->head==NULL)
+         return DLL_SUCCESS;
+
+    return dll_list_splice_range(list, position, other, other->head, other->tail);
+}
+
+
+/*								                
+ * Function:     dll_list_splice_range(dll_list_ptr list, dll_node_ptr position, dll_list_ptr other,
+ *                                     dll_node_ptr first, dll_node_ptr last)
+ * -----------------------------------------------------------------------------
+ * Description:  Moves the nodes first to last (inclusive, in list order) of 
+ *               other into list before the node 'position' (NULL appends 
+ *               them). The relinking is O(1); counting the moved nodes is
+ *               O(k) in their number. With an index, moved nodes whose data
+ *               list holds already are placed among their duplicates by a
+ *               walk outwards from the moved nodes, once per such data.
+ * 
+ * Usage:        Same as dll_list_splice. first must not come after last.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *               
+ *               DLL_INCOMPATIBLE: The lists use different pools, or are the
+ *               same list.
+ *
+ *               DLL_MALLOC_FAIL: The index of list can not grow; nothing is
+ *               moved.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_splice_range(dll_list_ptr list, dll_node_ptr position, dll_list_ptr other,
+                               dll_node_ptr first, dll_node_ptr last)
+{
+    //basic pointer check; error handling	
+    if(list==NULL||other==NULL||first==NULL||last==NULL)
+         return DLL_NULL_PTR;
+
+    if(list==other||list->pool!=other->pool)
+         return DLL_INCOMPATIBLE;
+
+    dll_node_ptr tmp;
+    uint32_t count=1;
+
+    /*the whole list is moved- its count is already known*/
+    if(first==other->head&&last==other->tail)
+         count=other->count;
+    else
+    {
+         for(tmp=first; tmp!=last; tmp=tmp->next_ptr)
+              count++;
+    }
+
+    if(list->index!=NULL&&dll_hash_reserve(list->index, count)!=DLL_SUCCESS)
+         return DLL_MALLOC_FAIL;
+
+    dll_list_unindex(other, first, last);
+    dll_list_cut(other, first, last, count);
+    dll_list_paste(list, position, first, last, count);
+
+    /*cannot fail after the reserve*/
+    if(list->index!=NULL)
+         dll_hash_insert_range(list->index, first, last);
+
+    return DLL_SUCCESS;
+}
+
+
+/*								                
+ * Function:     dll_list_split(dll_list_ptr list, dll_node_ptr node, dll_list_ptr* rest)
+ * -----------------------------------------------------------------------------
+ * Description:  Moves node and all the nodes after it into a new list 
+ *               returned in *rest, which uses the same pool as list and gets
+ *               an index if list has one. O(k) in the number of moved nodes.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *               
+ *               DLL_MALLOC_FAIL: The new list or its index can not be
+ *               allocated; list is left as it was.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_split(dll_list_ptr list, dll_node_ptr node, dll_list_ptr* rest)
+{
+    //basic pointer check; error handling	
+    if(list==NULL||node==NULL||rest==NULL)
+         return DLL_NULL_PTR;
+
+    dll_list_ptr tail_list;
+    dll_node_ptr tmp;
+    uint32_t count=0;
+
+    if(dll_list_init(&tail_list)!=DLL_SUCCESS)
+         return DLL_MALLOC_FAIL;
+
+    tail_list->pool=list->pool;
+
+    for(tmp=node; tmp!=NULL; tmp=tmp->next_ptr)
+         count++;
+
+    /*the moved nodes take their index entries along*/
+    if(list->index!=NULL)
+    {
+         if(dll_hash_init(&tail_list->index, count)!=DLL_SUCCESS)
+         {
+              free(tail_list);
+              return DLL_MALLOC_FAIL;
+         }
+    }
+
+    tmp=list->tail;
+    dll_list_unindex(list, node, tmp);
+    dll_list_cut(list, node, tmp, count);
+    dll_list_paste(tail_list, NULL, node, tmp, count);
+
+    /*cannot fail: the index was sized for the moved nodes*/
+    if(tail_list->index!=NULL)
+         dll_hash_insert_range(tail_list->index, node, tmp);
+
+    if(tail_list->pool!=NULL)
+         dll_pool_retain(tail_list->pool);
+
+    *rest=tail_list;
+
+    return DLL_SUCCESS;
+}
+
+
+/*								                
+ * Function:     dll_list_merge(dll_list_ptr list, dll_list_ptr other)
+ * -----------------------------------------------------------------------------
+ * Description:  Merges other into list and leaves other empty. Both lists
+ *               must be sorted in ascending order of data; the result is
+ *               sorted too, and on equal data the nodes of list come first.
+ *               The nodes are relinked in a single pass over both lists.
+ * 
+ * Usage:        Same as dll_list_splice.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *               
+ *               DLL_INCOMPATIBLE: The lists use different pools, or are the
+ *               same list.
+ *
+ *               DLL_MALLOC_FAIL: The index of list can not grow; nothing is
+ *               moved.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_merge(dll_list_ptr list, dll_list_ptr other)
+{
+    //basic pointer check; error handling	
+    if(list==NULL||other==NULL)
+         return DLL_NULL_PTR;
+
+    if(list==other||list->pool!=other->pool)
+         return DLL_INCOMPATIBLE;
+
+    if(other->head==NULL)
+         return DLL_SUCCESS;
+
+    if(list->index!=NULL&&dll_hash_reserve(list->index, other->count)!=DLL_SUCCESS)
+         return DLL_MALLOC_FAIL;
+
+    dll_list_unindex(other, other->head, other->tail);
+
+    dll_node_ptr a=list->head, b=other->head, tail=NULL, next;
+
+    /*take the smaller head each time; ties go to list to keep the merge stable*/
+    while(a!=NULL||b!=NULL)
+    {
+         if(b==NULL||(a!=NULL&&a->data<=b->data))
+         {
+              next=a;
+              a=a->next_ptr;
+         }
+         else
+         {
+              next=b;
+              b=b->next_ptr;
+
+              /*every node of list with the same data is merged already,
+               *so next comes after all of its indexed duplicates*/
+              if(list->index!=NULL)
+                   dll_hash_append(list->index, next);
+         }
+
+         next->prev_ptr=tail;
+         if(tail!=NULL)
+              tail->next_ptr=next;
+         else
+              list->head=next;
+         tail=next;
+    }
+
+    tail->next_ptr=NULL;
+    list->tail=tail;
+    list->count+=other->count;
+
+    other->head=NULL;
+    other->tail=NULL;
+    other->count=0;
+
+    return DLL_SUCCESS;
+}
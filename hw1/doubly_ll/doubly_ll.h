@@ -17,7 +17,7 @@
 #include<stdint.h>
 
 /*various status codes returned by functions*/
-typedef enum {DLL_SUCCESS, DLL_NULL_PTR, DLL_MALLOC_FAIL, DLL_BAD_POSITION, DLL_DATA_MISSING} dll_code;
+typedef enum {DLL_SUCCESS, DLL_NULL_PTR, DLL_MALLOC_FAIL, DLL_BAD_POSITION, DLL_DATA_MISSING, DLL_EMPTY, DLL_BAD_DATA, DLL_INCOMPATIBLE} dll_code;
 
 
 /*								                
@@ -39,6 +39,38 @@ typedef struct dll_node
 }dll_node;
 
 
+/*								                
+ * Structure:    dll_list 
+ * -----------------------------------------------------------------------------
+ * Description:  A handle for a doubly linked list that tracks the head, the 
+ *               tail and the number of nodes, so that the size and both ends 
+ *               of the list are available without walking it.
+ *           
+ *               If pool is not NULL the nodes come from that pool (see
+ *               dll_pool.h) instead of malloc. If index is not NULL every
+ *               node is also in that hash index (see dll_hash.h), which the
+ *               dll_list_* functions keep up to date.
+ *           
+ * Usage:        Create it with dll_list_init and change the list only through
+ *               the dll_list_* functions so that the members stay in sync.
+ * ----------------------------------------------------------------------------
+ */
+typedef struct dll_list *dll_list_ptr;
+
+/*defined in dll_pool.h and dll_hash.h*/
+typedef struct dll_pool *dll_pool_ptr;
+typedef struct dll_hash *dll_hash_ptr;
+
+typedef struct dll_list
+{
+    dll_node_ptr head;
+    dll_node_ptr tail;
+    uint32_t count;
+    dll_pool_ptr pool;
+    dll_hash_ptr index;
+}dll_list;
+
+
 
 /*								                
  * Function:     dll_add_node(dll_node_ptr* head, uint32_t data, uint32_t position)
@@ -156,4 +188,397 @@ dll_code dll_size(dll_node_ptr head, uint32_t* size);
  * ----------------------------------------------------------------------------
  */
 dll_code dll_search(dll_node_ptr head, uint32_t data, uint32_t* position);
+
+
+/*								                
+ * Function:     dll_list_init(dll_list_ptr* list)
+ * -----------------------------------------------------------------------------
+ * Description:  Allocates an empty list handle on the heap. The handle tracks
+ *               the head, the tail and the number of nodes of the list.
+ *           
+ * Usage:        Pass a pointer to the dll_list_ptr that should point to the new
+ *               list.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *               
+ *               DLL_MALLOC_FAIL: The call to malloc fails.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_init(dll_list_ptr* list);
+
+/*								                
+ * Function:     dll_list_init_pool(dll_list_ptr* list, dll_pool_ptr pool)
+ * -----------------------------------------------------------------------------
+ * Description:  Same as dll_list_init, but the nodes of the list are taken from
+ *               and given back to pool. Destroying such a list gives all its
+ *               nodes back to the pool in O(1).
+ *           
+ * Usage:        The list holds a reference to pool, so the pool may be
+ *               destroyed before the list. A pool is not thread safe, so all
+ *               the lists sharing a pool must be used from one thread.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *               
+ *               DLL_MALLOC_FAIL: The call to malloc fails.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_init_pool(dll_list_ptr* list, dll_pool_ptr pool);
+
+/*								                
+ * Function:     dll_list_destroy(dll_list_ptr list)
+ * -----------------------------------------------------------------------------
+ * Description:  De-allocates all the nodes of the list and the list handle.
+ *               A pooled list gives its nodes back and drops its reference
+ *               to the pool, which frees the pool if it was the last one.
+ *               
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution completely.   
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_destroy(dll_list_ptr list);
+
+/*								                
+ * Function:     dll_list_size(dll_list_ptr list, uint32_t* size)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the number of nodes in the list in *size. The count is
+ *               kept in the handle, so this does not walk the list.
+ *                
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully.   
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_size(dll_list_ptr list, uint32_t* size);
+
+/*								                
+ * Function:     dll_list_push_front(dll_list_ptr list, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Adds a node holding data before the head of the list.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *               
+ *               DLL_MALLOC_FAIL: The node can not be allocated.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_push_front(dll_list_ptr list, uint32_t data);
+
+/*								                
+ * Function:     dll_list_push_back(dll_list_ptr list, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Adds a node holding data after the tail of the list.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *               
+ *               DLL_MALLOC_FAIL: The node can not be allocated.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_push_back(dll_list_ptr list, uint32_t data);
+
+/*								                
+ * Function:     dll_list_pop_front(dll_list_ptr list, uint32_t* data)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes the head node of the list and returns its data in 
+ *               *data.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *               
+ *               DLL_EMPTY: The list has no nodes.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_pop_front(dll_list_ptr list, uint32_t* data);
+
+/*								                
+ * Function:     dll_list_pop_back(dll_list_ptr list, uint32_t* data)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes the tail node of the list and returns its data in 
+ *               *data.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *               
+ *               DLL_EMPTY: The list has no nodes.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_pop_back(dll_list_ptr list, uint32_t* data);
+
+/*								                
+ * Function:     dll_list_add_node(dll_list_ptr list, uint32_t position, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Adds a node holding data so that it ends up at 'position' in
+ *               the list, like dll_add_node.
+ *              
+ * Working:      Positions 0 and size are handled through the head and tail 
+ *               pointers without a walk. Any other position is reached by 
+ *               walking from the head or from the tail, whichever is closer.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_BAD_POSITION: position is larger than the size of the
+ *               list.
+ *               
+ *               DLL_MALLOC_FAIL: The node can not be allocated.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_add_node(dll_list_ptr list, uint32_t position, uint32_t data);
+
+/*								                
+ * Name:         dll_list_remove_node(dll_list_ptr list, uint32_t position, uint32_t* data)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes the node at 'position' from the list and returns its
+ *               data in *data, like dll_remove_node.
+ *               
+ * Working:      The size check is a compare against the count in the handle,
+ *               and the node is reached by walking from the head or from the
+ *               tail, whichever is closer. The head and the tail are removed
+ *               without a walk.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_BAD_POSITION: The list's size is not larger than the 
+ *               position specified.
+ *
+ *               DLL_SUCCESS: The function completes execution successfully   
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_remove_node(dll_list_ptr list, uint32_t position, uint32_t* data);
+
+/*								                
+ * Function:     dll_list_attach_index(dll_list_ptr list)
+ * -----------------------------------------------------------------------------
+ * Description:  Builds a hash index over the data of the nodes of the list.
+ *               From then on the add and remove functions keep it up to date
+ *               and value lookups no longer scan the list. The index is freed
+ *               with the list or by dll_list_detach_index.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *               
+ *               DLL_MALLOC_FAIL: The index can not be allocated; the list is
+ *               left without one.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully; also if the
+ *               list already has an index.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_attach_index(dll_list_ptr list);
+
+/*								                
+ * Function:     dll_list_detach_index(dll_list_ptr list)
+ * -----------------------------------------------------------------------------
+ * Description:  Frees the hash index of the list, if it has one.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_detach_index(dll_list_ptr list);
+
+/*								                
+ * Function:     dll_list_find(dll_list_ptr list, uint32_t data, dll_node_ptr* node)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the first node holding data in *node, in list
+ *               order. With an index this is O(1) on average however many
+ *               nodes hold data; without one it is a scan from the head.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_DATA_MISSING: No node of the list holds data.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_find(dll_list_ptr list, uint32_t data, dll_node_ptr* node);
+
+/*								                
+ * Function:     dll_list_search(dll_list_ptr list, uint32_t data, uint32_t* position)
+ * -----------------------------------------------------------------------------
+ * Description:  Returns the position of the first node holding data in 
+ *               *position, like dll_search.
+ *
+ * Working:      A position can only be counted by walking the list, so a hit
+ *               still scans from the head up to the first match. With an 
+ *               index, data that is not in the list is reported in O(1)
+ *               without a scan.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *
+ *               DLL_DATA_MISSING: No node of the list holds data.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_search(dll_list_ptr list, uint32_t data, uint32_t* position);
+
+/*								                
+ * Function:     dll_list_remove_value(dll_list_ptr list, uint32_t data)
+ * -----------------------------------------------------------------------------
+ * Description:  Removes the first node holding data from the list, found as
+ *               by dll_list_find. With an index this is O(1) on average plus,
+ *               if other nodes hold data, a walk to the next one of them,
+ *               which the index keeps as the new first.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: The pointer passed is a NULL.
+ *
+ *               DLL_DATA_MISSING: No node of the list holds data.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_remove_value(dll_list_ptr list, uint32_t data);
+
+/*								                
+ * Function:     dll_list_from_array(dll_list_ptr list, const uint32_t* values, uint32_t count)
+ * -----------------------------------------------------------------------------
+ * Description:  Appends values[0..count-1] to the list in one pass. The new
+ *               nodes come from one allocation and lie next to each other in
+ *               memory: a pooled list first grows its pool by the missing
+ *               nodes as a single chunk, and an empty list without a pool
+ *               takes a reference on the calling thread's pool (see
+ *               dll_pool_thread_local), grown the same way. An index is
+ *               grown once up front as well.
+ *
+ * Usage:        All the empty lists filled on one thread share that
+ *               thread's pool, so they can be spliced and merged with each
+ *               other and with the lists created on it by
+ *               dll_list_init_pool. Like them, such a list must only be used
+ *               from that thread. A non-empty list without a pool can not
+ *               mix its malloc nodes with pool nodes, so it still allocates
+ *               the new nodes one by one.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *               
+ *               DLL_MALLOC_FAIL: The nodes or the index can not be
+ *               allocated; the list is left as it was.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_from_array(dll_list_ptr list, const uint32_t* values, uint32_t count);
+
+/*								                
+ * Function:     dll_list_splice(dll_list_ptr list, dll_node_ptr position, dll_list_ptr other)
+ * -----------------------------------------------------------------------------
+ * Description:  Moves all the nodes of other into list, before the node 
+ *               'position' of list (NULL appends them), and leaves other
+ *               empty. The nodes are relinked, not copied, so this is O(1)
+ *               unless list has an index, which then gets one entry per
+ *               moved node.
+ * 
+ * Usage:        Both lists must take their nodes from the same place: the
+ *               same pool, or both from malloc.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A list pointer passed is a NULL.
+ *               
+ *               DLL_INCOMPATIBLE: The lists use different pools, or are the
+ *               same list.
+ *
+ *               DLL_MALLOC_FAIL: The index of list can not grow; nothing is
+ *               moved.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_splice(dll_list_ptr list, dll_node_ptr position, dll_list_ptr other);
+
+/*								                
+ * Function:     dll_list_splice_range(dll_list_ptr list, dll_node_ptr position, dll_list_ptr other,
+ *                                     dll_node_ptr first, dll_node_ptr last)
+ * -----------------------------------------------------------------------------
+ * Description:  Moves the nodes first to last (inclusive, in list order) of 
+ *               other into list before the node 'position' (NULL appends 
+ *               them). The relinking is O(1); counting the moved nodes is
+ *               O(k) in their number. With an index, moved nodes whose data
+ *               list holds already are placed among their duplicates by a
+ *               walk outwards from the moved nodes, once per such data.
+ * 
+ * Usage:        Same as dll_list_splice. first must not come after last.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *               
+ *               DLL_INCOMPATIBLE: The lists use different pools, or are the
+ *               same list.
+ *
+ *               DLL_MALLOC_FAIL: The index of list can not grow; nothing is
+ *               moved.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_splice_range(dll_list_ptr list, dll_node_ptr position, dll_list_ptr other,
+                               dll_node_ptr first, dll_node_ptr last);
+
+/*								                
+ * Function:     dll_list_split(dll_list_ptr list, dll_node_ptr node, dll_list_ptr* rest)
+ * -----------------------------------------------------------------------------
+ * Description:  Moves node and all the nodes after it into a new list 
+ *               returned in *rest, which uses the same pool as list and gets
+ *               an index if list has one. O(k) in the number of moved nodes.
+ * 
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *               
+ *               DLL_MALLOC_FAIL: The new list or its index can not be
+ *               allocated; list is left as it was.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_split(dll_list_ptr list, dll_node_ptr node, dll_list_ptr* rest);
+
+/*								                
+ * Function:     dll_list_merge(dll_list_ptr list, dll_list_ptr other)
+ * -----------------------------------------------------------------------------
+ * Description:  Merges other into list and leaves other empty. Both lists
+ *               must be sorted in ascending order of data; the result is
+ *               sorted too, and on equal data the nodes of list come first.
+ *               The nodes are relinked in a single pass over both lists.
+ * 
+ * Usage:        Same as dll_list_splice.
+ *
+ * Returns:      Error codes:
+ *               DLL_NULL_PTR: A pointer passed is a NULL.
+ *               
+ *               DLL_INCOMPATIBLE: The lists use different pools, or are the
+ *               same list.
+ *
+ *               DLL_MALLOC_FAIL: The index of list can not grow; nothing is
+ *               moved.
+ *
+ *               DLL_SUCCESS: The funcion returns successfully.
+ * ----------------------------------------------------------------------------
+ */
+dll_code dll_list_merge(dll_list_ptr list, dll_list_ptr other);
+
 #endif